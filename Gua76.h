@@ -3,6 +3,12 @@
 
 #define GUA76_URI "http://your-plugin.com/plugins/gua76" // URI univoco per il tuo plugin
 
+// Varianti con un numero di canali diverso (stesso motore, stessi controlli)
+#define GUA76_MONO_URI "http://your-plugin.com/plugins/gua76-mono"
+#define GUA76_51_URI   "http://your-plugin.com/plugins/gua76-51"
+#define GUA76_71_URI   "http://your-plugin.com/plugins/gua76-71"
+#define GUA76_MAX_CHANNELS 8
+
 typedef enum {
     GUA76_AUDIO_IN_L    = 0,
     GUA76_AUDIO_IN_R    = 1,
@@ -24,7 +30,7 @@ typedef enum {
     GUA76_DRIVE_SATURATION = 13, // Nuovo controllo per saturazione/drive aggiuntivo
 
     // Controlli aggiuntivi (moderni)
-    GUA76_OVERSAMPLING  = 14, // Oversampling On/Off
+    GUA76_OVERSAMPLING_FACTOR = 14, // Fattore di oversampling (0=1x, 1=2x, 2=4x, 3=8x, 4=16x)
     GUA76_SIDECHAIN_HPF_ON  = 15, // Sidechain HPF On/Off
     GUA76_SIDECHAIN_HPF_FREQ= 16, // Sidechain HPF Frequenza
     GUA77_SIDECHAIN_HPF_Q   = 17, // Nuovo: Q per i filtri sidechain HPF/LPF
@@ -42,8 +48,50 @@ typedef enum {
     GUA76_PEAK_IN_L     = 25, // Valore di picco Input Left (dB)
     GUA76_PEAK_IN_R     = 26, // Valore di picco Input Right (dB)
     GUA76_PEAK_OUT_L    = 27, // Valore di picco Output Left (dB)
-    GUA76_PEAK_OUT_R    = 28  // Valore di picco Output Right (dB)
+    GUA76_PEAK_OUT_R    = 28, // Valore di picco Output Right (dB)
+
+    GUA76_KNEE          = 29, // Larghezza del soft knee in dB (0 = knee duro, il default)
+    GUA76_DETECTOR_LINK = 30, // Link del detector tra i canali (0=indipendente, 1=massimo, 2=somma)
+    GUA76_LOOKAHEAD     = 31, // Lookahead in ms (0-10, 0 = spento)
+    GUA76_LATENCY       = 32, // Output: latenza in campioni (lv2:latency)
+    GUA76_TRUE_PEAK_OUT_L = 33, // Picco inter-campione Output Left (dBTP, dai dati sovracampionati)
+    GUA76_TRUE_PEAK_OUT_R = 34, // Picco inter-campione Output Right (dBTP)
+    GUA76_NOTIFY        = 35, // Output atom:Sequence: telemetria per la GUI (opzionale)
+    GUA76_SATURATION_MODE = 36, // Saturazione: 0 = curva semplice, 1 = ADAA 1° ordine, 2 = ADAA 2° ordine
+    GUA76_DETECTOR_RATE = 37,   // Frequenza del sidechain/detector: 0 = interna, 1..3 = 1/2..1/8, 4 = la più bassa (2x host)
+    GUA76_CONTROL_EVENTS = 38   // Input atom:Sequence: eventi dei parametri con timestamp (opzionale)
 
 } Gua76PortIndex;
 
+// Gli indici sopra sono quelli della variante stereo. Con N canali: ingressi audio 0..N-1,
+// uscite N..2N-1, sidechain 2N..3N-1, poi gli stessi controlli nello stesso ordine.
+#define GUA76_CONTROL_PORT_OFFSET(n) (3 * ((n) - 2)) // Da sommare all'indice stereo di un controllo
+#define GUA76_NUM_STEREO_PORTS (GUA76_CONTROL_EVENTS + 1)
+#define GUA76_NUM_PORTS(n) (GUA76_NUM_STEREO_PORTS + GUA76_CONTROL_PORT_OFFSET(n))
+
+// Telemetria sulla porta notify: un evento per chunk, un atom:Object di tipo GUA76_TELEMETRY_URI con
+// la lunghezza nominale dei frame (atom:Int, campioni) e i frame (atom:Vector di atom:Float,
+// GUA76_TELEMETRY_FIELDS valori per frame, in dB, massimo sui canali).
+#define GUA76_TELEMETRY_URI              GUA76_URI "#Telemetry"
+#define GUA76_TELEMETRY_FRAME_LENGTH_URI GUA76_URI "#telemetryFrameLength"
+#define GUA76_TELEMETRY_FRAMES_URI       GUA76_URI "#telemetryFrames"
+
+// Eventi dei parametri sulla porta control: patch:Set con patch:property = GUA76_PARAMETER_URI(simbolo)
+// di un controllo di ingresso (es. GUA76_PARAMETER_URI("ratio")) e patch:value numerico (atom:Float,
+// Double, Int, Long o Bool), con lo stesso significato della porta e limitato al suo intervallo
+// (lv2:minimum/lv2:maximum); i NaN vengono ignorati. Il valore vale dal frame dell'evento:
+// il blocco viene elaborato a tratti tra un evento e l'altro. Un controllo cambiato dall'host sulla
+// sua porta torna a valere dal blocco successivo.
+#define GUA76_PARAMETER_URI(symbol) GUA76_URI "#" symbol
+
+typedef enum {
+    GUA76_TELEMETRY_GR_MIN   = 0, // Gain reduction più profonda nel frame (dB, negativa)
+    GUA76_TELEMETRY_GR_MAX   = 1, // Gain reduction più leggera nel frame (dB)
+    GUA76_TELEMETRY_PEAK_IN  = 2, // Picco di ingresso (dB)
+    GUA76_TELEMETRY_PEAK_OUT = 3, // Picco di uscita (dB)
+    GUA76_TELEMETRY_RMS_IN   = 4, // RMS di ingresso (dB)
+    GUA76_TELEMETRY_RMS_OUT  = 5, // RMS di uscita (dB)
+    GUA76_TELEMETRY_FIELDS
+} Gua76TelemetryField;
+
 #endif // GUA76_H
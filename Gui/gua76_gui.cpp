@@ -4,14 +4,22 @@
 #include <lv2/atom/forge.h>
 #include <lv2/atom/util.h>
 
-// Include GLFW
+// Indici delle porte e telemetria: gli stessi del plugin
+#include "gua76.h"
+
+// Include GLFW (con l'accesso alla finestra X11 nativa, per il widget LV2)
 #include <GLFW/glfw3.h>
+#ifdef __linux__
+#define GLFW_EXPOSE_NATIVE_X11
+#include <GLFW/glfw3native.h>
+#endif
 
 // Include GLAD
 #include "glad/glad.h"
 
 // Include Dear ImGui
 #include "imgui/imgui.h"
+#include "imgui/imgui_internal.h" // ImClamp
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
 
@@ -19,58 +27,89 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+
+// URI della GUI (deve corrispondere a gua76.ttl); la GUI è quella della variante stereo
+#define GUA76_GUI_URI GUA76_URI ".lv2/gui"
+
+#define GUA76_METER_FLOOR_DB -60.0f // Valore iniziale dei meter di picco (sotto la scala)
+
+// Storia della GR: ring buffer di frame di telemetria (~2.7 s a 48 kHz con frame da 256 campioni)
+#define GR_HISTORY_LENGTH 512
 
-// Definizione URI del plugin e della GUI (Devono corrispondere al .ttl)
-#define GUA76_GUI_URI    "http://moddevices.com/plugins/mod-devel/gua76_ui"
-#define GUA76_PLUGIN_URI "http://moddevices.com/plugins/mod-devel/gua76"
-
-// Enum degli indici delle porte (devono corrispondere a gua76.ttl)
-typedef enum {
-    GUA76_INPUT_GAIN = 0,
-    GUA76_OUTPUT_GAIN = 1,
-    GUA76_INPUT_PAD_10DB = 2,
-    GUA76_BYPASS = 3,
-    GUA76_NORMALIZE_OUTPUT = 4,
-    GUA76_MS_MODE_ACTIVE = 5,
-    GUA76_EXTERNAL_SC_ACTIVE = 6,
-    GUA76_ATTACK = 7,
-    GUA76_RELEASE = 8,
-    GUA76_RATIO = 9,
-    GUA76_INPUT_CLIP_DRIVE = 10,
-    GUA76_OUTPUT_CLIP_DRIVE = 11,
-    GUA76_SC_HPF_FREQ = 12,
-    GUA76_SC_LPF_FREQ = 13,
-    GUA76_SC_HPF_Q = 14,
-    GUA76_SC_LPF_Q = 15,
-    GUA76_METER_DISPLAY_MODE = 16, // Input: 0=Input, 1=Output, 2=Input-Output
-    GUA76_GAIN_REDUCTION_METER = 17, // Output for GUI
-    GUA76_INPUT_RMS = 18, // Output for GUI
-    GUA76_OUTPUT_RMS = 19, // Output for GUI
-    // Le porte audio non sono gestite direttamente dalla GUI, quindi non le elenchiamo qui.
-} GUA76_PortIndex;
+// Ridisegno su richiesta: un frame viene disegnato solo se qualcosa è cambiato. Input dell'utente e
+// controlli dall'host: subito (per GUI_INPUT_FRAMES frame, ImGui aggiorna hover/attivo un frame dopo);
+// meter e telemetria: al massimo max_fps volte al secondo (variabile d'ambiente GUA76_GUI_FPS).
+#define GUI_DEFAULT_MAX_FPS 30
+#define GUI_INPUT_FRAMES 2
+
+// Scala dei VU meter precalcolata (tacche ed etichette non cambiano da un frame all'altro)
+#define METER_SCALE_MAX_TICKS 32
+typedef struct {
+    float min_db;
+    float max_db;
+    int num_ticks;
+    float tick_norm[METER_SCALE_MAX_TICKS];  // Posizione della tacca (0 = min_db, 1 = max_db)
+    char tick_label[METER_SCALE_MAX_TICKS][8]; // Etichetta (vuota se la tacca non ne ha)
+} MeterScale;
+
+// Contatori per l'overlay delle prestazioni (F12 o GUA76_GUI_OVERLAY=1), aggiornati ogni secondo
+typedef struct {
+    double window_start; // Inizio della finestra di misura (glfwGetTime)
+    clock_t cpu_start;   // CPU del processo all'inizio della finestra
+    uint32_t frames;     // Frame disegnati nella finestra
+    uint32_t idles;      // Chiamate di idle nella finestra
+    double frame_time_sum;
+    double frame_time_max;
+    // Risultati dell'ultima finestra completa
+    float fps;
+    float idle_rate;
+    float frame_ms_avg;
+    float frame_ms_max;
+    float cpu_percent;
+} GuiStats;
+
+typedef struct {
+    float frames[GR_HISTORY_LENGTH][GUA76_TELEMETRY_FIELDS];
+    uint32_t write_pos; // Prossimo frame da scrivere
+    uint32_t count;     // Frame validi (fino a GR_HISTORY_LENGTH)
+} GRHistory;
 
 // Struttura per il nostro stato della GUI
 typedef struct {
     LV2_URID_Map* map;
-    LV2_UI_Write_Function write_function;
-    LV2_UI_Controller controller;
+    LV2UI_Write_Function write_function;
+    LV2UI_Controller controller;
 
     GLFWwindow* window; // Finestra GLFW
-    LV2_UI_Idle_Function idle_interface;
 
-    // Valori attuali dei parametri del plugin (cache) - Ora 20 parametri di controllo/output
-    float values[20]; // Aggiornato per riflettere il numero di porte di controllo + metering
+    // Valori attuali delle porte del plugin (cache), per indice della variante stereo (Gua76.h);
+    // le porte audio e atom restano inutilizzate
+    float values[GUA76_NUM_STEREO_PORTS];
 
-    // Nomi dei pulsanti del Ratio
+    // Nomi dei pulsanti del Ratio (GUA76_RATIO: 0..4)
     const char* ratio_labels[5];
-    // Nomi per le manopole a scatti (Attack/Release)
-    const char* attack_labels[7];
-    const float attack_values[7];
-    const char* release_labels[6];
-    const float release_values[6];
-    // Nomi per le modalità del VU meter di sinistra
+    // Nomi per le modalità del VU meter di sinistra (GUA76_METER_MODE: 0=GR, 1=Input, 2=Output)
     const char* meter_mode_labels[3];
 
+    // Telemetria dalla porta notify
+    LV2_URID atom_event_transfer;
+    LV2_URID atom_object;
+    LV2_URID atom_float;
+    LV2_URID atom_vector;
+    LV2_URID telemetry;
+    LV2_URID telemetry_frames;
+    GRHistory gr_history;
+
+    // Ridisegno su richiesta, limite di frame rate e overlay
+    int input_frames;      // Frame ancora da disegnare per input/controlli (subito)
+    bool meters_dirty;     // Meter o telemetria cambiati (limitati a max_fps)
+    float max_fps;
+    double last_frame_time;
+    bool show_overlay;
+    GuiStats stats;
+    MeterScale vu_scale;   // Scala condivisa dai VU meter (-30..0 dB)
+
 } Gua76UI;
 
 // Callback per errori GLFW
@@ -78,13 +117,29 @@ static void glfw_error_callback(int error, const char* description) {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
+// Precalcola tacche (ogni 5 dB) ed etichette (ogni 10 dB) di una scala in dB
+static void meter_scale_init(MeterScale* scale, float min_db, float max_db) {
+    scale->min_db = min_db;
+    scale->max_db = max_db;
+    scale->num_ticks = 0;
+    for (float db_tick = min_db; db_tick <= max_db && scale->num_ticks < METER_SCALE_MAX_TICKS; db_tick += 5.0f) {
+        const int t = scale->num_ticks++;
+        scale->tick_norm[t] = ImClamp((db_tick - min_db) / (max_db - min_db), 0.0f, 1.0f);
+        scale->tick_label[t][0] = '\0';
+        if (fmodf(db_tick, 10.0f) == 0.0f) {
+            snprintf(scale->tick_label[t], sizeof(scale->tick_label[t]), "%.0f", db_tick);
+        }
+    }
+}
+
 // Funzione helper per disegnare un VU Meter verticale
 // 'value_db': Il valore in dB da mostrare (es. -20.0f)
-// 'min_db': Il minimo del range in dB (es. -30.0f)
-// 'max_db': Il massimo del range in dB (es. 0.0f)
+// 'scale': La scala precalcolata (range in dB, tacche ed etichette)
 // 'size': ImVec2 per la dimensione del meter (larghezza, altezza)
 // 'peak_value': Un valore opzionale per un indicatore di picco
-static void DrawVUMeter(const char* label, float value_db, float min_db, float max_db, ImVec2 size, float peak_value = -1000.0f) {
+static void DrawVUMeter(const char* label, float value_db, const MeterScale* scale, ImVec2 size, float peak_value = -1000.0f) {
+    const float min_db = scale->min_db;
+    const float max_db = scale->max_db;
     ImGui::BeginGroup();
     ImGui::TextUnformatted(label); // Mostra il nome del meter
 
@@ -109,16 +164,13 @@ static void DrawVUMeter(const char* label, float value_db, float min_db, float m
     // Disegna la barra del livello
     draw_list->AddRectFilled(ImVec2(p.x, p.y + height - fill_height), ImVec2(p.x + width, p.y + height), bar_color);
 
-    // Disegna tacche e etichette (esempio)
-    for (float db_tick = min_db; db_tick <= max_db; db_tick += 5.0f) { // Tacche ogni 5 dB
-        float normalized_tick = ImClamp((db_tick - min_db) / (max_db - min_db), 0.0f, 1.0f);
-        float tick_y = p.y + height - (height * normalized_tick);
+    // Disegna tacche e etichette (dalla scala precalcolata)
+    const float half_line = ImGui::GetTextLineHeight() / 2;
+    for (int t = 0; t < scale->num_ticks; ++t) {
+        float tick_y = p.y + height - (height * scale->tick_norm[t]);
         draw_list->AddLine(ImVec2(p.x, tick_y), ImVec2(p.x + width * 0.2f, tick_y), IM_COL32(100, 100, 100, 255)); // Small tick
-
-        if (fmodf(db_tick, 10.0f) == 0.0f) { // Etichetta ogni 10 dB
-            char buf[16];
-            snprintf(buf, sizeof(buf), "%.0f", db_tick);
-            draw_list->AddText(ImVec2(p.x + width * 0.3f, tick_y - ImGui::GetTextLineHeight()/2), IM_COL32(150, 150, 150, 255), buf);
+        if (scale->tick_label[t][0]) {
+            draw_list->AddText(ImVec2(p.x + width * 0.3f, tick_y - half_line), IM_COL32(150, 150, 150, 255), scale->tick_label[t]);
         }
     }
 
@@ -134,17 +186,116 @@ static void DrawVUMeter(const char* label, float value_db, float min_db, float m
 }
 
 
+// Aggiunge i frame di un evento di telemetria alla storia (i più vecchi vengono sovrascritti)
+static void gr_history_push(GRHistory* history, const float* frames, uint32_t num_frames) {
+    for (uint32_t f = 0; f < num_frames; ++f) {
+        memcpy(history->frames[history->write_pos], frames + f * GUA76_TELEMETRY_FIELDS, sizeof(history->frames[0]));
+        history->write_pos = (history->write_pos + 1) % GR_HISTORY_LENGTH;
+        if (history->count < GR_HISTORY_LENGTH) history->count++;
+    }
+}
+
+// Disegna la storia della GR come grafico a scorrimento (il frame più recente a destra):
+// per ogni frame una barra dalla GR più leggera alla più profonda, più il picco di uscita.
+static void DrawGRHistory(const char* label, const GRHistory* history, float min_db, ImVec2 size) {
+    ImGui::BeginGroup();
+    ImGui::TextUnformatted(label);
+
+    ImVec2 p = ImGui::GetCursorScreenPos();
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    draw_list->AddRectFilled(p, ImVec2(p.x + size.x, p.y + size.y), IM_COL32(20, 20, 20, 255));
+
+    // Linee guida ogni 5 dB
+    for (float db_tick = min_db; db_tick <= 0.0f; db_tick += 5.0f) {
+        float tick_y = p.y + size.y * (db_tick / min_db);
+        draw_list->AddLine(ImVec2(p.x, tick_y), ImVec2(p.x + size.x, tick_y), IM_COL32(50, 50, 50, 255));
+    }
+
+    // Una colonna per frame, la GR cresce verso il basso dallo 0 dB in alto
+    const float column_width = size.x / (float)GR_HISTORY_LENGTH;
+    for (uint32_t i = 0; i < history->count; ++i) {
+        const uint32_t idx = (history->write_pos + GR_HISTORY_LENGTH - history->count + i) % GR_HISTORY_LENGTH;
+        const float* frame = history->frames[idx];
+        const float x = p.x + size.x - (float)(history->count - i) * column_width;
+        const float gr_light = ImClamp(frame[GUA76_TELEMETRY_GR_MAX] / min_db, 0.0f, 1.0f);
+        const float gr_deep = ImClamp(frame[GUA76_TELEMETRY_GR_MIN] / min_db, 0.0f, 1.0f);
+        draw_list->AddRectFilled(ImVec2(x, p.y), ImVec2(x + column_width, p.y + size.y * gr_deep),
+                                 IM_COL32(200, 120, 0, 255));
+        draw_list->AddRectFilled(ImVec2(x, p.y), ImVec2(x + column_width, p.y + size.y * gr_light),
+                                 IM_COL32(120, 70, 0, 255));
+        const float out_peak = ImClamp(frame[GUA76_TELEMETRY_PEAK_OUT] / min_db, 0.0f, 1.0f);
+        draw_list->AddLine(ImVec2(x, p.y + size.y * out_peak), ImVec2(x + column_width, p.y + size.y * out_peak),
+                           IM_COL32(0, 200, 0, 255));
+    }
+
+    ImGui::Dummy(size); // Riserva lo spazio per il grafico
+    ImGui::EndGroup();
+}
+
+
+// Callback GLFW per l'input: rendono necessario un nuovo frame. Installate prima del backend
+// GLFW di ImGui, che le richiama a sua volta.
+static void mark_input(GLFWwindow* window) {
+    Gua76UI* ui = (Gua76UI*)glfwGetWindowUserPointer(window);
+    if (ui) ui->input_frames = GUI_INPUT_FRAMES;
+}
+static void on_cursor_pos(GLFWwindow* window, double, double) { mark_input(window); }
+static void on_mouse_button(GLFWwindow* window, int, int, int) { mark_input(window); }
+static void on_scroll(GLFWwindow* window, double, double) { mark_input(window); }
+static void on_key(GLFWwindow* window, int, int, int, int) { mark_input(window); }
+static void on_char(GLFWwindow* window, unsigned int) { mark_input(window); }
+static void on_cursor_enter(GLFWwindow* window, int) { mark_input(window); }
+static void on_focus(GLFWwindow* window, int) { mark_input(window); }
+static void on_framebuffer_size(GLFWwindow* window, int, int) { mark_input(window); }
+
+// Aggiorna i contatori dell'overlay (ogni idle; 'frame_time' < 0 se il frame non è stato disegnato)
+static void gui_stats_update(GuiStats* stats, double now, double frame_time) {
+    stats->idles++;
+    if (frame_time >= 0.0) {
+        stats->frames++;
+        stats->frame_time_sum += frame_time;
+        if (frame_time > stats->frame_time_max) stats->frame_time_max = frame_time;
+    }
+    const double elapsed = now - stats->window_start;
+    if (elapsed < 1.0) return;
+    const clock_t cpu_now = clock();
+    stats->fps = (float)(stats->frames / elapsed);
+    stats->idle_rate = (float)(stats->idles / elapsed);
+    stats->frame_ms_avg = stats->frames ? (float)(stats->frame_time_sum * 1000.0 / stats->frames) : 0.0f;
+    stats->frame_ms_max = (float)(stats->frame_time_max * 1000.0);
+    stats->cpu_percent = (float)(100.0 * (double)(cpu_now - stats->cpu_start) / CLOCKS_PER_SEC / elapsed);
+    stats->window_start = now;
+    stats->cpu_start = cpu_now;
+    stats->frames = stats->idles = 0;
+    stats->frame_time_sum = stats->frame_time_max = 0.0;
+}
+
+// Overlay delle prestazioni nell'angolo in alto a destra
+static void DrawStatsOverlay(const Gua76UI* ui) {
+    const GuiStats* stats = &ui->stats;
+    char text[160];
+    snprintf(text, sizeof(text), "%.0f fps (max %.0f)  %.0f idle/s\nframe %.2f ms (max %.2f)\nCPU %.1f%% (processo)",
+             stats->fps, ui->max_fps, stats->idle_rate, stats->frame_ms_avg, stats->frame_ms_max, stats->cpu_percent);
+    ImDrawList* draw_list = ImGui::GetForegroundDrawList();
+    const ImVec2 text_size = ImGui::CalcTextSize(text);
+    const ImVec2 pos(ImGui::GetIO().DisplaySize.x - text_size.x - 10.0f, 10.0f);
+    draw_list->AddRectFilled(ImVec2(pos.x - 5.0f, pos.y - 5.0f), ImVec2(pos.x + text_size.x + 5.0f, pos.y + text_size.y + 5.0f),
+                             IM_COL32(0, 0, 0, 180));
+    draw_list->AddText(pos, IM_COL32(255, 255, 255, 255), text);
+}
+
+
 // Inizializzazione di GLFW, OpenGL e ImGui
-static LV2_UI_Handle
-instantiate(const LV2_UI_Descriptor* descriptor,
+static LV2UI_Handle
+instantiate(const LV2UI_Descriptor* descriptor,
             const char* plugin_uri,
             const char* bundle_path,
-            LV2_UI_Write_Function      write_function,
-            LV2_UI_Controller          controller,
-            LV2_UI_Widget* widget,
+            LV2UI_Write_Function      write_function,
+            LV2UI_Controller          controller,
+            LV2UI_Widget* widget,
             const LV2_Feature* const* features) {
 
-    if (strcmp(plugin_uri, GUA76_PLUGIN_URI) != 0) {
+    if (strcmp(plugin_uri, GUA76_URI) != 0) {
         fprintf(stderr, "Gua76UI: Plugin URI mismatch.\n");
         return NULL;
     }
@@ -155,65 +306,43 @@ instantiate(const LV2_UI_Descriptor* descriptor,
     ui->write_function = write_function;
     ui->controller = controller;
 
-    // Inizializza i valori dei parametri ai loro default (o 0)
-    for (int i = 0; i < 20; ++i) { // 20 è il numero di parametri di controllo + metering
-        ui->values[i] = 0.0f;
-    }
-    // Setta i default specifici da gua76.ttl
-    ui->values[GUA76_INPUT_GAIN] = 0.0f;
-    ui->values[GUA76_OUTPUT_GAIN] = 0.0f;
-    ui->values[GUA76_INPUT_PAD_10DB] = 0.0f;
-    ui->values[GUA76_BYPASS] = 0.0f;
-    ui->values[GUA76_NORMALIZE_OUTPUT] = 0.0f;
-    ui->values[GUA76_MS_MODE_ACTIVE] = 0.0f;
-    ui->values[GUA76_EXTERNAL_SC_ACTIVE] = 0.0f;
-    ui->values[GUA76_ATTACK] = 0.000020f;
-    ui->values[GUA76_RELEASE] = 0.2f;
-    ui->values[GUA76_RATIO] = 4.0f;
-    ui->values[GUA76_INPUT_CLIP_DRIVE] = 1.0f;
-    ui->values[GUA76_OUTPUT_CLIP_DRIVE] = 1.0f;
-    ui->values[GUA76_SC_HPF_FREQ] = 20.0f;
-    ui->values[GUA76_SC_LPF_FREQ] = 20000.0f;
-    ui->values[GUA76_SC_HPF_Q] = 0.707f;
-    ui->values[GUA76_SC_LPF_Q] = 0.707f;
-    ui->values[GUA76_METER_DISPLAY_MODE] = 1.0f; // Default: Output
+    // Default da gua76.ttl (l'host invia comunque i valori correnti all'apertura)
+    ui->values[GUA76_INPUT] = 0.75f;
+    ui->values[GUA76_OUTPUT] = 0.75f;
+    ui->values[GUA76_ATTACK] = 0.5f;
+    ui->values[GUA76_RELEASE] = 0.5f;
+    ui->values[GUA76_SIDECHAIN_HPF_FREQ] = 100.0f;
+    ui->values[GUA77_SIDECHAIN_HPF_Q] = 0.707f;
+    ui->values[GUA76_SIDECHAIN_LPF_FREQ] = 5000.0f;
+    ui->values[GUA76_MIDSIDE_LINK] = 1.0f;
+    for (int i = GUA76_PEAK_IN_L; i <= GUA76_PEAK_OUT_R; ++i) ui->values[i] = GUA76_METER_FLOOR_DB;
 
     // Setup labels for Ratio
     ui->ratio_labels[0] = "4:1";
     ui->ratio_labels[1] = "8:1";
     ui->ratio_labels[2] = "12:1";
     ui->ratio_labels[3] = "20:1";
-    ui->ratio_labels[4] = "All"; // Per 25.0
-
-    // Setup labels and values for Attack (7 steps)
-    ui->attack_labels[0] = "20us"; ui->attack_values[0] = 0.000020f;
-    ui->attack_labels[1] = "40us"; ui->attack_values[1] = 0.000040f;
-    ui->attack_labels[2] = "80us"; ui->attack_values[2] = 0.000080f;
-    ui->attack_labels[3] = "160us"; ui->attack_values[3] = 0.000160f;
-    ui->attack_labels[4] = "320us"; ui->attack_values[4] = 0.000320f;
-    ui->attack_labels[5] = "640us"; ui->attack_values[5] = 0.000640f;
-    ui->attack_labels[6] = "800us"; ui->attack_values[6] = 0.000800f;
-
-    // Setup labels and values for Release (6 steps)
-    ui->release_labels[0] = "50ms"; ui->release_values[0] = 0.05f;
-    ui->release_labels[1] = "100ms"; ui->release_values[1] = 0.1f;
-    ui->release_labels[2] = "200ms"; ui->release_values[2] = 0.2f;
-    ui->release_labels[3] = "400ms"; ui->release_values[3] = 0.4f;
-    ui->release_labels[4] = "800ms"; ui->release_values[4] = 0.8f;
-    ui->release_labels[5] = "1.1s"; ui->release_values[5] = 1.1f;
+    ui->ratio_labels[4] = "All";
 
     // Setup labels for Meter Display Mode
-    ui->meter_mode_labels[0] = "Input";
-    ui->meter_mode_labels[1] = "Output";
-    ui->meter_mode_labels[2] = "I-O Diff";
+    ui->meter_mode_labels[0] = "GR";
+    ui->meter_mode_labels[1] = "Input";
+    ui->meter_mode_labels[2] = "Output";
+
+    // Ridisegno su richiesta: il primo frame va disegnato comunque
+    ui->input_frames = GUI_INPUT_FRAMES;
+    ui->max_fps = GUI_DEFAULT_MAX_FPS;
+    const char* fps_env = getenv("GUA76_GUI_FPS");
+    if (fps_env && atof(fps_env) > 0.0) ui->max_fps = ImClamp((float)atof(fps_env), 1.0f, 240.0f);
+    const char* overlay_env = getenv("GUA76_GUI_OVERLAY");
+    ui->show_overlay = overlay_env && atoi(overlay_env) != 0;
+    meter_scale_init(&ui->vu_scale, -30.0f, 0.0f);
 
 
     // Cerca le feature necessarie
     for (int i = 0; features[i]; ++i) {
         if (strcmp(features[i]->URI, LV2_URID__map) == 0) {
             ui->map = (LV2_URID_Map*)features[i]->data;
-        } else if (strcmp(features[i]->URI, LV2_UI__idle) == 0) {
-            ui->idle_interface = (LV2_UI_Idle_Function)features[i]->data;
         }
     }
 
@@ -222,6 +351,12 @@ instantiate(const LV2_UI_Descriptor* descriptor,
         free(ui);
         return NULL;
     }
+    ui->atom_event_transfer = ui->map->map(ui->map->handle, LV2_ATOM__eventTransfer);
+    ui->atom_object = ui->map->map(ui->map->handle, LV2_ATOM__Object);
+    ui->atom_float = ui->map->map(ui->map->handle, LV2_ATOM__Float);
+    ui->atom_vector = ui->map->map(ui->map->handle, LV2_ATOM__Vector);
+    ui->telemetry = ui->map->map(ui->map->handle, GUA76_TELEMETRY_URI);
+    ui->telemetry_frames = ui->map->map(ui->map->handle, GUA76_TELEMETRY_FRAMES_URI);
 
     // --- Inizializzazione GLFW ---
     glfwSetErrorCallback(glfw_error_callback);
@@ -276,31 +411,45 @@ instantiate(const LV2_UI_Descriptor* descriptor,
         style.Colors[ImGuiCol_WindowBg].w = 1.0f;
     }
 
+    // Callback di input prima di quelle di ImGui (che le concatena)
+    glfwSetWindowUserPointer(ui->window, ui);
+    glfwSetCursorPosCallback(ui->window, on_cursor_pos);
+    glfwSetMouseButtonCallback(ui->window, on_mouse_button);
+    glfwSetScrollCallback(ui->window, on_scroll);
+    glfwSetKeyCallback(ui->window, on_key);
+    glfwSetCharCallback(ui->window, on_char);
+    glfwSetCursorEnterCallback(ui->window, on_cursor_enter);
+    glfwSetWindowFocusCallback(ui->window, on_focus);
+    glfwSetFramebufferSizeCallback(ui->window, on_framebuffer_size);
+
     ImGui_ImplGlfw_InitForOpenGL(ui->window, true);
     ImGui_ImplOpenGL3_Init("#version 130");
 
+    ui->stats.window_start = glfwGetTime();
+    ui->stats.cpu_start = clock();
+
     // --- Collega la finestra GLFW al widget LV2 ---
 #ifdef __linux__
-    *widget = (LV2_UI_Widget)glfwGetX11Window(ui->window);
+    *widget = (LV2UI_Widget)glfwGetX11Window(ui->window);
 #elif __APPLE__
     // Per macOS, questo è un placeholder. Richiede un wrapper NSView/Cocoa.
     // Per ora, non funzionerà correttamente come UI embeddata.
-    fprintf(stderr, "Gua76UI: macOS integration for GLFW window as LV2_UI_Widget not fully implemented (requires Cocoa wrapper).\n");
+    fprintf(stderr, "Gua76UI: macOS integration for GLFW window as LV2UI_Widget not fully implemented (requires Cocoa wrapper).\n");
     // Potresti voler visualizzare una finestra standalone per debug su macOS se non hai un wrapper completo.
     // glfwSetWindowAttrib(ui->window, GLFW_VISIBLE, GLFW_TRUE); // Rende visibile per test
     *widget = NULL; // O un puntatore dummy per evitare crash se l'host non lo usa.
 #elif _WIN32
     // Per Windows, questo è un placeholder. Richiede un wrapper HWND/WinAPI.
-    fprintf(stderr, "Gua76UI: Windows integration for GLFW window as LV2_UI_Widget not fully implemented (requires WinAPI wrapper).\n");
+    fprintf(stderr, "Gua76UI: Windows integration for GLFW window as LV2UI_Widget not fully implemented (requires WinAPI wrapper).\n");
     *widget = NULL;
 #endif
 
-    return (LV2_UI_Handle)ui;
+    return (LV2UI_Handle)ui;
 }
 
 // Funzione per gestire gli eventi del plugin (aggiornamenti dei parametri dal core)
 static void
-port_event(LV2_UI_Handle handle,
+port_event(LV2UI_Handle handle,
            uint32_t      port_index,
            uint32_t      buffer_size,
            uint32_t      format,
@@ -308,34 +457,70 @@ port_event(LV2_UI_Handle handle,
 
     Gua76UI* ui = (Gua76UI*)handle;
 
-    // Assicurati che sia un valore float e che l'indice sia valido
-    if (format == ui->map->map(ui->map->handle, LV2_ATOM_URI "#Float") &&
-        port_index < sizeof(ui->values) / sizeof(ui->values[0])) {
-        ui->values[port_index] = *(const float*)buffer;
-        // La GUI verrà ridisegnata nel loop di idle
+    // Telemetria: frame decimati della GR e dei livelli, accodati alla storia. Atom e vettore dei
+    // frame devono stare in buffer_size prima di leggerne il contenuto.
+    if (port_index == GUA76_NOTIFY && format == ui->atom_event_transfer) {
+        const LV2_Atom* atom = (const LV2_Atom*)buffer;
+        if (buffer_size < sizeof(LV2_Atom_Object) || atom->type != ui->atom_object ||
+            atom->size > buffer_size - sizeof(LV2_Atom)) return;
+        const LV2_Atom_Object* obj = (const LV2_Atom_Object*)atom;
+        if (obj->body.otype != ui->telemetry) return;
+        const LV2_Atom* frames = NULL;
+        lv2_atom_object_get(obj, ui->telemetry_frames, &frames, 0);
+        if (!frames || frames->type != ui->atom_vector || frames->size < sizeof(LV2_Atom_Vector_Body)) return;
+        const uint32_t frames_offset = (uint32_t)((const uint8_t*)frames - (const uint8_t*)buffer);
+        if (frames->size > buffer_size - sizeof(LV2_Atom) - frames_offset) return;
+        const LV2_Atom_Vector* vector = (const LV2_Atom_Vector*)frames;
+        if (vector->body.child_type != ui->atom_float || vector->body.child_size != sizeof(float)) return;
+        const uint32_t num_values = (vector->atom.size - sizeof(LV2_Atom_Vector_Body)) / sizeof(float);
+        gr_history_push(&ui->gr_history, (const float*)LV2_ATOM_CONTENTS_CONST(LV2_Atom_Vector, vector),
+                        num_values / GUA76_TELEMETRY_FIELDS);
+        ui->meters_dirty = true;
+        return;
     }
-}
 
-// Funzione per trovare il valore più vicino in un array discreto
-static int get_nearest_discrete_value_idx(float value, const float* arr, int size) {
-    int nearest_idx = 0;
-    float min_diff = fabsf(value - arr[0]);
-    for (int i = 1; i < size; ++i) {
-        float diff = fabsf(value - arr[i]);
-        if (diff < min_diff) {
-            min_diff = diff;
-            nearest_idx = i;
+    // Porte di controllo: format 0, un float; l'indice è quello della variante stereo
+    if (format == 0 && buffer_size == sizeof(float) &&
+        port_index < GUA76_NUM_STEREO_PORTS) {
+        const float value = *(const float*)buffer;
+        if (value == ui->values[port_index]) return; // Niente da ridisegnare
+        ui->values[port_index] = value;
+        // La GUI verrà ridisegnata nel loop di idle: le uscite (meter, latenza) col limite di frame
+        // rate, i controlli subito
+        if ((port_index >= GUA76_PEAK_GR && port_index <= GUA76_PEAK_OUT_R) || port_index == GUA76_LATENCY ||
+            port_index == GUA76_TRUE_PEAK_OUT_L || port_index == GUA76_TRUE_PEAK_OUT_R) {
+            ui->meters_dirty = true;
+        } else {
+            ui->input_frames = GUI_INPUT_FRAMES;
         }
     }
-    return nearest_idx;
 }
 
 // Funzione per il ciclo di esecuzione della GUI (rendering)
 static int
-ui_idle(LV2_UI_Handle handle) {
+ui_idle(LV2UI_Handle handle) {
     Gua76UI* ui = (Gua76UI*)handle;
     if (!ui || !ui->window) return 0;
 
+    // Processa gli eventi GLFW prima di decidere se disegnare (l'input rende necessario un frame)
+    glfwPollEvents();
+
+    // Controlla se la finestra GLFW è stata chiusa dall'utente
+    if (glfwWindowShouldClose(ui->window)) {
+        return 1; // Segnala all'host LV2 di chiudere la GUI
+    }
+
+    // Ridisegno su richiesta: senza input e con i meter fermi (o già aggiornati entro 1/max_fps) non si disegna
+    const double now = glfwGetTime();
+    const bool meters_due = ui->meters_dirty && (now - ui->last_frame_time) >= 1.0 / ui->max_fps;
+    if (ui->input_frames == 0 && !meters_due) {
+        gui_stats_update(&ui->stats, now, -1.0);
+        return 0;
+    }
+    if (ui->input_frames > 0) ui->input_frames--;
+    ui->meters_dirty = false;
+    ui->last_frame_time = now;
+
     // Inizia un nuovo frame ImGui
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -366,9 +551,9 @@ ui_idle(LV2_UI_Handle handle) {
     }
     ImGui::SameLine(0.0f, 20.0f); // Spazio tra i pulsanti
 
-    if (ImGui::Button((ui->values[GUA76_INPUT_PAD_10DB] > 0.5f) ? "PAD -10dB ON" : "PAD -10dB OFF", ImVec2(120, 30))) {
-        ui->values[GUA76_INPUT_PAD_10DB] = (ui->values[GUA76_INPUT_PAD_10DB] > 0.5f) ? 0.0f : 1.0f;
-        ui->write_function(ui->controller, GUA76_INPUT_PAD_10DB, sizeof(float), 0, &ui->values[GUA76_INPUT_PAD_10DB]);
+    if (ImGui::Button((ui->values[GUA76_PAD_10DB] > 0.5f) ? "PAD -10dB ON" : "PAD -10dB OFF", ImVec2(120, 30))) {
+        ui->values[GUA76_PAD_10DB] = (ui->values[GUA76_PAD_10DB] > 0.5f) ? 0.0f : 1.0f;
+        ui->write_function(ui->controller, GUA76_PAD_10DB, sizeof(float), 0, &ui->values[GUA76_PAD_10DB]);
     }
 
     ImGui::PopStyleColor(3);
@@ -392,33 +577,32 @@ ui_idle(LV2_UI_Handle handle) {
             ImGui::BeginGroup();
             ImGui::Text("Meter Display:");
             for (int i = 0; i < IM_ARRAYSIZE(ui->meter_mode_labels); ++i) {
-                if (ImGui::RadioButton(ui->meter_mode_labels[i], (int)ui->values[GUA76_METER_DISPLAY_MODE] == i)) {
-                    ui->values[GUA76_METER_DISPLAY_MODE] = (float)i;
-                    ui->write_function(ui->controller, GUA76_METER_DISPLAY_MODE, sizeof(float), 0, &ui->values[GUA76_METER_DISPLAY_MODE]);
+                if (ImGui::RadioButton(ui->meter_mode_labels[i], (int)(ui->values[GUA76_METER_MODE] + 0.5f) == i)) {
+                    ui->values[GUA76_METER_MODE] = (float)i;
+                    ui->write_function(ui->controller, GUA76_METER_MODE, sizeof(float), 0, &ui->values[GUA76_METER_MODE]);
                 }
             }
 
-            float meter_value = 0.0f;
-            if ((int)ui->values[GUA76_METER_DISPLAY_MODE] == 0) { // Input
-                meter_value = ui->values[GUA76_INPUT_RMS];
-            } else if ((int)ui->values[GUA76_METER_DISPLAY_MODE] == 1) { // Output
-                meter_value = ui->values[GUA76_OUTPUT_RMS];
-            } else { // I-O Diff
-                meter_value = ui->values[GUA76_OUTPUT_RMS] - ui->values[GUA76_INPUT_RMS];
+            // Picchi dalle porte dei meter (dB, massimo sui due canali)
+            float meter_value = ui->values[GUA76_PEAK_GR];
+            if ((int)(ui->values[GUA76_METER_MODE] + 0.5f) == 1) { // Input
+                meter_value = fmaxf(ui->values[GUA76_PEAK_IN_L], ui->values[GUA76_PEAK_IN_R]);
+            } else if ((int)(ui->values[GUA76_METER_MODE] + 0.5f) == 2) { // Output
+                meter_value = fmaxf(ui->values[GUA76_PEAK_OUT_L], ui->values[GUA76_PEAK_OUT_R]);
             }
-            DrawVUMeter("Lvl", meter_value, -30.0f, 0.0f, ImVec2(50, 150));
+            DrawVUMeter("Lvl", meter_value, &ui->vu_scale, ImVec2(50, 150));
             ImGui::EndGroup();
 
 
             ImGui::SameLine(); ImGui::Dummy(ImVec2(20,0)); ImGui::SameLine(); // Spazio
 
 
-            // Input Gain
+            // Input (livello normalizzato, come la manopola del plugin)
             ImGui::BeginGroup();
-            ImGui::Text("Input Gain");
-            ImGui::VSliderFloat("##InputGain", ImVec2(70, 150), &ui->values[GUA76_INPUT_GAIN], -20.0f, 20.0f, "%.1f dB");
+            ImGui::Text("Input");
+            ImGui::VSliderFloat("##Input", ImVec2(70, 150), &ui->values[GUA76_INPUT], 0.0f, 1.0f, "%.2f");
             if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_INPUT_GAIN, sizeof(float), 0, &ui->values[GUA76_INPUT_GAIN]);
+                ui->write_function(ui->controller, GUA76_INPUT, sizeof(float), 0, &ui->values[GUA76_INPUT]);
             }
             ImGui::EndGroup();
 
@@ -426,25 +610,23 @@ ui_idle(LV2_UI_Handle handle) {
             ImGui::SameLine(); ImGui::Dummy(ImVec2(20,0)); ImGui::SameLine(); // Spazio
 
 
-            // Output Gain
+            // Output
             ImGui::BeginGroup();
-            ImGui::Text("Output Gain");
-            ImGui::VSliderFloat("##OutputGain", ImVec2(70, 150), &ui->values[GUA76_OUTPUT_GAIN], -20.0f, 20.0f, "%.1f dB");
+            ImGui::Text("Output");
+            ImGui::VSliderFloat("##Output", ImVec2(70, 150), &ui->values[GUA76_OUTPUT], 0.0f, 1.0f, "%.2f");
             if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_OUTPUT_GAIN, sizeof(float), 0, &ui->values[GUA76_OUTPUT_GAIN]);
+                ui->write_function(ui->controller, GUA76_OUTPUT, sizeof(float), 0, &ui->values[GUA76_OUTPUT]);
             }
             ImGui::EndGroup();
 
             ImGui::SameLine(); ImGui::Dummy(ImVec2(20,0)); ImGui::SameLine(); // Spazio
 
-            // Attack (Manopola a Scatti)
+            // Attack (0 = veloce, 1 = lento)
             ImGui::BeginGroup();
             ImGui::Text("Attack");
-            // Trova l'indice corrente più vicino al valore del plugin
-            int current_attack_idx = get_nearest_discrete_value_idx(ui->values[GUA76_ATTACK], ui->attack_values, IM_ARRAYSIZE(ui->attack_values));
             ImGui::PushItemWidth(100);
-            if (ImGui::SliderInt("##Attack", &current_attack_idx, 0, IM_ARRAYSIZE(ui->attack_values) - 1, ui->attack_labels[current_attack_idx])) {
-                ui->values[GUA76_ATTACK] = ui->attack_values[current_attack_idx];
+            ImGui::SliderFloat("##Attack", &ui->values[GUA76_ATTACK], 0.0f, 1.0f, "%.2f");
+            if (ImGui::IsItemDeactivatedAfterEdit()) {
                 ui->write_function(ui->controller, GUA76_ATTACK, sizeof(float), 0, &ui->values[GUA76_ATTACK]);
             }
             ImGui::PopItemWidth();
@@ -452,13 +634,12 @@ ui_idle(LV2_UI_Handle handle) {
 
             ImGui::SameLine(); ImGui::Dummy(ImVec2(20,0)); ImGui::SameLine(); // Spazio
 
-            // Ratio Buttons
+            // Ratio Buttons (indice: 0=4:1 ... 4=All-Button)
             ImGui::BeginGroup();
             ImGui::Text("Ratio:");
-            const float ratio_values[] = {4.0f, 8.0f, 12.0f, 20.0f, 25.0f}; // 25.0 per All-Button
-            for (int n = 0; n < IM_ARRAYSIZE(ratio_values); n++) {
-                if (ImGui::RadioButton(ui->ratio_labels[n], ui->values[GUA76_RATIO] == ratio_values[n])) {
-                    ui->values[GUA76_RATIO] = ratio_values[n];
+            for (int n = 0; n < IM_ARRAYSIZE(ui->ratio_labels); n++) {
+                if (ImGui::RadioButton(ui->ratio_labels[n], (int)(ui->values[GUA76_RATIO] + 0.5f) == n)) {
+                    ui->values[GUA76_RATIO] = (float)n;
                     ui->write_function(ui->controller, GUA76_RATIO, sizeof(float), 0, &ui->values[GUA76_RATIO]);
                 }
             }
@@ -467,7 +648,11 @@ ui_idle(LV2_UI_Handle handle) {
             ImGui::SameLine(); ImGui::Dummy(ImVec2(20,0)); ImGui::SameLine(); // Spazio
 
             // Gain Reduction VU Meter (Destra)
-            DrawVUMeter("GR", ui->values[GUA76_GAIN_REDUCTION_METER], -30.0f, 0.0f, ImVec2(50, 150));
+            DrawVUMeter("GR", ui->values[GUA76_PEAK_GR], &ui->vu_scale, ImVec2(50, 150));
+
+            // Storia della GR (dalla telemetria: mostra i transitori anche con buffer dell'host grandi)
+            ImGui::Spacing();
+            DrawGRHistory("GR History", &ui->gr_history, -30.0f, ImVec2(ImGui::GetContentRegionAvail().x, 80));
 
 
             // Second Row (under Attack/Release/Ratio)
@@ -476,13 +661,12 @@ ui_idle(LV2_UI_Handle handle) {
             ImGui::Spacing();
 
 
-            // Release (Manopola a Scatti)
+            // Release (0 = veloce, 1 = lento)
             ImGui::BeginGroup();
             ImGui::Text("Release");
-            int current_release_idx = get_nearest_discrete_value_idx(ui->values[GUA76_RELEASE], ui->release_values, IM_ARRAYSIZE(ui->release_values));
             ImGui::PushItemWidth(100);
-            if (ImGui::SliderInt("##Release", &current_release_idx, 0, IM_ARRAYSIZE(ui->release_values) - 1, ui->release_labels[current_release_idx])) {
-                ui->values[GUA76_RELEASE] = ui->release_values[current_release_idx];
+            ImGui::SliderFloat("##Release", &ui->values[GUA76_RELEASE], 0.0f, 1.0f, "%.2f");
+            if (ImGui::IsItemDeactivatedAfterEdit()) {
                 ui->write_function(ui->controller, GUA76_RELEASE, sizeof(float), 0, &ui->values[GUA76_RELEASE]);
             }
             ImGui::PopItemWidth();
@@ -490,35 +674,15 @@ ui_idle(LV2_UI_Handle handle) {
 
             ImGui::SameLine(); ImGui::Dummy(ImVec2(20,0)); ImGui::SameLine();
 
-            // Clip Drive
+            // Drive/Saturation
             ImGui::PushItemWidth(150);
-            ImGui::SliderFloat("Input Clip Drive", &ui->values[GUA76_INPUT_CLIP_DRIVE], 0.0f, 10.0f, "%.1f");
-            if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_INPUT_CLIP_DRIVE, sizeof(float), 0, &ui->values[GUA76_INPUT_CLIP_DRIVE]);
-            }
-            ImGui::SameLine();
-            ImGui::SliderFloat("Output Clip Drive", &ui->values[GUA76_OUTPUT_CLIP_DRIVE], 0.0f, 10.0f, "%.1f");
+            ImGui::SliderFloat("Drive", &ui->values[GUA76_DRIVE_SATURATION], 0.0f, 1.0f, "%.2f");
             if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_OUTPUT_CLIP_DRIVE, sizeof(float), 0, &ui->values[GUA76_OUTPUT_CLIP_DRIVE]);
+                ui->write_function(ui->controller, GUA76_DRIVE_SATURATION, sizeof(float), 0, &ui->values[GUA76_DRIVE_SATURATION]);
             }
             ImGui::PopItemWidth();
 
 
-            // Normalize Output Button
-            ImGui::SameLine(); ImGui::Dummy(ImVec2(20,0)); ImGui::SameLine();
-            ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 3.0f);
-            ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(10.0f, 5.0f));
-            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.3f, 0.3f, 0.3f, 1.0f));
-            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.4f, 0.4f, 0.4f, 1.0f));
-            ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
-            if (ImGui::Button((ui->values[GUA76_NORMALIZE_OUTPUT] > 0.5f) ? "NORMALIZE ON" : "NORMALIZE OFF", ImVec2(140, 30))) {
-                ui->values[GUA76_NORMALIZE_OUTPUT] = (ui->values[GUA76_NORMALIZE_OUTPUT] > 0.5f) ? 0.0f : 1.0f;
-                ui->write_function(ui->controller, GUA76_NORMALIZE_OUTPUT, sizeof(float), 0, &ui->values[GUA76_NORMALIZE_OUTPUT]);
-            }
-            ImGui::PopStyleColor(3);
-            ImGui::PopStyleVar(2);
-
-
             ImGui::EndTabItem();
         }
 
@@ -531,15 +695,15 @@ ui_idle(LV2_UI_Handle handle) {
             ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.4f, 0.4f, 0.4f, 1.0f));
             ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
 
-            if (ImGui::Button((ui->values[GUA76_EXTERNAL_SC_ACTIVE] > 0.5f) ? "EXTERNAL SC ON" : "EXTERNAL SC OFF", ImVec2(150, 30))) {
-                ui->values[GUA76_EXTERNAL_SC_ACTIVE] = (ui->values[GUA76_EXTERNAL_SC_ACTIVE] > 0.5f) ? 0.0f : 1.0f;
-                ui->write_function(ui->controller, GUA76_EXTERNAL_SC_ACTIVE, sizeof(float), 0, &ui->values[GUA76_EXTERNAL_SC_ACTIVE]);
+            if (ImGui::Button((ui->values[GUA76_SIDECHAIN_LISTEN] > 0.5f) ? "SC LISTEN ON" : "SC LISTEN OFF", ImVec2(150, 30))) {
+                ui->values[GUA76_SIDECHAIN_LISTEN] = (ui->values[GUA76_SIDECHAIN_LISTEN] > 0.5f) ? 0.0f : 1.0f;
+                ui->write_function(ui->controller, GUA76_SIDECHAIN_LISTEN, sizeof(float), 0, &ui->values[GUA76_SIDECHAIN_LISTEN]);
             }
             ImGui::SameLine(0.0f, 20.0f);
 
-            if (ImGui::Button((ui->values[GUA76_MS_MODE_ACTIVE] > 0.5f) ? "M/S MODE ON" : "M/S MODE OFF", ImVec2(150, 30))) {
-                ui->values[GUA76_MS_MODE_ACTIVE] = (ui->values[GUA76_MS_MODE_ACTIVE] > 0.5f) ? 0.0f : 1.0f;
-                ui->write_function(ui->controller, GUA76_MS_MODE_ACTIVE, sizeof(float), 0, &ui->values[GUA76_MS_MODE_ACTIVE]);
+            if (ImGui::Button((ui->values[GUA76_MIDSIDE_MODE] > 0.5f) ? "M/S MODE ON" : "M/S MODE OFF", ImVec2(150, 30))) {
+                ui->values[GUA76_MIDSIDE_MODE] = (ui->values[GUA76_MIDSIDE_MODE] > 0.5f) ? 0.0f : 1.0f;
+                ui->write_function(ui->controller, GUA76_MIDSIDE_MODE, sizeof(float), 0, &ui->values[GUA76_MIDSIDE_MODE]);
             }
 
             ImGui::PopStyleColor(3);
@@ -548,27 +712,34 @@ ui_idle(LV2_UI_Handle handle) {
             ImGui::Separator();
             ImGui::Spacing();
 
-            // Sidechain Filters
+            // Sidechain Filters (un Q comune a passa-alto e passa-basso)
             ImGui::PushItemWidth(150);
-            ImGui::SliderFloat("SC HPF Freq (Hz)", &ui->values[GUA76_SC_HPF_FREQ], 20.0f, 20000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
+            bool hpf_on = ui->values[GUA76_SIDECHAIN_HPF_ON] > 0.5f;
+            if (ImGui::Checkbox("SC HPF", &hpf_on)) {
+                ui->values[GUA76_SIDECHAIN_HPF_ON] = hpf_on ? 1.0f : 0.0f;
+                ui->write_function(ui->controller, GUA76_SIDECHAIN_HPF_ON, sizeof(float), 0, &ui->values[GUA76_SIDECHAIN_HPF_ON]);
+            }
+            ImGui::SameLine();
+            ImGui::SliderFloat("SC HPF Freq (Hz)", &ui->values[GUA76_SIDECHAIN_HPF_FREQ], 20.0f, 20000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
             if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_SC_HPF_FREQ, sizeof(float), 0, &ui->values[GUA76_SC_HPF_FREQ]);
+                ui->write_function(ui->controller, GUA76_SIDECHAIN_HPF_FREQ, sizeof(float), 0, &ui->values[GUA76_SIDECHAIN_HPF_FREQ]);
             }
             ImGui::SameLine();
-            ImGui::SliderFloat("SC HPF Q", &ui->values[GUA76_SC_HPF_Q], 0.1f, 10.0f, "%.2f");
+            ImGui::SliderFloat("SC Filter Q", &ui->values[GUA77_SIDECHAIN_HPF_Q], 0.1f, 5.0f, "%.2f");
             if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_SC_HPF_Q, sizeof(float), 0, &ui->values[GUA76_SC_HPF_Q]);
+                ui->write_function(ui->controller, GUA77_SIDECHAIN_HPF_Q, sizeof(float), 0, &ui->values[GUA77_SIDECHAIN_HPF_Q]);
             }
             ImGui::Spacing();
 
-            ImGui::SliderFloat("SC LPF Freq (Hz)", &ui->values[GUA76_SC_LPF_FREQ], 20.0f, 20000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
-            if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_SC_LPF_FREQ, sizeof(float), 0, &ui->values[GUA76_SC_LPF_FREQ]);
+            bool lpf_on = ui->values[GUA76_SIDECHAIN_LPF_ON] > 0.5f;
+            if (ImGui::Checkbox("SC LPF", &lpf_on)) {
+                ui->values[GUA76_SIDECHAIN_LPF_ON] = lpf_on ? 1.0f : 0.0f;
+                ui->write_function(ui->controller, GUA76_SIDECHAIN_LPF_ON, sizeof(float), 0, &ui->values[GUA76_SIDECHAIN_LPF_ON]);
             }
             ImGui::SameLine();
-            ImGui::SliderFloat("SC LPF Q", &ui->values[GUA76_SC_LPF_Q], 0.1f, 10.0f, "%.2f");
+            ImGui::SliderFloat("SC LPF Freq (Hz)", &ui->values[GUA76_SIDECHAIN_LPF_FREQ], 20.0f, 20000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
             if (ImGui::IsItemDeactivatedAfterEdit()) {
-                ui->write_function(ui->controller, GUA76_SC_LPF_Q, sizeof(float), 0, &ui->values[GUA76_SC_LPF_Q]);
+                ui->write_function(ui->controller, GUA76_SIDECHAIN_LPF_FREQ, sizeof(float), 0, &ui->values[GUA76_SIDECHAIN_LPF_FREQ]);
             }
             ImGui::PopItemWidth();
 
@@ -581,6 +752,10 @@ ui_idle(LV2_UI_Handle handle) {
     // --- Fine della GUI ImGui ---
     ImGui::End();
 
+    // Overlay delle prestazioni (F12 per mostrarlo/nasconderlo)
+    if (ImGui::IsKeyPressed(ImGuiKey_F12, false)) ui->show_overlay = !ui->show_overlay;
+    if (ui->show_overlay) DrawStatsOverlay(ui);
+
     // Rendering ImGui
     ImGui::Render();
     int framebuffer_width, framebuffer_height;
@@ -599,21 +774,14 @@ ui_idle(LV2_UI_Handle handle) {
     }
 
     glfwSwapBuffers(ui->window);
-
-    // Controlla se la finestra GLFW è stata chiusa dall'utente
-    if (glfwWindowShouldClose(ui->window)) {
-        return 1; // Segnala all'host LV2 di chiudere la GUI
-    }
-
-    // Processa gli eventi GLFW
-    glfwPollEvents();
+    gui_stats_update(&ui->stats, glfwGetTime(), glfwGetTime() - now);
 
     return 0; // La GUI deve rimanere aperta
 }
 
 // Funzione di pulizia della GUI
 static void
-cleanup(LV2_UI_Handle handle) {
+cleanup(LV2UI_Handle handle) {
     Gua76UI* ui = (Gua76UI*)handle;
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -626,19 +794,28 @@ cleanup(LV2_UI_Handle handle) {
     free(ui);
 }
 
+// ui:idleInterface: l'host chiama ui_idle per il rendering (gua76.ttl, lv2:extensionData)
+static const void*
+extension_data(const char* uri) {
+    static const LV2UI_Idle_Interface idle_interface = { ui_idle };
+    if (strcmp(uri, LV2_UI__idleInterface) == 0) {
+        return &idle_interface;
+    }
+    return NULL;
+}
+
 // Descrizione della GUI per LV2
-static const LV2_UI_Descriptor ui_descriptor = {
+static const LV2UI_Descriptor ui_descriptor = {
     GUA76_GUI_URI,
     instantiate,
     cleanup,
     port_event,
-    ui_idle, // Utilizza ui_idle per il rendering continuo
-    NULL // no extension_data
+    extension_data
 };
 
 LV2_SYMBOL_EXPORT
-const LV2_UI_Descriptor*
-lv2_ui_descriptor(uint32_t index) {
+const LV2UI_Descriptor*
+lv2ui_descriptor(uint32_t index) {
     if (index == 0) {
         return &ui_descriptor;
     }
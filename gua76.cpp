@@ -1,12 +1,56 @@
 #include "gua76.h"
+#include "gua76_engine.h"
 #include <lv2/core/lv2.h>
 #include <lv2/log/logger.h>
 #include <lv2/log/log.h>
+#include <lv2/atom/atom.h>
+#include <lv2/atom/forge.h>
+#include <lv2/atom/util.h>
+#include <lv2/buf-size/buf-size.h>
+#include <lv2/options/options.h>
+#include <lv2/patch/patch.h>
+#include <lv2/urid/urid.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Build di riferimento (-DGUA76_REFERENCE_BUILD): stesso plugin con percorso scalare e
+// matematica esatta al posto delle approssimazioni (SIMD, tabelle, log2/exp2). Viene linkata
+// insieme alla build normale da tools/gua76_nulltest.cpp ed esporta gua76_reference_descriptor().
+#if !defined(GUA76_REFERENCE_BUILD) && \
+    (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define GUA76_USE_SSE 1
+#endif
+#if defined(GUA76_USE_SSE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define GUA76_USE_SSE2 1 // Corsie double per l'ADAA (DLanes)
+#endif
+
+// Approssimazioni di exp2/log2 e conversioni dB (gua76_fastmath.h): il riferimento usa sempre libm
+#ifdef GUA76_REFERENCE_BUILD
+#undef GUA76_FAST_MATH
+#define GUA76_FAST_MATH 0
+#endif
+#include "gua76_fastmath.h"
+
+// Modalità FP (flush-to-zero) anche nella build di riferimento: non è un'approssimazione
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define GUA76_FP_MODE_MXCSR 1
+#endif
+
+// Sospensione del DSP in silenzio (vedi SILENZIO): la build di riferimento elabora sempre
+// tutto, così il null test confronta anche il risveglio con l'elaborazione continua.
+#ifdef GUA76_REFERENCE_BUILD
+#define SILENCE_SLEEP 0
+#else
+#define SILENCE_SLEEP 1
+#endif
+
 // --- Costanti e Definizioni ---
 #define M_PI_F 3.14159265358979323846f
 
@@ -14,6 +58,15 @@
 #define GR_METER_SMOOTH_MS 10.0f // Tempo in ms per smoothing del gain reduction meter
 #define OUTPUT_METER_SMOOTH_MS 50.0f // Tempo in ms per smoothing del RMS output meter
 #define PEAK_METER_DECAY_MS 1000.0f // Tempo di decadimento per i peak meter (slower release)
+// I peak meter raccolgono il massimo di |x| per sotto-blocchi di METER_BLOCK campioni (alla frequenza
+// dell'host) dentro i passi che leggono o scrivono già i buffer. Tra un sotto-blocco e l'altro il
+// picco decade in forma chiusa sui campioni trascorsi: la balistica non dipende dalla dimensione
+// dei blocchi dell'host (errore < 0.01 dB, il decadimento dentro il sotto-blocco è ignorato).
+#define METER_BLOCK 32
+// Telemetria per la GUI: un frame ogni TELEMETRY_FRAME_BLOCKS sotto-blocchi dei meter
+// (256 campioni, ~5 ms a 48 kHz), indipendentemente dalla dimensione dei blocchi dell'host
+#define TELEMETRY_FRAME_BLOCKS 8
+#define TELEMETRY_FRAME_LENGTH (METER_BLOCK * TELEMETRY_FRAME_BLOCKS)
 
 // Valori min/max per i parametri (mapping da 0.0-1.0 float a valori reali)
 // Questi sono indicativi, da calibrare per il feeling del 1176
@@ -34,38 +87,190 @@
 #define DRIVE_SATURATION_AMOUNT_MIN 0.0f // Nessuna saturazione aggiuntiva
 #define DRIVE_SATURATION_AMOUNT_MAX 2.0f // Saturazione massima
 
+// --- SATURAZIONE: ANTI-ALIASING CON ANTIDERIVATE (ADAA) ---
+// Porta GUA76_SATURATION_MODE: la curva di saturazione (cubica + clip) campione per campione,
+// oppure in forma ADAA di ordine 1 o 2. Con l'ADAA l'uscita è la media della curva sul segmento
+// tra due ingressi consecutivi (ordine 1), o con un peso triangolare su tre (ordine 2), calcolata
+// con le differenze divise delle antiderivate: le armoniche oltre Nyquist vengono attenuate prima
+// di ripiegarsi. Non sostituisce del tutto un fattore più alto: a 5 kHz con drive massimo l'ADAA2
+// a 2x resta a -43 dB contro i -50 dB della curva semplice a 8x (tools/gua76_aliastest.cpp).
+// Aggiunge mezzo campione (ordine 1) o un campione (ordine 2) di ritardo alla frequenza interna:
+// arrotondato ai campioni dell'host entra nella latenza riportata (adaa_latency_samples).
+#define SATURATION_MODE_STANDARD 0
+#define SATURATION_MODE_ADAA1 1
+#define SATURATION_MODE_ADAA2 2
+#define NUM_SATURATION_MODES 3
+#define ADAA_TOLERANCE 1e-4 // Ingressi più vicini di così: curva (o antiderivata) nel punto medio
+
+// Ritardo dell'ADAA in campioni dell'host, arrotondato: ordine / (2 * fattore di oversampling),
+// con l'ordine uguale al modo. 1 a 1x (ADAA1 e ADAA2) e a 2x con ADAA2, altrimenti 0.
+static inline uint32_t adaa_latency_samples(int saturation_mode, int os_num_stages) {
+    return (uint32_t)((saturation_mode + (1 << os_num_stages)) >> (os_num_stages + 1));
+}
+
+// --- FREQUENZA DEL DETECTOR ---
+// Porta GUA76_DETECTOR_RATE: filtri sidechain, detector, gain computer e smoothing della GR girano
+// alla frequenza interna divisa per 2^valore (mai sotto il doppio di quella dell'host), e il gain
+// risultante viene interpolato linearmente fino alla frequenza interna prima di essere applicato.
+// Il sidechain viene sovracampionato solo fino alla frequenza del detector: gli stadi half-band
+// saltati non ne ritardano più il segnale, e il gain viene ritardato di altrettanto (meno il
+// ritardo dell'interpolazione) per restare allineato all'audio. Sidechain Listen usa sempre la
+// frequenza interna (si ascolta il sidechain filtrato).
+// Alla frequenza dell'host il detector non vede i picchi inter-campione: su rumore a banda piena
+// il null scendeva solo a -15 dB, e anche con il passa-basso del sidechain l'errore massimo
+// superava quello delle frequenze ridotte. Il limite è quindi il doppio della frequenza dell'host,
+// dove restano le stesse soglie delle altre (tools/gua76_detectortest.cpp).
+#define DETECTOR_RATE_FULL 0       // Frequenza interna (come prima della porta)
+#define DETECTOR_MIN_OS_STAGES 1   // Stadi half-band minimi del detector (con oversampling)
+#define DETECTOR_GAIN_MAX_DELAY 64 // Campioni alla frequenza interna (a 16x dall'host ne servono ~35)
+
 // Ratios per 1176: 4:1, 8:1, 12:1, 20:1, All-Button (che è "quasi" un 20:1 ma con un comportamento unico)
-static const float RATIO_VALUES[] = { 4.0f, 8.0f, 12.0f, 20.0f, 20.0f /* All-Button uses 20:1 effectively but with different curves */ };
+// Il gain computer lavora in dB: sopra la soglia la GR vale slope * (livello - soglia), con slope = 1/ratio - 1.
+// La curva originale era in lineare, (soglia + (x - soglia) / ratio) / x, e comprimeva meno sopra la soglia
+// (4:1 a 20 dB sopra: 9.8 dB di GR invece di 15): il knee parte duro come allora, la pendenza no (gua76.ttl).
+// All-Button usa 20:1 con una pendenza ancora più ripida (ratio * 1.5).
+#define ALL_BUTTON_RATIO_SCALE 1.5f
+#define NUM_RATIOS 5
+static const float RATIO_SLOPES[NUM_RATIOS] = {
+    1.0f / 4.0f - 1.0f,
+    1.0f / 8.0f - 1.0f,
+    1.0f / 12.0f - 1.0f,
+    1.0f / 20.0f - 1.0f,
+    1.0f / (20.0f * ALL_BUTTON_RATIO_SCALE) - 1.0f
+};
 // Threshold è tipicamente fisso in un 1176, lo impostiamo a un valore interno
 #define COMPRESSOR_THRESHOLD_DB -20.0f // Fissato internamente
+#define KNEE_DB_MAX 24.0f // Larghezza massima del soft knee (centrato sulla soglia)
 
 #define PAD_10DB_VALUE db_to_linear(-10.0f) // Valore lineare del pad -10dB
 
+// --- Smoothing dei Parametri ---
+// I controlli vengono confrontati con l'istantanea dell'ultimo blocco: gain lineari, tabelle
+// delle alpha e coefficienti dei filtri si ricalcolano solo quando il controllo cambia.
+// Le variazioni di gain sono interpolate per campione, quelle dei filtri sidechain per sotto-blocco.
+#define GAIN_SMOOTH_MS 20.0f
+#define SC_FILTER_SMOOTH_MS 20.0f
+#define SC_FILTER_SMOOTH_BLOCK 32 // Campioni (alla frequenza interna) tra due aggiornamenti dei coefficienti
+
 // --- OVERSEMPLING/UPSAMPLING ---
-#define UPSAMPLE_FACTOR 8 // Fattore di oversampling (8x per qualità professionale)
-// Useremo 3 filtri biquad in cascata per l'upsampling e il downsampling,
-// per ottenere un filtro passa-basso di 6° ordine (36 dB/ottava).
-#define NUM_BIQUADS_FOR_OS_FILTER 3 // 3 biquad -> 6° ordine (36 dB/ottava)
-#define OS_FILTER_Q 0.707f // Q di Butterworth per risposta piatta
+// Il fattore è selezionabile a runtime (porta GUA76_OVERSAMPLING_FACTOR): 1x, 2x, 4x, 8x, 16x.
+// L'oversampling è una cascata di filtri half-band polifase IIR (2x -> 4x -> 8x -> 16x).
+// Ogni stadio raddoppia (o dimezza) la frequenza di campionamento con due catene
+// di allpass del primo ordine che lavorano alla frequenza più bassa: niente
+// moltiplicazioni per gli zeri inseriti e solo i campioni decimati vengono calcolati.
+// A 1x l'elaborazione avviene direttamente alla frequenza dell'host, senza buffer di oversampling.
+#define OS_MAX_HALFBAND_STAGES 4 // log2(MAX_UPSAMPLE_FACTOR)
+#define MAX_UPSAMPLE_FACTOR (1 << OS_MAX_HALFBAND_STAGES) // 16x
+#define DEFAULT_OS_STAGES 3 // 8x, se la porta non è collegata
+#define HALFBAND_MAX_COEFS 10
+
+
+// --- DIMENSIONE DEI BLOCCHI ---
+// La lunghezza massima del blocco arriva dall'host (bufsz:maxBlockLength, altrimenti
+// bufsz:nominalBlockLength) e tutti i buffer vengono allocati una volta in instantiate().
+// I blocchi più lunghi (es. bounce offline da 8192-16384 campioni) sono elaborati in chunk.
+#define DEFAULT_MAX_BLOCK_LENGTH 4096 // Se l'host non comunica la dimensione dei blocchi
+#define MAX_CHUNK_LENGTH 8192 // Limite dei buffer alla frequenza dell'host (meter, lookahead)
+// Dentro un chunk i passi di elaborazione procedono a micro-blocchi di PIPELINE_BLOCK_OS_SAMPLES
+// campioni alla frequenza interna (a 8x: 64 campioni dell'host): i buffer intermedi (sovracampionati,
+// detector, alpha) restano in L1 per qualunque lunghezza del blocco dell'host.
+#define PIPELINE_BLOCK_OS_SAMPLES 512 // Multiplo di METER_BLOCK * MAX_UPSAMPLE_FACTOR
+
+
+// --- ENVELOPE DETECTOR ---
+// Le alpha di attacco/rilascio dipendono dall'ampiezza (comportamento program-dependent del 1176):
+// alpha(a) = 1 - exp(-1 / (fs * T * (1 + 0.5 * a))), con a in [0, 1].
+// Invece di quattro expf() per campione si usa una tabella per blocco, interpolata linearmente.
+// Con 32 segmenti l'errore relativo massimo su alpha è < 1e-4 su tutto il range di tempi e frequenze.
+#define DETECTOR_ALPHA_TABLE_SIZE 32
 
 
 // --- SIDECHAIN FILTERS ---
 #define NUM_BIQUADS_FOR_SIDECHAIN_FILTER 3 // Per 36dB/ottava
 
+
+// --- LOOKAHEAD ---
+// L'audio viene ritardato di L campioni (alla frequenza dell'host, prima dell'oversampling),
+// mentre il detector riceve il massimo di |sidechain| sulla finestra [t - L, t]: quando il
+// transiente arriva all'applicazione del gain la GR si sta già muovendo. Il massimo a finestra
+// mobile usa una coda monotona (costo O(1) ammortizzato per campione, per qualsiasi L).
+// Il ritardo è riportato all'host sulla porta di latenza.
+#define LOOKAHEAD_MS_MAX 10.0f
+
+
+// --- CANALI ---
+// Varianti mono, stereo, 5.1 e 7.1 (vedi VARIANTS): il motore è generico sul numero di canali
+// e i filtri elaborano i canali a gruppi di SIMD_LANES corsie.
+#define MAX_CHANNEL_LANE_GROUPS (GUA76_MAX_CHANNELS / 4)      // Audio (o sidechain) di 8 canali
+#define MAX_UPSAMPLE_LANE_GROUPS (2 * MAX_CHANNEL_LANE_GROUPS) // Audio + sidechain esterno
+
+// Link del detector tra i canali (porta GUA76_DETECTOR_LINK)
+#define DETECTOR_LINK_INDEPENDENT 0 // Un detector per canale (default stereo)
+#define DETECTOR_LINK_MAX 1         // Un solo detector sul massimo dei canali (default multicanale)
+#define DETECTOR_LINK_SUM 2         // Un solo detector sulla media dei canali
+
+
+// --- SILENZIO ---
+// Quando ingresso e sidechain restano sotto SILENCE_THRESHOLD_DB per SILENCE_HOLD_MS (più il
+// lookahead, così le code dei filtri e la linea di ritardo si svuotano) e i detector sono scarichi,
+// lo stato del DSP viene azzerato e i chunk successivi scrivono zeri senza elaborare, finché
+// l'ingresso resta in silenzio. Al risveglio si riparte dallo stato azzerato, come dopo activate().
+#define SILENCE_THRESHOLD_DB -120.0f
+#define SILENCE_ENVELOPE_DB  -80.0f  // Envelope sotto cui il detector non influisce più sulla GR
+#define SILENCE_GR_LINEAR    0.9999f // GR residua trascurabile (circa -0.001 dB)
+#define SILENCE_HOLD_MS      100.0f
+
 // --- Funzioni di Utilità Generali ---
 
 static float to_db(float linear_val) {
     if (linear_val <= 0.00000000001f) return -90.0f; // Prevent log(0) for very small values
-    return 20.0f * log10f(linear_val);
+    return fast_gain_to_db(linear_val);
+}
+
+// Un float è finito (né NaN né Inf): confronto sui bit, indipendente dalle opzioni di ottimizzazione
+static inline bool is_finite_float(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return (bits & 0x7f800000u) != 0x7f800000u;
+}
+
+// Flush-to-zero / denormals-are-zero per la durata di run(): le code di filtri ed envelope che
+// decadono finirebbero nei denormali, molto lenti su x86. La modalità dell'host viene ripristinata.
+#ifdef GUA76_FP_MODE_MXCSR
+typedef unsigned int FpMode;
+#define FP_MODE_FTZ 0x8000u // MXCSR: flush-to-zero
+#define FP_MODE_DAZ 0x0040u // MXCSR: denormals-are-zero
+static inline FpMode fp_mode_enter(void) {
+    const FpMode mode = _mm_getcsr();
+    _mm_setcsr(mode | FP_MODE_FTZ | FP_MODE_DAZ);
+    return mode;
+}
+static inline void fp_mode_leave(FpMode mode) { _mm_setcsr(mode); }
+#elif defined(__aarch64__)
+typedef uint64_t FpMode;
+#define FP_MODE_FZ (1ull << 24) // FPCR: flush-to-zero (ingressi e uscite)
+static inline FpMode fp_mode_enter(void) {
+    FpMode mode;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(mode));
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(mode | FP_MODE_FZ));
+    return mode;
 }
+static inline void fp_mode_leave(FpMode mode) { __asm__ __volatile__("msr fpcr, %0" : : "r"(mode)); }
+#else
+typedef int FpMode;
+static inline FpMode fp_mode_enter(void) { return 0; }
+static inline void fp_mode_leave(FpMode) {}
+#endif
 
 static float db_to_linear(float db_val) {
-    return powf(10.0f, db_val / 20.0f);
+    return fast_db_to_gain(db_val);
 }
 
+#ifdef GUA76_REFERENCE_BUILD
 // Funzione di soft-clipping/saturazione inspirata a un compressore FET
 // Aggiunge la "punchiness" e la saturazione tipica.
 // Il 'drive_amount' influisce sulla quantità di saturazione.
+// (La build ottimizzata usa lanes_soft_clip, la stessa curva su 4 campioni.)
 static float apply_soft_clip(float sample, float drive_amount) {
     float sign = (sample >= 0) ? 1.0f : -1.0f;
     float abs_sample = fabsf(sample);
@@ -79,23 +284,181 @@ static float apply_soft_clip(float sample, float drive_amount) {
     float saturated_sample = abs_sample - (abs_sample * abs_sample * abs_sample) * (drive_amount * 0.1f);
 
     // Un leggero hard clipping finale per sicurezza o per emulare il limitatore dell'1176.
-    return sign * fminf(fmaxf(saturated_sample, -1.0f), 1.0f);
+    return sign * fast_min(fast_max(saturated_sample, -1.0f), 1.0f);
+}
+#endif
+
+
+// --- Corsie SIMD (structure-of-arrays) ---
+// I filtri elaborano più canali insieme: ogni corsia di un vettore a 4 float è un canale
+// (es. L, R, sidechain L, sidechain R). La catena di dipendenza seriale di un filtro viene
+// così percorsa una volta sola per tutti i canali invece che una volta per canale.
+// Con SSE le corsie sono un __m128, altrimenti un piccolo array che il compilatore può vettorizzare.
+#define SIMD_LANES 4
+
+#ifdef GUA76_USE_SSE
+typedef __m128 Lanes;
+static inline Lanes lanes_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void lanes_store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+static inline Lanes lanes_set1(float x) { return _mm_set1_ps(x); }
+static inline Lanes lanes_add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+static inline Lanes lanes_sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+static inline Lanes lanes_mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+static inline Lanes lanes_max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+static inline Lanes lanes_min(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+static inline Lanes lanes_abs(Lanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+// Nega le corsie di 'a' in cui 'sign' è negativo (bit di segno)
+static inline Lanes lanes_flip_sign(Lanes a, Lanes sign) { return _mm_xor_ps(a, _mm_and_ps(sign, _mm_set1_ps(-0.0f))); }
+#else
+typedef struct { float v[SIMD_LANES]; } Lanes;
+static inline Lanes lanes_load(const float* p) { Lanes r; for (int c = 0; c < SIMD_LANES; ++c) r.v[c] = p[c]; return r; }
+static inline void lanes_store(float* p, Lanes v) { for (int c = 0; c < SIMD_LANES; ++c) p[c] = v.v[c]; }
+static inline Lanes lanes_set1(float x) { Lanes r; for (int c = 0; c < SIMD_LANES; ++c) r.v[c] = x; return r; }
+static inline Lanes lanes_add(Lanes a, Lanes b) { for (int c = 0; c < SIMD_LANES; ++c) a.v[c] += b.v[c]; return a; }
+static inline Lanes lanes_sub(Lanes a, Lanes b) { for (int c = 0; c < SIMD_LANES; ++c) a.v[c] -= b.v[c]; return a; }
+static inline Lanes lanes_mul(Lanes a, Lanes b) { for (int c = 0; c < SIMD_LANES; ++c) a.v[c] *= b.v[c]; return a; }
+static inline Lanes lanes_max(Lanes a, Lanes b) { for (int c = 0; c < SIMD_LANES; ++c) a.v[c] = fast_max(a.v[c], b.v[c]); return a; }
+static inline Lanes lanes_min(Lanes a, Lanes b) { for (int c = 0; c < SIMD_LANES; ++c) a.v[c] = fast_min(a.v[c], b.v[c]); return a; }
+static inline Lanes lanes_abs(Lanes a) { for (int c = 0; c < SIMD_LANES; ++c) a.v[c] = fabsf(a.v[c]); return a; }
+static inline Lanes lanes_flip_sign(Lanes a, Lanes sign) { for (int c = 0; c < SIMD_LANES; ++c) if (signbit(sign.v[c])) a.v[c] = -a.v[c]; return a; }
+#endif
+
+// exp2/log2 di gua76_fastmath.h su tutte le corsie (con SSE2 le versioni vettoriali, stessi risultati)
+static inline Lanes lanes_exp2(Lanes x) {
+#if defined(GUA76_USE_SSE) && defined(GUA76_FASTMATH_SSE2)
+    return fast_exp2_ps(x);
+#else
+    float v[SIMD_LANES];
+    lanes_store(v, x);
+    for (int c = 0; c < SIMD_LANES; ++c) v[c] = fast_exp2(v[c]);
+    return lanes_load(v);
+#endif
+}
+
+static inline Lanes lanes_log2(Lanes x) {
+#if defined(GUA76_USE_SSE) && defined(GUA76_FASTMATH_SSE2)
+    return fast_log2_ps(x);
+#else
+    float v[SIMD_LANES];
+    lanes_store(v, x);
+    for (int c = 0; c < SIMD_LANES; ++c) v[c] = fast_log2(v[c]);
+    return lanes_load(v);
+#endif
 }
 
+// --- Corsie double (DLanes) ---
+// Due campioni consecutivi in double, per le curve ADAA: le differenze divise delle antiderivate
+// perdono troppe cifre in float. Le maschere sono il risultato dei confronti, da usare con dlanes_select.
+#define DLANES 2
+
+#ifdef GUA76_USE_SSE2
+typedef __m128d DLanes;
+typedef __m128d DMask;
+static inline DLanes dlanes_load(const double* p) { return _mm_loadu_pd(p); }
+static inline void dlanes_store(double* p, DLanes v) { _mm_storeu_pd(p, v); }
+static inline DLanes dlanes_set1(double x) { return _mm_set1_pd(x); }
+static inline DLanes dlanes_add(DLanes a, DLanes b) { return _mm_add_pd(a, b); }
+static inline DLanes dlanes_sub(DLanes a, DLanes b) { return _mm_sub_pd(a, b); }
+static inline DLanes dlanes_mul(DLanes a, DLanes b) { return _mm_mul_pd(a, b); }
+static inline DLanes dlanes_div(DLanes a, DLanes b) { return _mm_div_pd(a, b); }
+static inline DLanes dlanes_neg(DLanes a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+static inline DLanes dlanes_abs(DLanes a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+static inline DMask dlanes_ge(DLanes a, DLanes b) { return _mm_cmpge_pd(a, b); }
+static inline DMask dlanes_gt(DLanes a, DLanes b) { return _mm_cmpgt_pd(a, b); }
+static inline DMask dlanes_lt(DLanes a, DLanes b) { return _mm_cmplt_pd(a, b); }
+// Corsie di 'a' dove la maschera è vera, di 'b' altrove
+static inline DLanes dlanes_select(DMask m, DLanes a, DLanes b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+// Bit i = corsia i vera
+static inline int dlanes_mask_bits(DMask m) { return _mm_movemask_pd(m); }
+#else
+typedef struct { double v[DLANES]; } DLanes;
+typedef struct { bool v[DLANES]; } DMask;
+static inline DLanes dlanes_load(const double* p) { DLanes r; for (int c = 0; c < DLANES; ++c) r.v[c] = p[c]; return r; }
+static inline void dlanes_store(double* p, DLanes v) { for (int c = 0; c < DLANES; ++c) p[c] = v.v[c]; }
+static inline DLanes dlanes_set1(double x) { DLanes r; for (int c = 0; c < DLANES; ++c) r.v[c] = x; return r; }
+static inline DLanes dlanes_add(DLanes a, DLanes b) { for (int c = 0; c < DLANES; ++c) a.v[c] += b.v[c]; return a; }
+static inline DLanes dlanes_sub(DLanes a, DLanes b) { for (int c = 0; c < DLANES; ++c) a.v[c] -= b.v[c]; return a; }
+static inline DLanes dlanes_mul(DLanes a, DLanes b) { for (int c = 0; c < DLANES; ++c) a.v[c] *= b.v[c]; return a; }
+static inline DLanes dlanes_div(DLanes a, DLanes b) { for (int c = 0; c < DLANES; ++c) a.v[c] /= b.v[c]; return a; }
+static inline DLanes dlanes_neg(DLanes a) { for (int c = 0; c < DLANES; ++c) a.v[c] = -a.v[c]; return a; }
+static inline DLanes dlanes_abs(DLanes a) { for (int c = 0; c < DLANES; ++c) a.v[c] = fabs(a.v[c]); return a; }
+static inline DMask dlanes_ge(DLanes a, DLanes b) { DMask m; for (int c = 0; c < DLANES; ++c) m.v[c] = a.v[c] >= b.v[c]; return m; }
+static inline DMask dlanes_gt(DLanes a, DLanes b) { DMask m; for (int c = 0; c < DLANES; ++c) m.v[c] = a.v[c] > b.v[c]; return m; }
+static inline DMask dlanes_lt(DLanes a, DLanes b) { DMask m; for (int c = 0; c < DLANES; ++c) m.v[c] = a.v[c] < b.v[c]; return m; }
+static inline DLanes dlanes_select(DMask m, DLanes a, DLanes b) { for (int c = 0; c < DLANES; ++c) if (!m.v[c]) a.v[c] = b.v[c]; return a; }
+static inline int dlanes_mask_bits(DMask m) { int bits = 0; for (int c = 0; c < DLANES; ++c) bits |= (m.v[c] ? 1 : 0) << c; return bits; }
+#endif
+
+// Raccoglie il campione 'idx' di fino a 4 buffer planari (le corsie inutilizzate valgono 0)
+static inline Lanes lanes_gather(const float* const* bufs, int num_lanes, uint32_t idx) {
+    float tmp[SIMD_LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int c = 0; c < num_lanes; ++c) tmp[c] = bufs[c][idx];
+    return lanes_load(tmp);
+}
 
-// Funzione per calcolare il picco assoluto e applicare il decadimento (per i peak meter)
-static float calculate_peak_level(const float* buffer, uint32_t n_samples, float current_peak_linear, float decay_alpha) {
-    float max_abs_val = 0.0f;
-    for (uint32_t i = 0; i < n_samples; ++i) {
-        float abs_sample = fabsf(buffer[i]);
-        if (abs_sample > max_abs_val) {
-            max_abs_val = abs_sample;
+// Distribuisce 'count' vettori consecutivi nel tempo sui buffer planari, a partire da 'idx'.
+// Con 4 corsie piene i gruppi di 4 campioni vengono trasposti e scritti con store vettoriali.
+static inline void lanes_scatter_block(float* const* bufs, int num_lanes, uint32_t idx, const Lanes* v, uint32_t count) {
+    uint32_t j = 0;
+#ifdef GUA76_USE_SSE
+    if (num_lanes == SIMD_LANES) {
+        for (; j + 4 <= count; j += 4) {
+            __m128 r0 = v[j], r1 = v[j + 1], r2 = v[j + 2], r3 = v[j + 3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(bufs[0] + idx + j, r0);
+            _mm_storeu_ps(bufs[1] + idx + j, r1);
+            _mm_storeu_ps(bufs[2] + idx + j, r2);
+            _mm_storeu_ps(bufs[3] + idx + j, r3);
         }
     }
-    // Combined peak (new peak or decaying old peak)
-    // Se il nuovo picco è maggiore, lo prendiamo. Altrimenti, decadiamo il vecchio.
-    // Questo è un picco con "hold" e decadimento, tipico dei meter analogici.
-    return fmaxf(max_abs_val, current_peak_linear * (1.0f - decay_alpha));
+#endif
+    for (; j < count; ++j) {
+        float tmp[SIMD_LANES];
+        lanes_store(tmp, v[j]);
+        for (int c = 0; c < num_lanes; ++c) bufs[c][idx + j] = tmp[c];
+    }
+}
+
+
+// Massimo tra le corsie
+static inline float lanes_hmax(Lanes v) {
+    float tmp[SIMD_LANES];
+    lanes_store(tmp, v);
+    return fast_max(fast_max(tmp[0], tmp[1]), fast_max(tmp[2], tmp[3]));
+}
+
+// Massimo di |x| su un buffer (riduzione SIMD a 4 corsie)
+static inline float peak_abs(const float* x, uint32_t n) {
+    Lanes acc = lanes_set1(0.0f);
+    uint32_t i = 0;
+    for (; i + SIMD_LANES <= n; i += SIMD_LANES) acc = lanes_max(acc, lanes_abs(lanes_load(x + i)));
+    float peak = lanes_hmax(acc);
+    for (; i < n; ++i) peak = fast_max(peak, fabsf(x[i]));
+    return peak;
+}
+
+// Somma dei quadrati su un buffer (riduzione SIMD a 4 corsie)
+static inline float sum_squares(const float* x, uint32_t n) {
+    Lanes acc = lanes_set1(0.0f);
+    uint32_t i = 0;
+    for (; i + SIMD_LANES <= n; i += SIMD_LANES) {
+        const Lanes v = lanes_load(x + i);
+        acc = lanes_add(acc, lanes_mul(v, v));
+    }
+    float tmp[SIMD_LANES];
+    lanes_store(tmp, acc);
+    float sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    for (; i < n; ++i) sum += x[i] * x[i];
+    return sum;
+}
+
+// Scrive il massimo di ogni corsia nel sotto-blocco 'k' dei meter (NULL = corsia senza meter)
+static inline void lanes_store_peaks(float* const* peaks, int num_lanes, uint32_t k, Lanes v) {
+    float tmp[SIMD_LANES];
+    lanes_store(tmp, v);
+    for (int c = 0; c < num_lanes; ++c) {
+        if (peaks[c]) peaks[c][k] = tmp[c];
+    }
 }
 
 
@@ -106,18 +469,6 @@ typedef struct {
     float z1, z2;                 // Stati precedenti
 } BiquadFilter;
 
-static void biquad_init(BiquadFilter* f) {
-    f->a0 = f->a1 = f->a2 = f->b0 = f->b1 = f->b2 = 0.0f;
-    f->z1 = f->z2 = 0.0f;
-}
-
-static float biquad_process(BiquadFilter* f, float in) {
-    float out = in * f->b0 + f->z1;
-    f->z1 = in * f->b1 + f->z2 - f->a1 * out;
-    f->z2 = in * f->b2 - f->a2 * out;
-    return out;
-}
-
 // Calcola i coefficienti per un filtro biquad (Low Pass o High Pass)
 // freq_hz: frequenza di taglio
 // q_val: fattore di qualità (risonanza)
@@ -158,579 +509,2859 @@ static void calculate_biquad_coeffs(BiquadFilter* f, double samplerate, float fr
     f->a0 = 1.0f; // Questo non viene usato nel process, è solo per chiarezza, il denominatore è 1.0
 }
 
-
-// Struct del plugin
+// Biquad in formato SoA: coefficienti e stati per corsia
 typedef struct {
-    // Puntatori ai parametri di controllo (Input)
-    float* input_ptr;
-    float* output_ptr;
-    float* attack_ptr;
-    float* release_ptr;
-    float* ratio_ptr;
-    float* meter_mode_ptr;
-    float* bypass_ptr;
-    float* drive_saturation_ptr;
-    float* oversampling_ptr;
-    float* sidechain_hpf_on_ptr;
-    float* sidechain_hpf_freq_ptr;
-    float* sidechain_hpf_q_ptr; // Nuovo
-    float* sidechain_lpf_on_ptr;
-    float* sidechain_lpf_freq_ptr;
-    float* sidechain_listen_ptr;
-    float* midside_mode_ptr; // Nuovo
-    float* midside_link_ptr; // Nuovo
-    float* pad_10db_ptr; // Nuovo
-
-    // Puntatori per i meter (Output del plugin, input per la GUI)
-    float* peak_gr_ptr;
-    float* peak_in_l_ptr;
-    float* peak_in_r_ptr;
-    float* peak_out_l_ptr;
-    float* peak_out_r_ptr;
+    float b0[SIMD_LANES], b1[SIMD_LANES], b2[SIMD_LANES], a1[SIMD_LANES], a2[SIMD_LANES];
+    float z1[SIMD_LANES], z2[SIMD_LANES];
+} BiquadLanes;
 
-    // Puntatori ai buffer audio
-    const float* audio_in_l_ptr;
-    const float* audio_in_r_ptr;
-    float* audio_out_l_ptr;
-    float* audio_out_r_ptr;
-
-    // Nuovi puntatori ai buffer sidechain esterni
-    const float* sidechain_in_l_ptr;
-    const float* sidechain_in_r_ptr;
+#define BIQUAD_LANES_MAX_STAGES (2 * NUM_BIQUADS_FOR_SIDECHAIN_FILTER) // HPF + LPF in cascata
 
+static void biquad_lanes_init(BiquadLanes* f) {
+    memset(f, 0, sizeof(BiquadLanes));
+}
 
-    // Variabili di stato del plugin
-    double samplerate;
-    double oversampled_samplerate;
-    LV2_Log_Log* log;
-    LV2_Log_Logger logger;
+// Copia i coefficienti calcolati da calculate_biquad_coeffs in una corsia
+static void biquad_lanes_set_coeffs(BiquadLanes* f, int lane, const BiquadFilter* c) {
+    f->b0[lane] = c->b0;
+    f->b1[lane] = c->b1;
+    f->b2[lane] = c->b2;
+    f->a1[lane] = c->a1;
+    f->a2[lane] = c->a2;
+}
 
-    // Variabili di stato del compressore (per canale)
-    float envelope_l; // Detector envelope per Left/Mid
-    float envelope_r; // Detector envelope per Right/Side
-    float current_gr_linear_l; // Current gain reduction for Left/Mid (linear)
-    float current_gr_linear_r; // Current gain reduction for Right/Side (linear)
-    float peak_in_linear_l; // Current peak input for L (linear)
-    float peak_in_linear_r; // Current peak input for R (linear)
-    float peak_out_linear_l; // Current peak output for L (linear)
-    float peak_out_linear_r; // Current peak output for R (linear)
+// Cascata di biquad (forma diretta II trasposta) su fino a 4 canali planari, per blocco.
+// Coefficienti e stati restano nei registri per tutto il blocco. 'in' e 'out' possono coincidere.
+static void biquad_lanes_process_block(BiquadLanes* const* stages, int num_stages,
+                                       const float* const* in, float* const* out, int num_lanes, uint32_t n) {
+    Lanes b0[BIQUAD_LANES_MAX_STAGES], b1[BIQUAD_LANES_MAX_STAGES], b2[BIQUAD_LANES_MAX_STAGES];
+    Lanes a1[BIQUAD_LANES_MAX_STAGES], a2[BIQUAD_LANES_MAX_STAGES];
+    Lanes z1[BIQUAD_LANES_MAX_STAGES], z2[BIQUAD_LANES_MAX_STAGES];
+    for (int st = 0; st < num_stages; ++st) {
+        b0[st] = lanes_load(stages[st]->b0);
+        b1[st] = lanes_load(stages[st]->b1);
+        b2[st] = lanes_load(stages[st]->b2);
+        a1[st] = lanes_load(stages[st]->a1);
+        a2[st] = lanes_load(stages[st]->a2);
+        z1[st] = lanes_load(stages[st]->z1);
+        z2[st] = lanes_load(stages[st]->z2);
+    }
 
+    for (uint32_t i = 0; i < n; ++i) {
+        Lanes x = lanes_gather(in, num_lanes, i);
+        for (int st = 0; st < num_stages; ++st) {
+            const Lanes y = lanes_add(lanes_mul(x, b0[st]), z1[st]);
+            z1[st] = lanes_sub(lanes_add(lanes_mul(x, b1[st]), z2[st]), lanes_mul(a1[st], y));
+            z2[st] = lanes_sub(lanes_mul(x, b2[st]), lanes_mul(a2[st], y));
+            x = y;
+        }
+        lanes_scatter_block(out, num_lanes, i, &x, 1);
+    }
 
-    // Variabili per smoothing dei meter
-    float gr_meter_alpha;
-    float output_meter_alpha;
-    float peak_meter_decay_alpha; // Per il decadimento dei picchi
-
-    // Buffer per oversampling (per blocco di input completo)
-    float* oversample_buffer_l;
-    float* oversample_buffer_r;
-    float* oversample_sidechain_l;
-    float* oversample_sidechain_r;
-    uint32_t max_oversample_buffer_size; // Max block size * OS_FACTOR
-
-    // Filtri per upsampling/downsampling (Biquad di 6° Ordine)
-    BiquadFilter upsample_lp_filters_l[NUM_BIQUADS_FOR_OS_FILTER];
-    BiquadFilter upsample_lp_filters_r[NUM_BIQUADS_FOR_OS_FILTER];
-    BiquadFilter downsample_lp_filters_l[NUM_BIQUADS_FOR_OS_FILTER];
-    BiquadFilter downsample_lp_filters_r[NUM_BIQUADS_FOR_OS_FILTER];
-
-    // Filtri sidechain (per canale, 6° ordine: 3 biquad in cascata)
-    BiquadFilter sc_hpf_filters_l[NUM_BIQUADS_FOR_SIDECHAIN_FILTER];
-    BiquadFilter sc_lpf_filters_l[NUM_BIQUADS_FOR_SIDECHAIN_FILTER];
-    BiquadFilter sc_hpf_filters_r[NUM_BIQUADS_FOR_SIDECHAIN_FILTER];
-    BiquadFilter sc_lpf_filters_r[NUM_BIQUADS_FOR_SIDECHAIN_FILTER];
+    for (int st = 0; st < num_stages; ++st) {
+        lanes_store(stages[st]->z1, z1[st]);
+        lanes_store(stages[st]->z2, z2[st]);
+    }
+}
 
-} Gua76;
 
-// Funzione di istanziazione del plugin
-static LV2_Handle
-instantiate(const LV2_Descriptor* descriptor,
-            double              samplerate,
-            const char* bundle_path,
-            const LV2_Feature* const* features) {
-    Gua76* self = (Gua76*)calloc(1, sizeof(Gua76));
-    if (!self) return NULL;
+// --- Gain Computer (dominio logaritmico, soft knee) ---
 
-    self->samplerate = samplerate;
-    self->oversampled_samplerate = samplerate * UPSAMPLE_FACTOR;
+// Costanti precalcolate per blocco a partire da ratio e knee
+typedef struct {
+    float threshold_db;
+    float slope;          // 1/ratio - 1 (negativo)
+    float knee_half_db;   // Metà della larghezza del knee
+    float knee_inv_twice; // 1 / (2 * knee), 0 con knee duro
+} GainComputerParams;
+
+static void gain_computer_setup(GainComputerParams* p, float threshold_db, float slope, float knee_db) {
+    p->threshold_db = threshold_db;
+    p->slope = slope;
+    p->knee_half_db = 0.5f * knee_db;
+    p->knee_inv_twice = (knee_db > 0.0f) ? 0.5f / knee_db : 0.0f;
+}
 
-    for (int i = 0; features[i]; ++i) {
-        if (!strcmp(features[i]->URI, LV2_LOG__log)) {
-            self->log = (LV2_Log_Log*)features[i]->data;
+#ifndef GUA76_REFERENCE_BUILD
+// log2/exp2 approssimati (gua76_fastmath.h), 4 campioni per volta. Il knee duro è una
+// specializzazione a compile time (niente parabola nel loop).
+template <bool SOFT_KNEE>
+static void gain_computer_lanes(const GainComputerParams* p, float* buf, uint32_t n) {
+    const Lanes zero = lanes_set1(0.0f);
+    const Lanes floor_level = lanes_set1(1e-9f);
+    const Lanes db_per_log2 = lanes_set1(FASTMATH_LOG2_TO_DB);
+    const Lanes log2_per_db = lanes_set1(FASTMATH_DB_TO_LOG2);
+    const Lanes threshold_db = lanes_set1(p->threshold_db);
+    const Lanes knee_half_db = lanes_set1(p->knee_half_db);
+    const Lanes knee_width = lanes_set1(2.0f * p->knee_half_db);
+    const Lanes knee_inv_twice = lanes_set1(p->knee_inv_twice);
+    const Lanes slope = lanes_set1(p->slope);
+    for (uint32_t i = 0; i < n; i += SIMD_LANES) {
+        // Coda: le corsie oltre 'n' lavorano su un envelope fittizio e non vengono riscritte
+        const uint32_t count = (n - i < SIMD_LANES) ? n - i : SIMD_LANES;
+        float tail[SIMD_LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float* src = buf + i;
+        if (count < SIMD_LANES) {
+            memcpy(tail, src, count * sizeof(float));
+            src = tail;
+        }
+        const Lanes level_db = lanes_mul(lanes_log2(lanes_max(lanes_load(src), floor_level)), db_per_log2);
+        const Lanes over = lanes_sub(level_db, threshold_db);
+        Lanes gr_db;
+        if (SOFT_KNEE) {
+            const Lanes k = lanes_min(lanes_max(lanes_add(over, knee_half_db), zero), knee_width);
+            gr_db = lanes_mul(slope, lanes_add(lanes_mul(lanes_mul(k, k), knee_inv_twice),
+                                               lanes_max(lanes_sub(over, knee_half_db), zero)));
+        } else {
+            gr_db = lanes_mul(slope, lanes_max(over, zero)); // Knee duro: stessa formula con W = 0
+        }
+        lanes_store(src, lanes_exp2(lanes_mul(gr_db, log2_per_db)));
+        if (count < SIMD_LANES) memcpy(buf + i, tail, count * sizeof(float));
+    }
+}
+#endif
+
+// Converte un buffer di envelope (lineari) nel gain lineare da applicare, in-place.
+// Soft knee quadratico: con over = livello - soglia e k = clamp(over + W/2, 0, W),
+// GR(dB) = slope * (k^2 / 2W + max(over - W/2, 0)). Sotto il knee vale 0, dentro è la parabola
+// che raccorda le due rette, sopra è slope * over. Niente divisioni né salti nel loop.
+static void gain_computer_process(const GainComputerParams* p, float* buf, uint32_t n) {
+#ifdef GUA76_REFERENCE_BUILD
+    // Riferimento: forma a tre rami del soft knee, con log10/pow
+    const float knee_width = 2.0f * p->knee_half_db;
+    for (uint32_t i = 0; i < n; ++i) {
+        const float level_db = 20.0f * log10f(fmaxf(buf[i], 1e-9f));
+        const float over = level_db - p->threshold_db;
+        float gr_db;
+        if (2.0f * over < -knee_width) {
+            gr_db = 0.0f;
+        } else if (knee_width > 0.0f && 2.0f * fabsf(over) <= knee_width) {
+            const float k = over + p->knee_half_db;
+            gr_db = p->slope * k * k / (2.0f * knee_width);
+        } else {
+            gr_db = p->slope * over;
         }
+        buf[i] = powf(10.0f, gr_db / 20.0f);
     }
-    lv2_log_logger_init(&self->logger, NULL, self->log);
+#else
+    if (p->knee_half_db > 0.0f) gain_computer_lanes<true>(p, buf, n);
+    else gain_computer_lanes<false>(p, buf, n);
+#endif
+}
 
-    // Inizializzazione variabili di stato del compressore
-    self->envelope_l = 0.0f;
-    self->envelope_r = 0.0f;
-    self->current_gr_linear_l = 1.0f; // Inizia senza gain reduction (0dB)
-    self->current_gr_linear_r = 1.0f;
-    self->peak_in_linear_l = db_to_linear(-90.0f); // Inizializza i meter a -90dB
-    self->peak_in_linear_r = db_to_linear(-90.0f);
-    self->peak_out_linear_l = db_to_linear(-90.0f);
-    self->peak_out_linear_r = db_to_linear(-90.0f);
 
+// --- Kernel dei passi 3a/3b specializzati per modalità ---
+// Le modalità che non cambiano dentro un chunk (rampa dell'input/output gain, All-Button, quali
+// meter misurare) sono parametri di template: ogni combinazione è un loop senza salti sui flag.
+// process_chunk sceglie l'istanza una volta per chunk dalle tabelle GR_SMOOTH_KERNELS e
+// GAIN_APPLY_KERNELS.
+
+// Curva di apply_soft_clip con u = input_scale * |x|: f(x) = sign(x) * g(u), g(u) = clamp(u - cubic u^3, -1, 1).
+// g è polinomiale a tratti: tratti cubici e tratti costanti (+1 sul clip, -1 oltre lo zero di
+// u - cubic u^3 + 1, dove la cubica ripiega). Su ogni tratto, con p = 1 (cubico) o 0 (costante v):
+//   g  = p (u - c u^3) + v
+//   G1 = p (u^2/2 - c u^4/4) + v u + a               (primitiva di g)
+//   G2 = p (u^3/6 - c u^5/20) + v u^2/2 + a u + b    (primitiva di G1)
+// con a e b scelti per la continuità. Le antiderivate di f per l'ADAA sono
+// F1(x) = G1(u) / input_scale (pari) e F2(x) = sign(x) G2(u) / input_scale^2 (dispari).
+#define ADAA_MAX_SEGMENTS 4
+typedef struct {
+    double start; // Inizio del tratto (in u)
+    double p, v;  // Tratto cubico (p = 1, v = 0) o costante (p = 0, v = +-1)
+    double a, b;  // Costanti di integrazione di G1 e G2
+} AdaaSegment;
 
-    // Calcolo coefficienti di smoothing per i meter
-    self->gr_meter_alpha = 1.0f - expf(-1.0f / (self->samplerate * (GR_METER_SMOOTH_MS / 1000.0f)));
-    self->output_meter_alpha = 1.0f - expf(-1.0f / (self->samplerate * (OUTPUT_METER_SMOOTH_MS / 1000.0f)));
-    self->peak_meter_decay_alpha = 1.0f - expf(-1.0f / (self->samplerate * (PEAK_METER_DECAY_MS / 1000.0f)));
+// Costanti della saturazione di apply_soft_clip per un valore di drive, calcolate per blocco
+typedef struct {
+    float drive_amount;
+    float input_scale; // 1 + drive / 2
+    float cubic;       // drive / 10
+    int   num_segments;
+    AdaaSegment segments[ADAA_MAX_SEGMENTS];
+    double inv_scale, inv_scale_sq; // 1 / input_scale e il suo quadrato (antiderivate in x)
+} SoftClipParams;
+
+static inline double adaa_p1(double c, double u) { return u * u * (0.5 - c * u * u * 0.25); }
+static inline double adaa_p2(double c, double u) { return u * u * u * (1.0 / 6.0 - c * u * u * 0.05); }
+
+// Radice di u - c u^3 + s in [lo, hi] (dove cambia segno), per bisezione fino alla precisione del double
+static double soft_clip_root(double c, double s, double lo, double hi) {
+    const double f_lo = lo - c * lo * lo * lo + s;
+    for (int i = 0; i < 200; ++i) {
+        const double mid = 0.5 * (lo + hi);
+        if (mid <= lo || mid >= hi) break;
+        const double f_mid = mid - c * mid * mid * mid + s;
+        if ((f_mid < 0.0) == (f_lo < 0.0)) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+static void soft_clip_add_segment(SoftClipParams* p, double start, double poly, double v) {
+    const double c = (double)p->cubic;
+    AdaaSegment* seg = &p->segments[p->num_segments];
+    seg->start = start;
+    seg->p = poly;
+    seg->v = v;
+    seg->a = 0.0;
+    seg->b = 0.0;
+    if (p->num_segments > 0) { // G1 e G2 continue all'inizio del tratto
+        const AdaaSegment* prev = seg - 1;
+        const double g1 = prev->p * adaa_p1(c, start) + prev->v * start + prev->a;
+        const double g2 = prev->p * adaa_p2(c, start) + prev->v * start * start * 0.5 + prev->a * start + prev->b;
+        seg->a = g1 - (poly * adaa_p1(c, start) + v * start);
+        seg->b = g2 - (poly * adaa_p2(c, start) + v * start * start * 0.5 + seg->a * start);
+    }
+    p->num_segments++;
+}
 
-    // Inizializzazione filtri biquad per oversampling/downsampling e sidechain
-    for(int i = 0; i < NUM_BIQUADS_FOR_OS_FILTER; ++i) { // Per i filtri OS (6° ordine)
-        biquad_init(&self->upsample_lp_filters_l[i]);
-        biquad_init(&self->upsample_lp_filters_r[i]);
-        biquad_init(&self->downsample_lp_filters_l[i]);
-        biquad_init(&self->downsample_lp_filters_r[i]);
+static void soft_clip_setup(SoftClipParams* p, float drive_amount) {
+    p->drive_amount = drive_amount;
+    p->input_scale = 1.0f + drive_amount * 0.5f;
+    p->cubic = drive_amount * 0.1f;
+    p->inv_scale = 1.0 / (double)p->input_scale;
+    p->inv_scale_sq = p->inv_scale * p->inv_scale;
+
+    // Tratti della curva per l'ADAA
+    const double c = (double)p->cubic;
+    p->num_segments = 0;
+    soft_clip_add_segment(p, 0.0, 1.0, 0.0);
+    if (c <= 0.0) {
+        soft_clip_add_segment(p, 1.0, 0.0, 1.0); // Solo clip
+        return;
     }
-    for(int i = 0; i < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++i) { // Per i filtri sidechain (6° ordine)
-        biquad_init(&self->sc_hpf_filters_l[i]);
-        biquad_init(&self->sc_lpf_filters_l[i]);
-        biquad_init(&self->sc_hpf_filters_r[i]);
-        biquad_init(&self->sc_lpf_filters_r[i]);
+    // La cubica sale fino a u_peak, poi scende e incrocia -1 in u_fold
+    const double u_peak = 1.0 / sqrt(3.0 * c);
+    double hi = 2.0 * u_peak;
+    while (hi - c * hi * hi * hi + 1.0 > 0.0) hi *= 2.0;
+    const double u_fold = soft_clip_root(c, 1.0, u_peak, hi);
+    if (u_peak - c * u_peak * u_peak * u_peak > 1.0) { // Il massimo supera 1: tratto di clip a +1
+        soft_clip_add_segment(p, soft_clip_root(c, -1.0, 0.0, u_peak), 0.0, 1.0);
+        soft_clip_add_segment(p, soft_clip_root(c, -1.0, u_peak, u_fold), 1.0, 0.0);
     }
+    soft_clip_add_segment(p, u_fold, 0.0, -1.0);
+}
 
+// Tratto della curva che contiene u (u >= 0)
+static inline const AdaaSegment* soft_clip_segment(const SoftClipParams* p, double u) {
+    int j = p->num_segments - 1;
+    while (j > 0 && u < p->segments[j].start) --j;
+    return &p->segments[j];
+}
 
-    // Alloca buffer per oversampling (max block size * OS_FACTOR)
-    // LV2 hosts possono passare sample_count fino a 4096 o più, quindi dimensioniamo di conseguenza
-    self->max_oversample_buffer_size = 4096 * UPSAMPLE_FACTOR;
-    self->oversample_buffer_l = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
-    self->oversample_buffer_r = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
-    self->oversample_sidechain_l = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
-    self->oversample_sidechain_r = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
+// f(x), F1(x) e F2(x) della curva di saturazione, in double (le differenze divise dell'ADAA
+// sottraggono valori vicini delle antiderivate)
+static inline double soft_clip_f(const SoftClipParams* p, double x) {
+    const double u = (double)p->input_scale * fabs(x);
+    const AdaaSegment* seg = soft_clip_segment(p, u);
+    const double g = seg->p * (u - (double)p->cubic * u * u * u) + seg->v;
+    return (x < 0.0) ? -g : g;
+}
 
+static inline double soft_clip_f1(const SoftClipParams* p, double x) {
+    const double k = (double)p->input_scale;
+    const double u = k * fabs(x);
+    const AdaaSegment* seg = soft_clip_segment(p, u);
+    return (seg->p * adaa_p1((double)p->cubic, u) + seg->v * u + seg->a) * p->inv_scale;
+}
 
-    if (!self->oversample_buffer_l || !self->oversample_buffer_r || !self->oversample_sidechain_l || !self->oversample_sidechain_r) {
-        free(self->oversample_buffer_l);
-        free(self->oversample_buffer_r);
-        free(self->oversample_sidechain_l);
-        free(self->oversample_sidechain_r);
-        free(self);
-        return NULL;
-    }
+static inline double soft_clip_f2(const SoftClipParams* p, double x) {
+    const double k = (double)p->input_scale;
+    const double u = k * fabs(x);
+    const AdaaSegment* seg = soft_clip_segment(p, u);
+    const double g2 = seg->p * adaa_p2((double)p->cubic, u) + seg->v * u * u * 0.5 + seg->a * u + seg->b;
+    return ((x < 0.0) ? -g2 : g2) * p->inv_scale_sq;
+}
+
+// Stato dell'ADAA di una curva su un canale: gli ultimi due ingressi
+typedef struct {
+    double x1, x2;
+} AdaaState;
 
-    return (LV2_Handle)self;
+// Differenza divisa (F2(x0) - F2(x1)) / (x0 - x1), che tende a F1 nel punto medio
+static inline double adaa2_divided(const SoftClipParams* p, double x0, double x1, double f2_x0, double f2_x1) {
+    const double dx = x0 - x1;
+    return (fabs(dx) > ADAA_TOLERANCE) ? (f2_x0 - f2_x1) / dx : soft_clip_f1(p, 0.5 * (x0 + x1));
 }
 
-// Funzione per connettere le porte
-static void
-connect_port(LV2_Handle instance, uint32_t port, void* data_location) {
-    Gua76* self = (Gua76*)instance;
-
-    switch ((Gua76PortIndex)port) {
-        case GUA76_AUDIO_IN_L:          self->audio_in_l_ptr = (const float*)data_location; break;
-        case GUA76_AUDIO_IN_R:          self->audio_in_r_ptr = (const float*)data_location; break;
-        case GUA76_AUDIO_OUT_L:         self->audio_out_l_ptr = (float*)data_location; break;
-        case GUA76_AUDIO_OUT_R:         self->audio_out_r_ptr = (float*)data_location; break;
-
-        case GUA76_SIDECHAIN_IN_L:      self->sidechain_in_l_ptr = (const float*)data_location; break;
-        case GUA76_SIDECHAIN_IN_R:      self->sidechain_in_r_ptr = (const float*)data_location; break;
-
-        case GUA76_INPUT:               self->input_ptr = (float*)data_location; break;
-        case GUA76_OUTPUT:              self->output_ptr = (float*)data_location; break;
-        case GUA76_ATTACK:              self->attack_ptr = (float*)data_location; break;
-        case GUA76_RELEASE:             self->release_ptr = (float*)data_location; break;
-        case GUA76_RATIO:               self->ratio_ptr = (float*)data_location; break;
-        case GUA76_METER_MODE:          self->meter_mode_ptr = (float*)data_location; break;
-        case GUA76_BYPASS:              self->bypass_ptr = (float*)data_location; break;
-        case GUA76_DRIVE_SATURATION:    self->drive_saturation_ptr = (float*)data_location; break;
-        case GUA76_OVERSAMPLING:        self->oversampling_ptr = (float*)data_location; break;
-        case GUA76_SIDECHAIN_HPF_ON:    self->sidechain_hpf_on_ptr = (float*)data_location; break;
-        case GUA76_SIDECHAIN_HPF_FREQ:  self->sidechain_hpf_freq_ptr = (float*)data_location; break;
-        case GUA77_SIDECHAIN_HPF_Q:     self->sidechain_hpf_q_ptr = (float*)data_location; break; // Nuovo
-        case GUA76_SIDECHAIN_LPF_ON:    self->sidechain_lpf_on_ptr = (float*)data_location; break;
-        case GUA76_SIDECHAIN_LPF_FREQ:  self->sidechain_lpf_freq_ptr = (float*)data_location; break;
-        case GUA76_SIDECHAIN_LISTEN:    self->sidechain_listen_ptr = (float*)data_location; break;
-        case GUA76_MIDSIDE_MODE:        self->midside_mode_ptr = (float*)data_location; break; // Nuovo
-        case GUA76_MIDSIDE_LINK:        self->midside_link_ptr = (float*)data_location; break; // Nuovo
-        case GUA76_PAD_10DB:            self->pad_10db_ptr = (float*)data_location; break;     // Nuovo
+// ADAA di ordine 2 con x0 ~ x2: forma ben condizionata attorno al punto medio
+static double adaa2_fallback(const SoftClipParams* p, double x0, double x1, double x2, double f2_x1) {
+    const double x_bar = 0.5 * (x0 + x2);
+    const double delta = x_bar - x1;
+    return (fabs(delta) > ADAA_TOLERANCE)
+        ? 2.0 / delta * (soft_clip_f1(p, x_bar) + (f2_x1 - soft_clip_f2(p, x_bar)) / delta)
+        : soft_clip_f(p, 0.5 * (x_bar + x1));
+}
 
-        case GUA76_PEAK_GR:             self->peak_gr_ptr = (float*)data_location; break;
-        case GUA76_PEAK_IN_L:           self->peak_in_l_ptr = (float*)data_location; break;
-        case GUA76_PEAK_IN_R:           self->peak_in_r_ptr = (float*)data_location; break;
-        case GUA76_PEAK_OUT_L:          self->peak_out_l_ptr = (float*)data_location; break;
-        case GUA76_PEAK_OUT_R:          self->peak_out_r_ptr = (float*)data_location; break;
+#ifdef GUA76_REFERENCE_BUILD
+// Curva ADAA su un buffer (ordine 1 o 2), 'x' e 'y' possono coincidere. Le antiderivate
+// dell'ultimo ingresso vengono ricalcolate all'inizio: il drive può cambiare tra un blocco e l'altro.
+template <int ORDER>
+static void soft_clip_adaa(const SoftClipParams* p, AdaaState* state, const float* x, float* y, uint32_t n) {
+    double x1 = state->x1;
+    double x2 = state->x2;
+    if (ORDER == 1) {
+        double f1_x1 = soft_clip_f1(p, x1);
+        for (uint32_t i = 0; i < n; ++i) {
+            const double x0 = (double)x[i];
+            const double f1_x0 = soft_clip_f1(p, x0);
+            const double dx = x0 - x1;
+            y[i] = (float)((fabs(dx) > ADAA_TOLERANCE) ? (f1_x0 - f1_x1) / dx : soft_clip_f(p, 0.5 * (x0 + x1)));
+            x2 = x1;
+            x1 = x0;
+            f1_x1 = f1_x0;
+        }
+    } else {
+        double f2_x1 = soft_clip_f2(p, x1);
+        double d12 = adaa2_divided(p, x1, x2, f2_x1, soft_clip_f2(p, x2));
+        for (uint32_t i = 0; i < n; ++i) {
+            const double x0 = (double)x[i];
+            const double f2_x0 = soft_clip_f2(p, x0);
+            const double d01 = adaa2_divided(p, x0, x1, f2_x0, f2_x1);
+            y[i] = (float)((fabs(x0 - x2) > ADAA_TOLERANCE) ? 2.0 * (d01 - d12) / (x0 - x2)
+                                                            : adaa2_fallback(p, x0, x1, x2, f2_x1));
+            x2 = x1;
+            x1 = x0;
+            f2_x1 = f2_x0;
+            d12 = d01;
+        }
+    }
+    state->x1 = x1;
+    state->x2 = x2;
+}
+#else
+// --- Curva ADAA a blocchi, su DLanes ---
+// Stesse operazioni, nello stesso ordine, di soft_clip_f/f1/f2 e della versione scalare (build di
+// riferimento), ma per passate sull'intero buffer: prima le antiderivate di tutti gli ingressi,
+// poi le differenze divise. Il tratto della curva di ogni corsia si sceglie con i confronti
+// (nessun salto che dipende dal segnale); i rari casi mal condizionati di ordine 2 vengono
+// ricalcolati in scalare.
+
+// Coefficienti del tratto di ogni corsia (i tratti sono in ordine di inizio crescente)
+typedef struct {
+    DLanes poly, v, a, b;
+} DLanesSegment;
+
+static inline DLanesSegment dlanes_soft_clip_segment(const SoftClipParams* p, DLanes u) {
+    const AdaaSegment* seg = &p->segments[0];
+    DLanesSegment r = { dlanes_set1(seg->p), dlanes_set1(seg->v), dlanes_set1(seg->a), dlanes_set1(seg->b) };
+    for (int j = 1; j < p->num_segments; ++j) {
+        seg = &p->segments[j];
+        const DMask m = dlanes_ge(u, dlanes_set1(seg->start));
+        r.poly = dlanes_select(m, dlanes_set1(seg->p), r.poly);
+        r.v = dlanes_select(m, dlanes_set1(seg->v), r.v);
+        r.a = dlanes_select(m, dlanes_set1(seg->a), r.a);
+        r.b = dlanes_select(m, dlanes_set1(seg->b), r.b);
     }
+    return r;
 }
 
-// Funzione di attivazione (resettare lo stato del plugin)
-static void
-activate(LV2_Handle instance) {
-    Gua76* self = (Gua76*)instance;
-    self->envelope_l = 0.0f;
-    self->envelope_r = 0.0f;
-    self->current_gr_linear_l = 1.0f;
-    self->current_gr_linear_r = 1.0f;
-    self->peak_in_linear_l = db_to_linear(-90.0f);
-    self->peak_in_linear_r = db_to_linear(-90.0f);
-    self->peak_out_linear_l = db_to_linear(-90.0f);
-    self->peak_out_linear_r = db_to_linear(-90.0f);
+static inline DLanes dlanes_soft_clip_f(const SoftClipParams* p, DLanes x) {
+    const DLanes c = dlanes_set1((double)p->cubic);
+    const DLanes u = dlanes_mul(dlanes_set1((double)p->input_scale), dlanes_abs(x));
+    const DLanesSegment seg = dlanes_soft_clip_segment(p, u);
+    const DLanes cubic = dlanes_mul(dlanes_mul(dlanes_mul(c, u), u), u);
+    const DLanes g = dlanes_add(dlanes_mul(seg.poly, dlanes_sub(u, cubic)), seg.v);
+    return dlanes_select(dlanes_lt(x, dlanes_set1(0.0)), dlanes_neg(g), g);
+}
 
+static inline DLanes dlanes_soft_clip_f1(const SoftClipParams* p, DLanes x) {
+    const DLanes k = dlanes_set1((double)p->input_scale);
+    const DLanes c = dlanes_set1((double)p->cubic);
+    const DLanes u = dlanes_mul(k, dlanes_abs(x));
+    const DLanesSegment seg = dlanes_soft_clip_segment(p, u);
+    const DLanes u2 = dlanes_mul(u, u);
+    // adaa_p1: u^2 (1/2 - c u^2 / 4)
+    const DLanes p1 = dlanes_mul(u2, dlanes_sub(dlanes_set1(0.5),
+                                                dlanes_mul(dlanes_mul(dlanes_mul(c, u), u), dlanes_set1(0.25))));
+    const DLanes g1 = dlanes_add(dlanes_add(dlanes_mul(seg.poly, p1), dlanes_mul(seg.v, u)), seg.a);
+    return dlanes_mul(g1, dlanes_set1(p->inv_scale));
+}
 
-    *self->peak_gr_ptr = 0.0f;
-    *self->peak_in_l_ptr = -90.0f;
-    *self->peak_in_r_ptr = -90.0f;
-    *self->peak_out_l_ptr = -90.0f;
-    *self->peak_out_r_ptr = -90.0f;
+static inline DLanes dlanes_soft_clip_f2(const SoftClipParams* p, DLanes x) {
+    const DLanes k = dlanes_set1((double)p->input_scale);
+    const DLanes c = dlanes_set1((double)p->cubic);
+    const DLanes u = dlanes_mul(k, dlanes_abs(x));
+    const DLanesSegment seg = dlanes_soft_clip_segment(p, u);
+    // adaa_p2: u^3 (1/6 - c u^2 / 20)
+    const DLanes p2 = dlanes_mul(dlanes_mul(dlanes_mul(u, u), u),
+                                 dlanes_sub(dlanes_set1(1.0 / 6.0),
+                                            dlanes_mul(dlanes_mul(dlanes_mul(c, u), u), dlanes_set1(0.05))));
+    DLanes g2 = dlanes_mul(seg.poly, p2);
+    g2 = dlanes_add(g2, dlanes_mul(dlanes_mul(dlanes_mul(seg.v, u), u), dlanes_set1(0.5)));
+    g2 = dlanes_add(g2, dlanes_mul(seg.a, u));
+    g2 = dlanes_add(g2, seg.b);
+    g2 = dlanes_select(dlanes_lt(x, dlanes_set1(0.0)), dlanes_neg(g2), g2);
+    return dlanes_mul(g2, dlanes_set1(p->inv_scale_sq));
+}
+
+// Differenza divisa (F(x0) - F(x1)) / (x0 - x1); 'well_conditioned' vale dove |x0 - x1| > ADAA_TOLERANCE
+static inline DLanes dlanes_adaa_divided(DLanes x0, DLanes x1, DLanes f_x0, DLanes f_x1, DMask* well_conditioned) {
+    const DLanes dx = dlanes_sub(x0, x1);
+    *well_conditioned = dlanes_gt(dlanes_abs(dx), dlanes_set1(ADAA_TOLERANCE));
+    return dlanes_div(dlanes_sub(f_x0, f_x1), dx);
+}
 
+// Curva ADAA su un buffer (ordine 1 o 2), 'x' e 'y' possono coincidere. 'n' <= PIPELINE_BLOCK_OS_SAMPLES.
+template <int ORDER>
+static void soft_clip_adaa(const SoftClipParams* p, AdaaState* state, const float* x, float* y, uint32_t n) {
+    // Ingressi in double preceduti dai due precedenti: xs[0] = x2, xs[1] = x1, xs[2 + i] = x[i].
+    // Il fondo viene completato con l'ultimo ingresso (le uscite in più vengono scartate).
+    double xs[PIPELINE_BLOCK_OS_SAMPLES + 2 * DLANES + 2];
+    double anti[PIPELINE_BLOCK_OS_SAMPLES + 2 * DLANES + 2]; // Antiderivata di ordine ORDER di xs
+    double out[PIPELINE_BLOCK_OS_SAMPLES + DLANES];
+    const uint32_t padded = (n + DLANES - 1) / DLANES * DLANES;
+    const uint32_t count = padded + DLANES + 2;
+    xs[0] = state->x2;
+    xs[1] = state->x1;
+    for (uint32_t i = 0; i < n; ++i) xs[2 + i] = (double)x[i];
+    for (uint32_t i = 2 + n; i < count; ++i) xs[i] = xs[i - 1];
+
+    for (uint32_t i = 0; i < count; i += DLANES) {
+        const DLanes v = dlanes_load(xs + i);
+        dlanes_store(anti + i, (ORDER == 1) ? dlanes_soft_clip_f1(p, v) : dlanes_soft_clip_f2(p, v));
+    }
 
-    // Reinitalizza stati interni dei filtri biquad (cruciale per prevenire clicks e rumori)
-    for(int i = 0; i < NUM_BIQUADS_FOR_OS_FILTER; ++i) { // Per i filtri OS
-        biquad_init(&self->upsample_lp_filters_l[i]);
-        biquad_init(&self->upsample_lp_filters_r[i]);
-        biquad_init(&self->downsample_lp_filters_l[i]);
-        biquad_init(&self->downsample_lp_filters_r[i]);
+    if (ORDER == 1) {
+        // y[i] = (F1(x[i]) - F1(x[i - 1])) / (x[i] - x[i - 1]), curva nel punto medio se troppo vicini
+        for (uint32_t i = 0; i < padded; i += DLANES) {
+            const DLanes x0 = dlanes_load(xs + 2 + i);
+            const DLanes x1 = dlanes_load(xs + 1 + i);
+            DMask ok;
+            DLanes r = dlanes_adaa_divided(x0, x1, dlanes_load(anti + 2 + i), dlanes_load(anti + 1 + i), &ok);
+            if (dlanes_mask_bits(ok) != (1 << DLANES) - 1) {
+                const DLanes mid = dlanes_mul(dlanes_set1(0.5), dlanes_add(x0, x1));
+                r = dlanes_select(ok, r, dlanes_soft_clip_f(p, mid));
+            }
+            dlanes_store(out + i, r);
+        }
+    } else {
+        // d[j] = (F2(xs[j + 1]) - F2(xs[j])) / (xs[j + 1] - xs[j]), F1 nel punto medio se troppo vicini
+        double d[PIPELINE_BLOCK_OS_SAMPLES + 2 * DLANES];
+        for (uint32_t j = 0; j < padded + DLANES; j += DLANES) {
+            const DLanes x0 = dlanes_load(xs + 1 + j);
+            const DLanes x1 = dlanes_load(xs + j);
+            DMask ok;
+            DLanes r = dlanes_adaa_divided(x0, x1, dlanes_load(anti + 1 + j), dlanes_load(anti + j), &ok);
+            if (dlanes_mask_bits(ok) != (1 << DLANES) - 1) {
+                const DLanes mid = dlanes_mul(dlanes_set1(0.5), dlanes_add(x0, x1));
+                r = dlanes_select(ok, r, dlanes_soft_clip_f1(p, mid));
+            }
+            dlanes_store(d + j, r);
+        }
+        // y[i] = 2 (d[i + 1] - d[i]) / (x[i] - x[i - 2]), forma attorno al punto medio se x[i] ~ x[i - 2]
+        for (uint32_t i = 0; i < padded; i += DLANES) {
+            const DLanes x0 = dlanes_load(xs + 2 + i);
+            const DLanes x2 = dlanes_load(xs + i);
+            const DLanes dx = dlanes_sub(x0, x2);
+            const DLanes r = dlanes_div(dlanes_mul(dlanes_set1(2.0), dlanes_sub(dlanes_load(d + 1 + i), dlanes_load(d + i))), dx);
+            dlanes_store(out + i, r);
+            const int ok = dlanes_mask_bits(dlanes_gt(dlanes_abs(dx), dlanes_set1(ADAA_TOLERANCE)));
+            for (int c = 0; c < DLANES; ++c) {
+                if (!(ok & (1 << c))) {
+                    const uint32_t k = i + (uint32_t)c;
+                    out[k] = adaa2_fallback(p, xs[2 + k], xs[1 + k], xs[k], anti[1 + k]);
+                }
+            }
+        }
     }
-    for(int i = 0; i < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++i) { // Per i filtri sidechain
-        biquad_init(&self->sc_hpf_filters_l[i]);
-        biquad_init(&self->sc_lpf_filters_l[i]);
-        biquad_init(&self->sc_hpf_filters_r[i]);
-        biquad_init(&self->sc_lpf_filters_r[i]);
+    for (uint32_t i = 0; i < n; ++i) y[i] = (float)out[i];
+    state->x1 = xs[1 + n];
+    state->x2 = xs[n];
+}
+#endif
+
+#ifndef GUA76_REFERENCE_BUILD
+// apply_soft_clip su 4 campioni, senza salti: stesse operazioni nello stesso ordine
+static inline Lanes lanes_soft_clip(Lanes x, Lanes input_scale, Lanes cubic) {
+    const Lanes a = lanes_mul(lanes_abs(x), input_scale);
+    const Lanes saturated = lanes_sub(a, lanes_mul(lanes_mul(lanes_mul(a, a), a), cubic));
+    return lanes_flip_sign(lanes_min(lanes_max(saturated, lanes_set1(-1.0f)), lanes_set1(1.0f)), x);
+}
+#endif
+
+// Passo 3a per un detector: smoothing della GR (ricorsione seriale per campione) combinata con
+// l'input/output gain. 'gain' entra come gain del gain computer ed esce come gain complessivo.
+// La GR minima/massima di ogni sotto-blocco di 'meter_block' campioni viene combinata con
+// gr_min/gr_max (già inizializzati dal chiamante).
+typedef void (*GrSmoothKernel)(float* gain, const float* alpha, uint32_t n, uint32_t meter_block,
+                               float* gr_linear, float* io_gain_linear, float io_gain_target, float gain_alpha,
+                               float* gr_min, float* gr_max);
+
+template <bool GAIN_RAMPING>
+static void gr_smooth_kernel(float* gain, const float* alpha, uint32_t n, uint32_t meter_block,
+                             float* gr_linear_state, float* io_gain_state, float io_gain_target, float gain_alpha,
+                             float* gr_min, float* gr_max) {
+    float gr_linear = *gr_linear_state;
+    float io_gain_linear = *io_gain_state;
+    for (uint32_t start = 0, k = 0; start < n; start += meter_block, ++k) {
+        const uint32_t end = (n - start < meter_block) ? n : start + meter_block;
+        float block_min = gr_min[k];
+        float block_max = gr_max[k];
+        for (uint32_t i = start; i < end; ++i) {
+            // Smooth la Gain Reduction per evitare zippering
+            gr_linear = (gr_linear * (1.0f - alpha[i])) + (gain[i] * alpha[i]);
+            if (GAIN_RAMPING) io_gain_linear += (io_gain_target - io_gain_linear) * gain_alpha;
+            gain[i] = io_gain_linear * gr_linear;
+            block_min = fast_min(block_min, gr_linear);
+            block_max = fast_max(block_max, gr_linear);
+        }
+        gr_min[k] = block_min;
+        gr_max[k] = block_max;
     }
+    *gr_linear_state = gr_linear;
+    *io_gain_state = io_gain_linear;
+}
 
-    // Ricalcola i coefficienti dei filtri anti-aliasing (solo una volta all'attivazione)
-    // Frequenza di taglio: Nyquist della frequenza originale (samplerate / 2) divisa per il fattore di oversampling
-    float os_filter_freq = (float)(self->samplerate / 2.0 / UPSAMPLE_FACTOR);
-    for(int i = 0; i < NUM_BIQUADS_FOR_OS_FILTER; ++i) {
-        calculate_biquad_coeffs(&self->upsample_lp_filters_l[i], self->oversampled_samplerate, os_filter_freq, OS_FILTER_Q, 0); // LP
-        calculate_biquad_coeffs(&self->upsample_lp_filters_r[i], self->oversampled_samplerate, os_filter_freq, OS_FILTER_Q, 0); // LP
-        calculate_biquad_coeffs(&self->downsample_lp_filters_l[i], self->oversampled_samplerate, os_filter_freq, OS_FILTER_Q, 0); // LP
-        calculate_biquad_coeffs(&self->downsample_lp_filters_r[i], self->oversampled_samplerate, os_filter_freq, OS_FILTER_Q, 0); // LP
+static const GrSmoothKernel GR_SMOOTH_KERNELS[2] = { gr_smooth_kernel<false>, gr_smooth_kernel<true> };
+
+// Passo 3b per un canale: gain e saturazione (più quella aggiuntiva in All-Button mode), con i
+// massimi di |ingresso| e |uscita| per sotto-blocco di 'meter_block' campioni letti mentre i
+// dati sono nei registri. 'src' e 'dst' possono coincidere.
+// 'adaa' è lo stato ADAA del canale (curva finale, curva All-Button), usato solo dai kernel ADAA.
+typedef void (*GainApplyKernel)(const SoftClipParams* clip, const SoftClipParams* all_button_clip, AdaaState* adaa,
+                                const float* src, const float* gain, float* dst, uint32_t n, uint32_t meter_block,
+                                float* in_peaks, float* out_peaks);
+
+template <bool ALL_BUTTON, bool MEASURE_IN, bool MEASURE_OUT>
+static void gain_apply_kernel(const SoftClipParams* clip, const SoftClipParams* all_button_clip, AdaaState* adaa,
+                              const float* src, const float* gain, float* dst, uint32_t n, uint32_t meter_block,
+                              float* in_peaks, float* out_peaks) {
+    (void)adaa;
+#ifdef GUA76_REFERENCE_BUILD
+    // Riferimento: apply_soft_clip per campione, massimi con un secondo passaggio
+    for (uint32_t start = 0, k = 0; start < n; start += meter_block, ++k) {
+        const uint32_t end = (n - start < meter_block) ? n : start + meter_block;
+        for (uint32_t i = start; i < end; ++i) {
+            float current_sample = src[i];
+            if (ALL_BUTTON) {
+                // Aggiungi un po' di distorsione armonica aggiuntiva in All-Button mode
+                current_sample = apply_soft_clip(current_sample, all_button_clip->drive_amount); // Più drive
+            }
+            // Applica l'input gain, la gain reduction, e l'output gain, poi il soft clipping
+            // finale (per il "carattere" 1176)
+            dst[i] = apply_soft_clip(current_sample * gain[i], clip->drive_amount);
+        }
+        if (MEASURE_IN) in_peaks[k] = peak_abs(src + start, end - start);
+        if (MEASURE_OUT) out_peaks[k] = peak_abs(dst + start, end - start);
     }
+#else
+    const Lanes input_scale = lanes_set1(clip->input_scale);
+    const Lanes cubic = lanes_set1(clip->cubic);
+    const Lanes all_input_scale = lanes_set1(all_button_clip->input_scale);
+    const Lanes all_cubic = lanes_set1(all_button_clip->cubic);
+    for (uint32_t start = 0, k = 0; start < n; start += meter_block, ++k) {
+        const uint32_t end = (n - start < meter_block) ? n : start + meter_block;
+        Lanes peak_in = lanes_set1(0.0f);
+        Lanes peak_out = lanes_set1(0.0f);
+        for (uint32_t i = start; i < end; i += SIMD_LANES) {
+            // Coda (solo nell'ultimo sotto-blocco): corsie a zero, che non cambiano i massimi
+            const uint32_t count = (end - i < SIMD_LANES) ? end - i : SIMD_LANES;
+            float tail_x[SIMD_LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float tail_g[SIMD_LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            const float* x_ptr = src + i;
+            const float* g_ptr = gain + i;
+            if (count < SIMD_LANES) {
+                memcpy(tail_x, x_ptr, count * sizeof(float));
+                memcpy(tail_g, g_ptr, count * sizeof(float));
+                x_ptr = tail_x;
+                g_ptr = tail_g;
+            }
+            Lanes x = lanes_load(x_ptr);
+            if (MEASURE_IN) peak_in = lanes_max(peak_in, lanes_abs(x));
+            if (ALL_BUTTON) x = lanes_soft_clip(x, all_input_scale, all_cubic);
+            const Lanes y = lanes_soft_clip(lanes_mul(x, lanes_load(g_ptr)), input_scale, cubic);
+            if (MEASURE_OUT) peak_out = lanes_max(peak_out, lanes_abs(y));
+            if (count < SIMD_LANES) {
+                lanes_store(tail_x, y);
+                memcpy(dst + i, tail_x, count * sizeof(float));
+            } else {
+                lanes_store(dst + i, y);
+            }
+        }
+        if (MEASURE_IN) in_peaks[k] = lanes_hmax(peak_in);
+        if (MEASURE_OUT) out_peaks[k] = lanes_hmax(peak_out);
+    }
+#endif
 }
 
+// Variante ADAA (ordine 1 o 2) del passo 3b: la curva (e quella di All-Button) su ogni
+// sotto-blocco dei meter, con soft_clip_adaa (a blocchi su DLanes, scalare nella build di riferimento).
+template <int ORDER, bool ALL_BUTTON, bool MEASURE_IN, bool MEASURE_OUT>
+static void gain_apply_adaa_kernel(const SoftClipParams* clip, const SoftClipParams* all_button_clip, AdaaState* adaa,
+                                   const float* src, const float* gain, float* dst, uint32_t n, uint32_t meter_block,
+                                   float* in_peaks, float* out_peaks) {
+    float tmp[PIPELINE_BLOCK_OS_SAMPLES]; // meter_block <= METER_BLOCK * MAX_UPSAMPLE_FACTOR
+    for (uint32_t start = 0, k = 0; start < n; start += meter_block, ++k) {
+        const uint32_t len = (n - start < meter_block) ? n - start : meter_block;
+        if (MEASURE_IN) in_peaks[k] = peak_abs(src + start, len);
+        const float* x = src + start;
+        if (ALL_BUTTON) {
+            soft_clip_adaa<ORDER>(all_button_clip, &adaa[1], x, tmp, len);
+            x = tmp;
+        }
+        for (uint32_t i = 0; i < len; ++i) tmp[i] = x[i] * gain[start + i];
+        soft_clip_adaa<ORDER>(clip, &adaa[0], tmp, dst + start, len);
+        if (MEASURE_OUT) out_peaks[k] = peak_abs(dst + start, len);
+    }
+}
 
-// Funzione di elaborazione audio (run)
-static void
-run(LV2_Handle instance, uint32_t sample_count) {
-    Gua76* self = (Gua76*)instance;
+// Indice: [modo di saturazione][All-Button * 4 + misura ingresso * 2 + misura uscita]
+static const GainApplyKernel GAIN_APPLY_KERNELS[NUM_SATURATION_MODES][8] = {
+    {
+        gain_apply_kernel<false, false, false>, gain_apply_kernel<false, false, true>,
+        gain_apply_kernel<false, true, false>,  gain_apply_kernel<false, true, true>,
+        gain_apply_kernel<true, false, false>,  gain_apply_kernel<true, false, true>,
+        gain_apply_kernel<true, true, false>,   gain_apply_kernel<true, true, true>,
+    }, {
+        gain_apply_adaa_kernel<1, false, false, false>, gain_apply_adaa_kernel<1, false, false, true>,
+        gain_apply_adaa_kernel<1, false, true, false>,  gain_apply_adaa_kernel<1, false, true, true>,
+        gain_apply_adaa_kernel<1, true, false, false>,  gain_apply_adaa_kernel<1, true, false, true>,
+        gain_apply_adaa_kernel<1, true, true, false>,   gain_apply_adaa_kernel<1, true, true, true>,
+    }, {
+        gain_apply_adaa_kernel<2, false, false, false>, gain_apply_adaa_kernel<2, false, false, true>,
+        gain_apply_adaa_kernel<2, false, true, false>,  gain_apply_adaa_kernel<2, false, true, true>,
+        gain_apply_adaa_kernel<2, true, false, false>,  gain_apply_adaa_kernel<2, true, false, true>,
+        gain_apply_adaa_kernel<2, true, true, false>,   gain_apply_adaa_kernel<2, true, true, true>,
+    },
+};
 
-    const float* in_l = self->audio_in_l_ptr;
-    const float* in_r = self->audio_in_r_ptr;
-    float* out_l = self->audio_out_l_ptr;
-    float* out_r = self->audio_out_r_ptr;
 
-    // Sidechain input - se connesso, usa quello, altrimenti usa l'input principale
-    const float* sc_in_l = self->sidechain_in_l_ptr ? self->sidechain_in_l_ptr : in_l;
-    const float* sc_in_r = self->sidechain_in_r_ptr ? self->sidechain_in_r_ptr : in_r;
-
-    // Leggi i valori dei parametri dal host (sono sempre aggiornati)
-    const float input_norm = *self->input_ptr;
-    const float output_norm = *self->output_ptr;
-    const float attack_norm = *self->attack_ptr;   // 0.0=fast, 1.0=slow
-    const float release_norm = *self->release_ptr; // 0.0=fast, 1.0=slow
-    const int   ratio_enum = (int)*self->ratio_ptr;
-    const int   meter_mode_enum = (int)*self->meter_mode_ptr;
-    const bool  bypass = (*self->bypass_ptr > 0.5f);
-    const float drive_saturation_norm = *self->drive_saturation_ptr;
-    const bool  oversampling_on = (*self->oversampling_ptr > 0.5f);
-    const bool  sc_hpf_on = (*self->sidechain_hpf_on_ptr > 0.5f);
-    const float sc_hpf_freq = *self->sidechain_hpf_freq_ptr;
-    const float sc_filter_q = *self->sidechain_hpf_q_ptr; // Nuovo
-    const bool  sc_lpf_on = (*self->sidechain_lpf_on_ptr > 0.5f);
-    const float sc_lpf_freq = *self->sidechain_lpf_freq_ptr;
-    const bool  sidechain_listen = (*self->sidechain_listen_ptr > 0.5f);
-    const bool  midside_mode_on = (*self->midside_mode_ptr > 0.5f); // Nuovo
-    const bool  midside_link = (*self->midside_link_ptr > 0.5f);   // Nuovo
-    const bool  pad_10db_on = (*self->pad_10db_ptr > 0.5f);         // Nuovo
-
-
-    // --- Calcolo Parametri del Compressore ---
-    float input_gain_linear = db_to_linear(input_norm * (INPUT_GAIN_DB_MAX - INPUT_GAIN_DB_MIN) + INPUT_GAIN_DB_MIN);
-    const float output_gain_linear = db_to_linear(output_norm * (OUTPUT_GAIN_DB_MAX - OUTPUT_GAIN_DB_MIN) + OUTPUT_GAIN_DB_MIN);
-    const float compressor_threshold_linear = db_to_linear(COMPRESSOR_THRESHOLD_DB);
-    const float drive_amount = drive_saturation_norm * DRIVE_SATURATION_AMOUNT_MAX;
-
-    if (pad_10db_on) { // Applica il pad prima dell'input gain
-        input_gain_linear *= PAD_10DB_VALUE;
-    }
+// --- Tabella delle alpha del detector ---
 
-    // Mappatura non lineare Attack/Release per il 1176 "feeling"
-    // I tempi effettivi sono spesso mappati in modo inverso logaritmico o esponenziale dalla manopola
-    // Per un feel più 1176, usiamo una potenza per dare più risoluzione verso i tempi veloci.
-    float attack_time_us_mapped = ATTACK_TIME_US_FASTEST + (ATTACK_TIME_US_SLOWEST - ATTACK_TIME_US_FASTEST) * powf(attack_norm, 2.0f);
-    float release_time_ms_mapped = RELEASE_TIME_MS_FASTEST + (RELEASE_TIME_MS_SLOWEST - RELEASE_TIME_MS_FASTEST) * powf(release_norm, 2.0f);
+typedef struct {
+    float alpha[DETECTOR_ALPHA_TABLE_SIZE + 2]; // +1 punto finale, +1 guardia per a == 1.0
+    double samplerate_time; // samplerate * tempo, per il calcolo esatto della build di riferimento
+} DetectorAlphaTable;
+
+// Riempie la tabella per un tempo (in secondi) alla frequenza di elaborazione data
+static void detector_alpha_table_fill(DetectorAlphaTable* t, double samplerate, float time_seconds) {
+    t->samplerate_time = samplerate * time_seconds;
+    for (int i = 0; i <= DETECTOR_ALPHA_TABLE_SIZE; ++i) {
+        const double amount = (double)i / DETECTOR_ALPHA_TABLE_SIZE;
+        t->alpha[i] = (float)(1.0 - exp(-1.0 / (samplerate * time_seconds * (1.0 + 0.5 * amount))));
+    }
+    t->alpha[DETECTOR_ALPHA_TABLE_SIZE + 1] = t->alpha[DETECTOR_ALPHA_TABLE_SIZE];
+}
 
+// 'amount' deve essere già limitato a [0, 1]
+static inline float detector_alpha_lookup(const DetectorAlphaTable* t, float amount) {
+#ifdef GUA76_REFERENCE_BUILD
+    return (float)(1.0 - exp(-1.0 / (t->samplerate_time * (1.0 + 0.5 * amount))));
+#else
+    const float pos = amount * DETECTOR_ALPHA_TABLE_SIZE;
+    const int idx = (int)pos;
+    const float frac = pos - (float)idx;
+    return t->alpha[idx] + (t->alpha[idx + 1] - t->alpha[idx]) * frac;
+#endif
+}
 
-    // Ottieni il rapporto di compressione dal selettore
-    float current_ratio = RATIO_VALUES[ratio_enum];
-    bool is_all_button_mode = (ratio_enum == 4); // Special case for All-Button
 
-    // --- Aggiorna i coefficienti dei filtri sidechain se i parametri cambiano ---
-    // Usiamo variabili statiche per tracciare i cambiamenti e ricalcolare solo quando necessario
-    static float prev_sc_hpf_freq = -1.0f;
-    static float prev_sc_lpf_freq = -1.0f;
-    static float prev_sc_filter_q = -1.0f;
+// --- Massimo a finestra mobile (coda monotona) ---
+// La coda contiene solo i candidati al massimo, in ordine di arrivo e con valori decrescenti:
+// ogni campione entra ed esce una volta sola. 'capacity' è una potenza di 2 >= finestra massima.
+typedef struct {
+    float* value;
+    uint32_t* index;
+    uint32_t mask;    // capacity - 1
+    uint32_t head;    // Primo elemento (contatore, mascherato all'accesso)
+    uint32_t tail;    // Uno dopo l'ultimo
+    uint32_t counter; // Indice del prossimo campione
+} SlidingMax;
+
+static void sliding_max_reset(SlidingMax* m) {
+    m->head = m->tail = m->counter = 0;
+}
 
-    // Calcola i coefficienti dei filtri sidechain (3 biquad in cascata per 6° ordine)
-    if (sc_hpf_on && (fabsf(sc_hpf_freq - prev_sc_hpf_freq) > 0.01f || fabsf(sc_filter_q - prev_sc_filter_q) > 0.01f)) {
-        for (int k = 0; k < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++k) {
-            calculate_biquad_coeffs(&self->sc_hpf_filters_l[k], self->samplerate, sc_hpf_freq, sc_filter_q, 1); // HPF
-            calculate_biquad_coeffs(&self->sc_hpf_filters_r[k], self->samplerate, sc_hpf_freq, sc_filter_q, 1);
-        }
-        prev_sc_hpf_freq = sc_hpf_freq;
-        prev_sc_filter_q = sc_filter_q;
+// out[i] = max(|in[i - window + 1]| ... |in[i]|). 'in' e 'out' possono coincidere.
+static void sliding_max_process(SlidingMax* m, uint32_t window, const float* in, float* out, uint32_t n) {
+#ifdef GUA76_REFERENCE_BUILD
+    // Riferimento: storia circolare degli ultimi campioni e ricerca lineare sulla finestra
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t t = m->counter++;
+        m->value[t & m->mask] = fabsf(in[i]);
+        const uint32_t len = (t + 1 < window) ? t + 1 : window;
+        float peak = 0.0f;
+        for (uint32_t k = 0; k < len; ++k) peak = fmaxf(peak, m->value[(t - k) & m->mask]);
+        out[i] = peak;
     }
-    if (sc_lpf_on && (fabsf(sc_lpf_freq - prev_sc_lpf_freq) > 0.01f || fabsf(sc_filter_q - prev_sc_filter_q) > 0.01f)) {
-        for (int k = 0; k < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++k) {
-            calculate_biquad_coeffs(&self->sc_lpf_filters_l[k], self->samplerate, sc_lpf_freq, sc_filter_q, 0); // LPF
-            calculate_biquad_coeffs(&self->sc_lpf_filters_r[k], self->samplerate, sc_lpf_freq, sc_filter_q, 0);
-        }
-        prev_sc_lpf_freq = sc_lpf_freq;
-        prev_sc_filter_q = sc_filter_q;
+#else
+    const uint32_t mask = m->mask;
+    uint32_t head = m->head;
+    uint32_t tail = m->tail;
+    uint32_t t = m->counter;
+    for (uint32_t i = 0; i < n; ++i, ++t) {
+        const float v = fabsf(in[i]);
+        while (tail != head && m->value[(tail - 1) & mask] <= v) --tail; // Candidati superati
+        m->value[tail & mask] = v;
+        m->index[tail & mask] = t;
+        ++tail;
+        if (t - m->index[head & mask] >= window) ++head; // Al massimo uno esce dalla finestra per campione
+        out[i] = m->value[head & mask];
     }
+    m->head = head;
+    m->tail = tail;
+    m->counter = t;
+#endif
+}
 
 
-    // --- Logica True Bypass ---
-    if (bypass) {
-        if (in_l != out_l) { memcpy(out_l, in_l, sizeof(float) * sample_count); }
-        if (in_r != out_r) { memcpy(out_r, in_r, sizeof(float) * sample_count); }
-        // Aggiorna meter in bypass per un visuale realistico (mostrano input)
-        *self->peak_gr_ptr = 0.0f; // No GR
-        self->peak_in_linear_l = calculate_peak_level(in_l, sample_count, self->peak_in_linear_l, self->peak_meter_decay_alpha);
-        self->peak_in_linear_r = calculate_peak_level(in_r, sample_count, self->peak_in_linear_r, self->peak_meter_decay_alpha);
-        self->peak_out_linear_l = self->peak_in_linear_l; // Output = Input in bypass
-        self->peak_out_linear_r = self->peak_in_linear_r;
-
-        *self->peak_in_l_ptr = to_db(self->peak_in_linear_l);
-        *self->peak_in_r_ptr = to_db(self->peak_in_linear_r);
-        *self->peak_out_l_ptr = to_db(self->peak_out_linear_l);
-        *self->peak_out_r_ptr = to_db(self->peak_out_linear_r);
-        return;
-    }
-
-    // --- Mid-Side Encoding (se attivo) ---
-    float temp_in_l[sample_count];
-    float temp_in_r[sample_count];
-    float temp_sc_l[sample_count];
-    float temp_sc_r[sample_count];
+// --- Strutture e Funzioni per i Filtri Half-Band Polifase ---
 
-    if (midside_mode_on) {
-        for (uint32_t i = 0; i < sample_count; ++i) {
-            temp_in_l[i] = (in_l[i] + in_r[i]) * 0.5f; // Mid
-            temp_in_r[i] = (in_l[i] - in_r[i]) * 0.5f; // Side
-            temp_sc_l[i] = (sc_in_l[i] + sc_in_r[i]) * 0.5f; // Mid Sidechain
-            temp_sc_r[i] = (sc_in_l[i] - sc_in_r[i]) * 0.5f; // Side Sidechain
-        }
-        in_l = temp_in_l;
-        in_r = temp_in_r;
-        sc_in_l = temp_sc_l;
-        sc_in_r = temp_sc_r;
-    }
+// Coefficienti di un half-band IIR: H(z) = 0.5 * (A0(z^2) + z^-1 * A1(z^2)),
+// dove A0 usa i coefficienti pari e A1 quelli dispari.
+typedef struct {
+    float coefs[HALFBAND_MAX_COEFS];
+    int num_coefs;
+    double group_delay; // Ritardo di gruppo alle basse frequenze, in campioni alla frequenza più alta
+} HalfbandCoeffs;
 
+// Stato di uno stadio per ogni corsia (memoria degli allpass), conservato tra un blocco e l'altro
+typedef struct {
+    float x[HALFBAND_MAX_COEFS][SIMD_LANES];
+    float y[HALFBAND_MAX_COEFS][SIMD_LANES];
+} HalfbandLanes;
 
-    // --- Loop di elaborazione per blocco di campioni ---
-    // Gestione dell'oversampling: dobbiamo elaborare il blocco completo
-    // I passaggi: Upsample input -> Filter -> Process (OS) -> Filter -> Downsample output
-    uint32_t current_oversample_buffer_size = sample_count * UPSAMPLE_FACTOR;
+// --- Banca condivisa dei coefficienti ---
+// Tutto ciò che dipende solo dalla frequenza di campionamento e dal fattore di oversampling viene
+// calcolato una volta per processo (in instantiate(), mai in run()) e condiviso in sola lettura
+// da tutte le istanze alla stessa frequenza, con un conteggio dei riferimenti: l'ultima cleanup()
+// la libera. Il registro è una lista protetta da un mutex (instantiate/cleanup non sono real-time).
 
-    // Assicurati che i buffer siano sufficientemente grandi
-    if (current_oversample_buffer_size > self->max_oversample_buffer_size) {
-        lv2_log_warning(&self->logger, "Oversample buffer too small! Skipping oversampling.\n");
-        // Non dovremmo mai arrivare qui con una allocazione dinamica corretta
-        return;
+// Costanti per una frequenza di elaborazione (frequenza dell'host * 2^stadi)
+typedef struct {
+    float gain_smooth_alpha;      // Smoothing della GR (alla frequenza del detector)
+    float sc_filter_smooth_alpha; // Rampa dei filtri sidechain, per SC_FILTER_SMOOTH_BLOCK campioni
+    // Ritardo del gain del detector a frequenza ridotta, per stadi del detector (<= questi stadi)
+    uint32_t detector_gain_delay[OS_MAX_HALFBAND_STAGES + 1];
+} CoeffBankRate;
+
+typedef struct CoeffBank {
+    double samplerate; // Chiave
+    int refcount;      // Protetto da coeff_bank_mutex
+    struct CoeffBank* next;
+    HalfbandCoeffs halfband[OS_MAX_HALFBAND_STAGES]; // Indipendenti dalla frequenza
+    CoeffBankRate rates[OS_MAX_HALFBAND_STAGES + 1]; // Indice: stadi half-band (0 = 1x)
+} CoeffBank;
+
+// Specifiche degli stadi: numero di coefficienti e banda di transizione (normalizzata
+// alla frequenza di uscita). Il primo stadio deve essere ripido (banda passante fino a
+// ~20 kHz a 44.1 kHz), i successivi lavorano su un segnale già limitato in banda.
+// Attenuazione in banda oscura: ~106 dB, ~96 dB, ~96 dB, ~81 dB.
+static const int HALFBAND_STAGE_NUM_COEFS[OS_MAX_HALFBAND_STAGES] = { 10, 5, 4, 3 };
+static const double HALFBAND_STAGE_TRANSITION[OS_MAX_HALFBAND_STAGES] = { 0.0227, 0.125, 0.1875, 0.21875 };
+
+static double halfband_ipow(double x, int n) {
+    double z = 1.0;
+    while (n != 0) {
+        if (n & 1) z *= x;
+        n >>= 1;
+        x *= x;
     }
+    return z;
+}
 
-    // Copia e Upsample con interpolazione semplice (in una vera implementazione sarebbe un interpolatore più sofisticato)
-    for (uint32_t i = 0; i < sample_count; ++i) {
-        for (uint32_t j = 0; j < UPSAMPLE_FACTOR; ++j) {
-            float alpha = (float)j / UPSAMPLE_FACTOR;
-            // Interpolazione lineare per oversampling
-            self->oversample_buffer_l[i * UPSAMPLE_FACTOR + j] = in_l[i] * (1.0f - alpha) + (i + 1 < sample_count ? in_l[i+1] : in_l[i]) * alpha;
-            self->oversample_buffer_r[i * UPSAMPLE_FACTOR + j] = in_r[i] * (1.0f - alpha) + (i + 1 < sample_count ? in_r[i+1] : in_r[i]) * alpha;
-            self->oversample_sidechain_l[i * UPSAMPLE_FACTOR + j] = sc_in_l[i] * (1.0f - alpha) + (i + 1 < sample_count ? sc_in_l[i+1] : sc_in_l[i]) * alpha;
-            self->oversample_sidechain_r[i * UPSAMPLE_FACTOR + j] = sc_in_r[i] * (1.0f - alpha) + (i + 1 < sample_count ? sc_in_r[i+1] : sc_in_r[i]) * alpha;
-        }
+// Progetto ellittico dei coefficienti allpass (metodo di Valenzuela/Constantinides,
+// lo stesso usato da HIIR) per un numero di coefficienti e una banda di transizione dati.
+static void halfband_design(HalfbandCoeffs* c, int num_coefs, double transition) {
+    const int order = num_coefs * 2 + 1;
+    double k = tan((1.0 - transition * 2.0) * M_PI / 4.0);
+    k *= k;
+    const double kksqrt = pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+    const double e4 = e * e * e * e;
+    const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+    c->num_coefs = num_coefs;
+    for (int i = 0; i < num_coefs; ++i) {
+        const int idx = i + 1;
+        double num = 0.0, den = 0.0, term;
+        double sign = 1.0;
+        int j = 0;
+        do {
+            term = halfband_ipow(q, j * (j + 1)) * sin((j * 2 + 1) * idx * M_PI / order) * sign;
+            num += term;
+            sign = -sign;
+            ++j;
+        } while (fabs(term) > 1e-100);
+        num *= pow(q, 0.25);
+
+        sign = -1.0;
+        j = 1;
+        do {
+            term = halfband_ipow(q, j * j) * cos(j * 2 * idx * M_PI / order) * sign;
+            den += term;
+            sign = -sign;
+            ++j;
+        } while (fabs(term) > 1e-100);
+        den += 0.5;
+
+        const double ww = num / den;
+        const double wwsq = ww * ww;
+        const double x = sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+        c->coefs[i] = (float)((1.0 - x) / (1.0 + x));
     }
 
+    // Ogni allpass (c + z^-1) / (1 + c z^-1) ritarda la continua di (1 - c) / (1 + c) campioni
+    // alla frequenza più bassa; le due catene danno lo stesso ritardo sui campioni interlacciati.
+    double delay = 0.0;
+    for (int i = 0; i < num_coefs; i += 2) delay += (1.0 - c->coefs[i]) / (1.0 + c->coefs[i]);
+    c->group_delay = 2.0 * delay;
+}
 
-    // Loop a sample rate di oversampling
-    for (uint32_t i = 0; i < current_oversample_buffer_size; ++i) {
-        float current_sample_l = self->oversample_buffer_l[i];
-        float current_sample_r = self->oversample_buffer_r[i];
-        float current_sc_l = self->oversample_sidechain_l[i];
-        float current_sc_r = self->oversample_sidechain_r[i];
+static void halfband_lanes_reset(HalfbandLanes* s) {
+    memset(s, 0, sizeof(HalfbandLanes));
+}
 
-        // --- Oversampling Stage 2: Filtri Anti-Aliasing (Low-Pass) ---
-        if (oversampling_on) {
-            for (int k = 0; k < NUM_BIQUADS_FOR_OS_FILTER; ++k) {
-                current_sample_l = biquad_process(&self->upsample_lp_filters_l[k], current_sample_l);
-                current_sample_r = biquad_process(&self->upsample_lp_filters_r[k], current_sample_r);
-            }
-        }
+// Un allpass del primo ordine (alla frequenza più bassa) su tutte le corsie.
+// y = c * (x - y[-1]) + x[-1] è scritto come c * x + x[-1] - c * y[-1]:
+// solo l'ultimo prodotto dipende dal campione precedente e la catena si accorcia.
+static inline Lanes halfband_allpass(float coef, float* xm, float* ym, Lanes in) {
+    const Lanes c = lanes_set1(coef);
+    const Lanes x1 = lanes_load(xm);
+    const Lanes y = lanes_sub(lanes_add(lanes_mul(c, in), x1), lanes_mul(c, lanes_load(ym)));
+    lanes_store(xm, in);
+    lanes_store(ym, y);
+    return y;
+}
+
+// Upsampling 2x: un campione in ingresso produce un campione pari (catena A0)
+// e uno dispari (catena A1), entrambi calcolati alla frequenza più bassa.
+static inline void halfband_lanes_up_step(const HalfbandCoeffs* c, HalfbandLanes* s, Lanes in, Lanes* out_even, Lanes* out_odd) {
+    Lanes even = in;
+    Lanes odd = in;
+    int k = 0;
+    for (; k + 1 < c->num_coefs; k += 2) {
+        even = halfband_allpass(c->coefs[k], s->x[k], s->y[k], even);
+        odd = halfband_allpass(c->coefs[k + 1], s->x[k + 1], s->y[k + 1], odd);
+    }
+    if (k < c->num_coefs) {
+        even = halfband_allpass(c->coefs[k], s->x[k], s->y[k], even);
+    }
+    *out_even = even;
+    *out_odd = odd;
+}
 
-        // --- Sidechain Processing (a Oversampled Rate per maggiore accuratezza) ---
-        float processed_sc_l = current_sc_l;
-        float processed_sc_r = current_sc_r;
+// Downsampling 2x: calcola solo il campione che sopravvive alla decimazione
+static inline Lanes halfband_lanes_down_step(const HalfbandCoeffs* c, HalfbandLanes* s, Lanes in_even, Lanes in_odd) {
+    Lanes path0 = in_odd;
+    Lanes path1 = in_even;
+    int k = 0;
+    for (; k + 1 < c->num_coefs; k += 2) {
+        path0 = halfband_allpass(c->coefs[k], s->x[k], s->y[k], path0);
+        path1 = halfband_allpass(c->coefs[k + 1], s->x[k + 1], s->y[k + 1], path1);
+    }
+    if (k < c->num_coefs) {
+        path0 = halfband_allpass(c->coefs[k], s->x[k], s->y[k], path0);
+    }
+    return lanes_mul(lanes_add(path0, path1), lanes_set1(0.5f));
+}
 
-        if (sc_hpf_on) {
-            for (int k = 0; k < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++k) {
-                processed_sc_l = biquad_process(&self->sc_hpf_filters_l[k], processed_sc_l);
-                processed_sc_r = biquad_process(&self->sc_hpf_filters_r[k], processed_sc_r);
+// Upsampling a cascata su fino a 4 canali planari: 'in' (n campioni) -> 'out' (n * 2^num_stages).
+// Ogni campione attraversa tutti gli stadi uno dopo l'altro, senza buffer intermedi.
+// Se 'peaks' non è NULL raccoglie anche i massimi di |in| per sotto-blocchi di METER_BLOCK campioni.
+static void oversample_up_lanes(const HalfbandCoeffs* coeffs, HalfbandLanes* states, int num_stages,
+                                const float* const* in, float* const* out, int num_lanes, uint32_t n,
+                                float* const* peaks) {
+    const uint32_t factor = 1u << num_stages;
+    Lanes buf_a[MAX_UPSAMPLE_FACTOR], buf_b[MAX_UPSAMPLE_FACTOR];
+    Lanes peak = lanes_set1(0.0f);
+    for (uint32_t i = 0; i < n; ++i) {
+        Lanes* src = buf_a;
+        Lanes* dst = buf_b;
+        src[0] = lanes_gather(in, num_lanes, i);
+        if (peaks) {
+            peak = lanes_max(peak, lanes_abs(src[0]));
+            if ((i + 1) % METER_BLOCK == 0 || i + 1 == n) {
+                lanes_store_peaks(peaks, num_lanes, i / METER_BLOCK, peak);
+                peak = lanes_set1(0.0f);
             }
         }
-        if (sc_lpf_on) {
-            for (int k = 0; k < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++k) {
-                processed_sc_l = biquad_process(&self->sc_lpf_filters_l[k], processed_sc_l);
-                processed_sc_r = biquad_process(&self->sc_lpf_filters_r[k], processed_sc_r);
+        uint32_t len = 1;
+        for (int st = 0; st < num_stages; ++st) {
+            for (uint32_t j = 0; j < len; ++j) {
+                halfband_lanes_up_step(&coeffs[st], &states[st], src[j], &dst[2 * j], &dst[2 * j + 1]);
             }
+            Lanes* tmp = src; src = dst; dst = tmp;
+            len *= 2;
         }
+        lanes_scatter_block(out, num_lanes, i * factor, src, factor);
+    }
+}
 
-        // --- Envelope Detector (Peak Detector, ispirato 1176 con non linearità) ---
-        // L'1176 è un peak detector, con tempi di attacco e rilascio che dipendono dal segnale.
-        // Più alto il segnale, più veloce il tempo effettivo.
-        float current_abs_l_sc = fabsf(processed_sc_l);
-        float current_abs_r_sc = fabsf(processed_sc_r);
-
-        // Attack/Release alphas dipendenti dall'ampiezza per la non linearità dell'1176
-        // Se il segnale è molto forte, l'attacco e il rilascio sono più rapidi
-        float dynamic_attack_alpha_l = 1.0f - expf(-1.0f / (self->oversampled_samplerate * (attack_time_us_mapped / 1000000.0f * (1.0f + 0.5f * fminf(1.0f, current_abs_l_sc * 2.0f)))));
-        float dynamic_release_alpha_l = 1.0f - expf(-1.0f / (self->oversampled_samplerate * (release_time_ms_mapped / 1000.0f * (1.0f + 0.5f * fminf(1.0f, self->envelope_l * 0.5f)))));
-        float dynamic_attack_alpha_r = 1.0f - expf(-1.0f / (self->oversampled_samplerate * (attack_time_us_mapped / 1000000.0f * (1.0f + 0.5f * fminf(1.0f, current_abs_r_sc * 2.0f)))));
-        float dynamic_release_alpha_r = 1.0f - expf(-1.0f / (self->oversampled_samplerate * (release_time_ms_mapped / 1000.0f * (1.0f + 0.5f * fminf(1.0f, self->envelope_r * 0.5f)))));
-
-        // Envelope update
-        if (current_abs_l_sc > self->envelope_l) {
-            self->envelope_l = (self->envelope_l * (1.0f - dynamic_attack_alpha_l)) + (current_abs_l_sc * dynamic_attack_alpha_l);
-        } else {
-            self->envelope_l = (self->envelope_l * (1.0f - dynamic_release_alpha_l)) + (current_abs_l_sc * dynamic_release_alpha_l);
+// Downsampling a cascata su fino a 4 canali planari: 'in' (n * 2^num_stages campioni) -> 'out' (n).
+// Se 'peaks' non è NULL raccoglie anche i massimi di |out| per sotto-blocchi di METER_BLOCK campioni.
+static void oversample_down_lanes(const HalfbandCoeffs* coeffs, HalfbandLanes* states, int num_stages,
+                                  const float* const* in, float* const* out, int num_lanes, uint32_t n,
+                                  float* const* peaks) {
+    const uint32_t factor = 1u << num_stages;
+    Lanes buf_a[MAX_UPSAMPLE_FACTOR], buf_b[MAX_UPSAMPLE_FACTOR];
+    Lanes peak = lanes_set1(0.0f);
+    for (uint32_t i = 0; i < n; ++i) {
+        Lanes* src = buf_a;
+        Lanes* dst = buf_b;
+        for (uint32_t j = 0; j < factor; ++j) {
+            src[j] = lanes_gather(in, num_lanes, i * factor + j);
         }
-        if (current_abs_r_sc > self->envelope_r) {
-            self->envelope_r = (self->envelope_r * (1.0f - dynamic_attack_alpha_r)) + (current_abs_r_sc * dynamic_attack_alpha_r);
-        } else {
-            self->envelope_r = (self->envelope_r * (1.0f - dynamic_release_alpha_r)) + (current_abs_r_sc * dynamic_release_alpha_r);
+        uint32_t len = factor;
+        for (int st = num_stages - 1; st >= 0; --st) {
+            len /= 2;
+            for (uint32_t j = 0; j < len; ++j) {
+                dst[j] = halfband_lanes_down_step(&coeffs[st], &states[st], src[2 * j], src[2 * j + 1]);
+            }
+            Lanes* tmp = src; src = dst; dst = tmp;
         }
-
-        // --- Gain Computer ---
-        float gain_reduction_linear_l = 1.0f;
-        float gain_reduction_linear_r = 1.0f;
-
-        float detector_envelope_l = self->envelope_l;
-        float detector_envelope_r = self->envelope_r;
-
-        if (midside_mode_on && midside_link) {
-            // Se Mid-Side e Link attivo, il detector usa il massimo tra M e S
-            detector_envelope_l = fmaxf(self->envelope_l, self->envelope_r);
-            detector_envelope_r = detector_envelope_l; // Linka il detector anche per Side
+        lanes_scatter_block(out, num_lanes, i, src, 1);
+        if (peaks) {
+            peak = lanes_max(peak, lanes_abs(src[0]));
+            if ((i + 1) % METER_BLOCK == 0 || i + 1 == n) {
+                lanes_store_peaks(peaks, num_lanes, i / METER_BLOCK, peak);
+                peak = lanes_set1(0.0f);
+            }
         }
+    }
+}
 
 
-        if (is_all_button_mode) {
-            // "All-Button" Mode: Aggressive, higher ratio, often a "knee" that dips below 0dB GR
-            // e una compressione più aggressiva e un leggero aumento della distorsione.
-            if (detector_envelope_l > compressor_threshold_linear) {
-                float over_threshold = detector_envelope_l - compressor_threshold_linear;
-                float compressed_envelope = compressor_threshold_linear + (over_threshold / (current_ratio * 1.5f)); // Ratio più alto
-                gain_reduction_linear_l = compressed_envelope / detector_envelope_l;
-            }
-            if (detector_envelope_r > compressor_threshold_linear) { // Anche se linkato, calcolo per r (sarà uguale a l)
-                float over_threshold = detector_envelope_r - compressor_threshold_linear;
-                float compressed_envelope = compressor_threshold_linear + (over_threshold / (current_ratio * 1.5f));
-                gain_reduction_linear_r = compressed_envelope / detector_envelope_r;
-            }
-            // Aggiungi un po' di distorsione armonica aggiuntiva in All-Button mode
-            current_sample_l = apply_soft_clip(current_sample_l, drive_amount + 0.2f); // Più drive
-            current_sample_r = apply_soft_clip(current_sample_r, drive_amount + 0.2f);
-        } else {
-            // Canale Left/Mid
-            if (detector_envelope_l > compressor_threshold_linear) {
-                float over_threshold = detector_envelope_l - compressor_threshold_linear;
-                float compressed_envelope = compressor_threshold_linear + (over_threshold / current_ratio);
-                gain_reduction_linear_l = compressed_envelope / detector_envelope_l;
-            }
-            // Canale Right/Side
-            if (detector_envelope_r > compressor_threshold_linear) {
-                float over_threshold = detector_envelope_r - compressor_threshold_linear;
-                float compressed_envelope = compressor_threshold_linear + (over_threshold / current_ratio);
-                gain_reduction_linear_r = compressed_envelope / detector_envelope_r;
-            }
-        }
+// Istantanea dei controlli dell'host all'ultimo run() (per istanza)
+typedef struct {
+    bool  valid; // false = ricalcola tutti i valori derivati al prossimo run()
+    float input_norm;
+    float output_norm;
+    bool  pad_10db_on;
+    float attack_norm;
+    float release_norm;
+    int   ratio_idx;
+    float knee_db;
+    float drive_saturation_norm;
+    int   saturation_mode;
+    float sc_hpf_freq;
+    float sc_lpf_freq;
+    float sc_filter_q;
+} Gua76Controls;
+
+// Parametri derivati dai controlli, condivisi da tutti i chunk del blocco
+typedef struct {
+    GainComputerParams gain;
+    float io_gain_target; // Input gain (con pad) * output gain, raggiunto con una rampa
+    SoftClipParams saturation;            // Saturazione finale
+    SoftClipParams all_button_saturation; // Saturazione aggiuntiva in All-Button mode (più drive)
+    int   saturation_mode; // SATURATION_MODE_*
+    int   os_num_stages;
+    int   detector_os_stages; // Stadi half-band di sidechain e detector (<= os_num_stages)
+    int   detector_link;  // DETECTOR_LINK_*
+    bool  is_all_button_mode;
+    bool  external_sidechain;
+    bool  sc_hpf_on;
+    bool  sc_lpf_on;
+    bool  sidechain_listen;
+    bool  midside_mode_on; // Solo stereo
+    bool  midside_link;
+} Gua76ChunkParams;
+
+// Stato del DSP (per istanza), senza porte: parametri in 'settings', buffer passati a process_block.
+// Usato sia dal plugin LV2 (Gua76Plugin) sia da Gua76Engine.
+typedef struct Gua76 {
+    Gua76Settings settings; // Valori correnti dei parametri (letti a ogni blocco)
+    float gr_meter_db;      // GR a fine blocco (dB, massimo sui canali)
 
-        // Smooth la Gain Reduction per evitare zippering
-        self->current_gr_linear_l = (self->current_gr_linear_l * (1.0f - dynamic_attack_alpha_l)) + (gain_reduction_linear_l * dynamic_attack_alpha_l);
-        self->current_gr_linear_r = (self->current_gr_linear_r * (1.0f - dynamic_attack_alpha_r)) + (gain_reduction_linear_r * dynamic_attack_alpha_r);
+    // Variabili di stato del plugin
+    int num_channels; // Dalla variante istanziata (1, 2, 6 o 8)
+    double samplerate;
+    const CoeffBank* coeffs;       // Banca condivisa per questa frequenza (sola lettura)
+    double oversampled_samplerate; // samplerate * fattore di oversampling corrente
+    int os_num_stages; // Stadi half-band attivi (0 = 1x), -1 = da inizializzare
+    double detector_samplerate; // Frequenza di filtri sidechain, detector e smoothing della GR
+    int detector_os_stages;     // Stadi half-band del sidechain (<= os_num_stages)
+
+    // Variabili di stato del compressore (per canale; in stereo M/S: 0 = Mid, 1 = Side).
+    // Con il detector linkato si usano solo envelope[0] e current_gr_linear[0].
+    float envelope[GUA76_MAX_CHANNELS];
+    float current_gr_linear[GUA76_MAX_CHANNELS];
+    // Detector a frequenza ridotta: ultimo gain del blocco precedente (interpolazione) e linea di
+    // ritardo del gain interpolato (allineamento all'audio), per detector
+    float detector_gain_prev[GUA76_MAX_CHANNELS];
+    bool  detector_gain_prev_valid;
+    float detector_gain_delay_line[GUA76_MAX_CHANNELS][DETECTOR_GAIN_MAX_DELAY];
+    uint32_t detector_gain_delay;
+    uint32_t detector_gain_delay_pos;
+    float peak_in_linear[GUA76_MAX_CHANNELS];
+    float peak_out_linear[GUA76_MAX_CHANNELS];
+    float true_peak_out_linear[GUA76_MAX_CHANNELS];
+
+
+    // Tabelle delle alpha del detector (ricalcolate per blocco dai tempi di attacco/rilascio)
+    DetectorAlphaTable attack_alpha_table;
+    DetectorAlphaTable release_alpha_table;
+
+    // Variabili per smoothing dei meter
+    float gr_meter_alpha;
+    float output_meter_alpha;
+    float peak_meter_decay_alpha; // Per il decadimento dei picchi (per campione)
+    float peak_meter_log_decay;   // log(1 - peak_meter_decay_alpha), per il decadimento in forma chiusa
+    float peak_meter_block_decay; // Decadimento su METER_BLOCK campioni
+
+    // Massimi per sotto-blocco del chunk corrente (ceil(chunk_length / METER_BLOCK) valori per canale)
+    float* meter_in_peaks[GUA76_MAX_CHANNELS];
+    float* meter_out_peaks[GUA76_MAX_CHANNELS];
+    float* meter_true_peaks[GUA76_MAX_CHANNELS];
+    float* meter_gr_min; // GR lineare per sotto-blocco (minimo e massimo su tutti i detector)
+    float* meter_gr_max;
+
+    // Telemetria sulla porta notify: i sotto-blocchi dei meter vengono accumulati in frame di
+    // TELEMETRY_FRAME_LENGTH campioni; i frame completati in un chunk (al massimo
+    // telemetry_max_frames, preallocati) vengono scritti come un evento nella sequenza dell'host.
+    LV2_Atom_Forge forge;
+    LV2_Atom_Forge_Frame notify_frame;
+    LV2_URID telemetry_urid;
+    LV2_URID telemetry_frame_length_urid;
+    LV2_URID telemetry_frames_urid;
+    bool telemetry_available; // urid:map disponibile
+    bool telemetry_active;    // Sequenza aperta nel blocco corrente
+    float* telemetry_frames;  // telemetry_max_frames * GUA76_TELEMETRY_FIELDS valori (dB)
+    uint32_t telemetry_max_frames;
+    uint32_t telemetry_num_frames;
+    uint32_t telemetry_samples; // Campioni accumulati nel frame corrente
+    float telemetry_gr_min;
+    float telemetry_gr_max;
+    float telemetry_peak_in;
+    float telemetry_peak_out;
+    float telemetry_energy_in[GUA76_MAX_CHANNELS];
+    float telemetry_energy_out[GUA76_MAX_CHANNELS];
+
+    // Buffer per oversampling (per canale, max_oversample_buffer_size campioni: un micro-blocco)
+    float* oversample_buffer[GUA76_MAX_CHANNELS];
+    float* oversample_sidechain[GUA76_MAX_CHANNELS];
+    float* detector_buffer[GUA76_MAX_CHANNELS];     // Envelope del detector, poi gain calcolato (per micro-blocco)
+    float* attack_alpha_buffer[GUA76_MAX_CHANNELS]; // Alpha di attacco per campione (usate per lo smoothing della GR)
+    float* midside_in[2]; // Ingressi codificati Mid-Side (un micro-blocco, solo stereo)
+    float* midside_sc[2];
+    uint32_t chunk_length; // Campioni (alla frequenza dell'host) elaborati per chunk
+    uint32_t max_oversample_buffer_size; // Campioni di un micro-blocco alla frequenza interna
+
+    // Filtri half-band polifase per upsampling/downsampling (uno stato per stadio, SoA).
+    // I canali sono elaborati a gruppi di SIMD_LANES corsie. Upsampling: prima i canali audio,
+    // poi quelli sidechain (es. stereo: L, R, sidechain L, sidechain R); con il detector a frequenza
+    // ridotta il sidechain usa i gruppi da MAX_CHANNEL_LANE_GROUPS in poi. Downsampling: canali audio.
+    // I coefficienti sono nella banca condivisa (coeffs->halfband).
+    HalfbandLanes upsample_lanes[MAX_UPSAMPLE_LANE_GROUPS][OS_MAX_HALFBAND_STAGES];
+    HalfbandLanes downsample_lanes[MAX_CHANNEL_LANE_GROUPS][OS_MAX_HALFBAND_STAGES];
+
+    // Saturazione ADAA: ultimi ingressi delle curve (finale, All-Button) per canale
+    AdaaState saturation_adaa[GUA76_MAX_CHANNELS][2];
+
+    // Filtri sidechain (6° ordine: 3 biquad in cascata), una corsia per canale
+    BiquadLanes sc_hpf_lanes[MAX_CHANNEL_LANE_GROUPS][NUM_BIQUADS_FOR_SIDECHAIN_FILTER];
+    BiquadLanes sc_lpf_lanes[MAX_CHANNEL_LANE_GROUPS][NUM_BIQUADS_FOR_SIDECHAIN_FILTER];
+
+    // Lookahead: linea di ritardo dell'audio (frequenza dell'host, lunga lookahead_samples) e
+    // massimo a finestra mobile del sidechain (frequenza interna), uno per detector
+    float* lookahead_ring[GUA76_MAX_CHANNELS];   // lookahead_max_samples campioni
+    float* lookahead_buffer[GUA76_MAX_CHANNELS]; // Ingresso ritardato del chunk (chunk_length campioni)
+    SlidingMax lookahead_peak[GUA76_MAX_CHANNELS];
+    uint32_t lookahead_max_samples; // Alla frequenza dell'host, per LOOKAHEAD_MS_MAX
+    uint32_t lookahead_samples;     // Ritardo corrente (= latenza), 0 = lookahead spento
+    uint32_t lookahead_pos;         // Posizione nella linea di ritardo
+    uint32_t adaa_delay_samples;    // Ritardo dell'ADAA alla frequenza dell'host (0 o 1)
+    uint32_t latency_samples;       // Latenza riportata: lookahead_samples + adaa_delay_samples
+    float bypass_adaa_last[GUA76_MAX_CHANNELS]; // Bypass: ultimo campione, per ritardare come l'ADAA
+
+    // Istantanea dei controlli e parametri derivati (ricalcolati solo al cambiamento)
+    Gua76Controls controls;
+    Gua76ChunkParams params;
+
+    // Rampe: gain per campione, frequenze/Q dei filtri sidechain per sotto-blocco
+    float io_gain_current;
+    float gain_smooth_alpha;      // Per campione, alla frequenza interna
+    float sc_hpf_freq_current;
+    float sc_lpf_freq_current;
+    float sc_filter_q_current;
+    float sc_filter_smooth_alpha; // Per sotto-blocco di SC_FILTER_SMOOTH_BLOCK campioni
+    bool  sc_filter_ramping;
+
+    // Sospensione in silenzio (vedi SILENZIO)
+    float silence_threshold;       // Lineare, da SILENCE_THRESHOLD_DB
+    float silence_envelope;        // Lineare, da SILENCE_ENVELOPE_DB
+    uint32_t silence_hold_samples; // SILENCE_HOLD_MS alla frequenza dell'host
+    uint32_t silent_samples;       // Campioni consecutivi di ingresso in silenzio
+    bool sleeping;                 // DSP sospeso: stato azzerato, uscita a zero
 
+} Gua76;
 
-        // --- Applicazione del Gain e Output ---
-        // Applica l'input gain, la gain reduction, e l'output gain
-        float final_l = current_sample_l * input_gain_linear * self->current_gr_linear_l * output_gain_linear;
-        float final_r = current_sample_r * input_gain_linear * self->current_gr_linear_r * output_gain_linear;
+// Numero di gruppi di corsie SIMD necessari per 'num' canali
+static inline int lane_groups(int num) {
+    return (num + SIMD_LANES - 1) / SIMD_LANES;
+}
 
-        // Applica il soft clipping/saturazione finale (per il "carattere" 1176)
-        final_l = apply_soft_clip(final_l, drive_amount);
-        final_r = apply_soft_clip(final_r, drive_amount);
+// Corsie usate dal gruppo 'group' quando i canali sono 'num'
+static inline int lanes_in_group(int num, int group) {
+    const int left = num - group * SIMD_LANES;
+    return (left < SIMD_LANES) ? left : SIMD_LANES;
+}
 
-        // Se Sidechain Listen è attivo, dirotta il segnale sidechain processato all'output
-        if (sidechain_listen) {
-            final_l = processed_sc_l;
-            final_r = processed_sc_r;
-        }
+// Lunghezza (alla frequenza dell'host) dei micro-blocchi di process_stages con 2^os_num_stages
+// di oversampling: PIPELINE_BLOCK_OS_SAMPLES campioni interni, non più di un chunk
+static inline uint32_t pipeline_block_length(const Gua76* self, int os_num_stages) {
+    const uint32_t length = PIPELINE_BLOCK_OS_SAMPLES >> os_num_stages;
+    return (length < self->chunk_length) ? length : self->chunk_length;
+}
 
-        self->oversample_buffer_l[i] = final_l;
-        self->oversample_buffer_r[i] = final_r;
-    } // Fine loop per-oversampled sample
+// Azzera la storia dei filtri di oversampling (attivazione o cambio di fattore)
+static void reset_oversampling_filters(Gua76* self) {
+    for (int i = 0; i < OS_MAX_HALFBAND_STAGES; ++i) {
+        for (int g = 0; g < MAX_UPSAMPLE_LANE_GROUPS; ++g) halfband_lanes_reset(&self->upsample_lanes[g][i]);
+        for (int g = 0; g < MAX_CHANNEL_LANE_GROUPS; ++g) halfband_lanes_reset(&self->downsample_lanes[g][i]);
+    }
+}
 
+// Azzera solo gli stati half-band del sidechain sovracampionato alla frequenza ridotta del detector
+static void reset_sidechain_upsampling(Gua76* self) {
+    for (int i = 0; i < OS_MAX_HALFBAND_STAGES; ++i) {
+        for (int g = MAX_CHANNEL_LANE_GROUPS; g < MAX_UPSAMPLE_LANE_GROUPS; ++g) halfband_lanes_reset(&self->upsample_lanes[g][i]);
+    }
+}
 
-    // --- Oversampling Stage 3: Filtro Anti-Aliasing (Low-Pass) e Downsample ---
-    for (uint32_t i = 0; i < sample_count; ++i) {
-        float downsampled_l = self->oversample_buffer_l[i * UPSAMPLE_FACTOR];
-        float downsampled_r = self->oversample_buffer_r[i * UPSAMPLE_FACTOR];
+// Azzera lo stato dell'ADAA (ingressi precedenti alla frequenza interna)
+static void reset_saturation_state(Gua76* self) {
+    memset(self->saturation_adaa, 0, sizeof(self->saturation_adaa));
+}
 
-        if (oversampling_on) {
-            for (int k = 0; k < NUM_BIQUADS_FOR_OS_FILTER; ++k) {
-                downsampled_l = biquad_process(&self->downsample_lp_filters_l[k], downsampled_l);
-                downsampled_r = biquad_process(&self->downsample_lp_filters_r[k], downsampled_r);
-            }
+// Azzera stati e coefficienti dei filtri sidechain
+static void reset_sidechain_filters(Gua76* self) {
+    for (int g = 0; g < MAX_CHANNEL_LANE_GROUPS; ++g) {
+        for (int i = 0; i < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++i) { // Per i filtri sidechain (6° ordine)
+            biquad_lanes_init(&self->sc_hpf_lanes[g][i]);
+            biquad_lanes_init(&self->sc_lpf_lanes[g][i]);
         }
-        out_l[i] = downsampled_l;
-        out_r[i] = downsampled_r;
     }
+}
 
-    // --- Mid-Side Decoding (se attivo) ---
-    if (midside_mode_on) {
-        for (uint32_t i = 0; i < sample_count; ++i) {
-            float mid = out_l[i];
-            float side = out_r[i];
-            out_l[i] = mid + side;
-            out_r[i] = mid - side;
+// Calcola i coefficienti dei filtri sidechain (3 biquad in cascata per 6° ordine) dai valori correnti
+static void update_sidechain_filter_coeffs(Gua76* self) {
+    BiquadFilter hpf, lpf;
+    calculate_biquad_coeffs(&hpf, self->detector_samplerate, self->sc_hpf_freq_current, self->sc_filter_q_current, 1); // HPF
+    calculate_biquad_coeffs(&lpf, self->detector_samplerate, self->sc_lpf_freq_current, self->sc_filter_q_current, 0); // LPF
+    for (int g = 0; g < lane_groups(self->num_channels); ++g) {
+        for (int k = 0; k < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++k) {
+            for (int lane = 0; lane < SIMD_LANES; ++lane) {
+                biquad_lanes_set_coeffs(&self->sc_hpf_lanes[g][k], lane, &hpf);
+                biquad_lanes_set_coeffs(&self->sc_lpf_lanes[g][k], lane, &lpf);
+            }
         }
     }
+}
 
+// Porta subito i filtri sidechain ai valori dei controlli (senza rampa)
+static void snap_sidechain_filters(Gua76* self) {
+    self->sc_hpf_freq_current = self->controls.sc_hpf_freq;
+    self->sc_lpf_freq_current = self->controls.sc_lpf_freq;
+    self->sc_filter_q_current = self->controls.sc_filter_q;
+    self->sc_filter_ramping = false;
+    update_sidechain_filter_coeffs(self);
+}
 
-    // --- Aggiornamento dei Meter (a fine blocco) ---
-    // GR Meter (prende il massimo della GR tra L/Mid e R/Side, in dB)
-    float max_gr = fmaxf(self->current_gr_linear_l, self->current_gr_linear_r);
-    *self->peak_gr_ptr = to_db(max_gr); // GR è mostrata come valore negativo (es. -6dB)
-
-    // Input/Output Peak Meters (utilizzano la funzione calculate_peak_level)
-    self->peak_in_linear_l = calculate_peak_level(in_l, sample_count, self->peak_in_linear_l, self->peak_meter_decay_alpha);
-    self->peak_in_linear_r = calculate_peak_level(in_r, sample_count, self->peak_in_linear_r, self->peak_meter_decay_alpha);
-    self->peak_out_linear_l = calculate_peak_level(out_l, sample_count, self->peak_out_linear_l, self->peak_meter_decay_alpha);
-    self->peak_out_linear_r = calculate_peak_level(out_r, sample_count, self->peak_out_linear_r, self->peak_meter_decay_alpha);
-
-    // Scrivi i valori dei meter ai puntatori di output per la GUI
-    *self->peak_in_l_ptr = to_db(self->peak_in_linear_l);
-    *self->peak_in_r_ptr = to_db(self->peak_in_linear_r);
-    *self->peak_out_l_ptr = to_db(self->peak_out_linear_l);
-    *self->peak_out_r_ptr = to_db(self->peak_out_linear_r);
+// Un passo della rampa dei filtri sidechain (una volta per sotto-blocco)
+static void advance_sidechain_filters(Gua76* self) {
+    const Gua76Controls* c = &self->controls;
+    const float a = self->sc_filter_smooth_alpha;
+    self->sc_hpf_freq_current += (c->sc_hpf_freq - self->sc_hpf_freq_current) * a;
+    self->sc_lpf_freq_current += (c->sc_lpf_freq - self->sc_lpf_freq_current) * a;
+    self->sc_filter_q_current += (c->sc_filter_q - self->sc_filter_q_current) * a;
+    if (fabsf(c->sc_hpf_freq - self->sc_hpf_freq_current) < 0.01f &&
+        fabsf(c->sc_lpf_freq - self->sc_lpf_freq_current) < 0.01f &&
+        fabsf(c->sc_filter_q - self->sc_filter_q_current) < 0.001f) {
+        snap_sidechain_filters(self);
+    } else {
+        update_sidechain_filter_coeffs(self);
+    }
+}
 
-    // Il meter mode dal parametro controlla quale valore la GUI mostrerà, non il plugin
-    // Quindi il plugin invia sempre tutti i valori di picco.
+// Azzera linea di ritardo e code del lookahead (cambio di ritardo, di fattore o attivazione)
+static void reset_lookahead(Gua76* self) {
+    for (int c = 0; c < self->num_channels; ++c) {
+        memset(self->lookahead_ring[c], 0, self->lookahead_max_samples * sizeof(float));
+        sliding_max_reset(&self->lookahead_peak[c]);
+        self->bypass_adaa_last[c] = 0.0f;
+    }
+    self->lookahead_pos = 0;
 }
 
-// Funzione di pulizia (liberare memoria)
-static void
-cleanup(LV2_Handle instance) {
-    Gua76* self = (Gua76*)instance;
-    free(self->oversample_buffer_l);
-    free(self->oversample_buffer_r);
-    free(self->oversample_sidechain_l);
-    free(self->oversample_sidechain_r);
-    free(self);
+// Azzera il frame di telemetria in corso (attivazione)
+static void reset_telemetry(Gua76* self) {
+    self->telemetry_num_frames = 0;
+    self->telemetry_samples = 0;
+    self->telemetry_gr_min = 1.0f;
+    self->telemetry_gr_max = 1.0f;
+    self->telemetry_peak_in = 0.0f;
+    self->telemetry_peak_out = 0.0f;
+    for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) {
+        self->telemetry_energy_in[c] = 0.0f;
+        self->telemetry_energy_out[c] = 0.0f;
+    }
 }
 
-// Funzione per restituire interfacce (come l'idle interface)
+// Azzera lo stato del DSP (detector, GR, filtri, lookahead), lasciando controlli e meter:
+// per la sospensione in silenzio e per ripartire dopo un NaN/Inf
+static void reset_dsp_state(Gua76* self) {
+    for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) {
+        self->envelope[c] = 0.0f;
+        self->current_gr_linear[c] = 1.0f;
+    }
+    self->detector_gain_prev_valid = false;
+    reset_oversampling_filters(self);
+    reset_saturation_state(self);
+    reset_sidechain_filters(self);
+    snap_sidechain_filters(self); // Coefficienti azzerati con gli stati, e nessuna rampa in corso
+    reset_lookahead(self);
+    self->io_gain_current = self->params.io_gain_target;
+}
+
+// Ritarda 'n' campioni di ogni canale di lookahead_samples attraverso la linea di ritardo.
+// Campione per campione (lettura prima della scrittura): 'in' e 'out' possono coincidere.
+static void lookahead_delay(Gua76* self, const float* const* in, float* const* out, uint32_t n) {
+    const uint32_t length = self->lookahead_samples;
+    uint32_t pos = self->lookahead_pos;
+    for (int c = 0; c < self->num_channels; ++c) {
+        float* ring = self->lookahead_ring[c];
+        const float* src = in[c];
+        float* dst = out[c];
+        pos = self->lookahead_pos;
+        for (uint32_t i = 0; i < n; ++i) {
+            const float x = src[i];
+            dst[i] = ring[pos];
+            ring[pos] = x;
+            if (++pos == length) pos = 0;
+        }
+    }
+    self->lookahead_pos = pos;
+}
+
+// Filtra con la cascata sidechain 'n' campioni di ogni canale, a gruppi di SIMD_LANES corsie
+static void sidechain_filters_process(Gua76* self, BiquadLanes* const* const* group_stages, int num_stages,
+                                      const float* const* in, float* const* out, uint32_t offset, uint32_t n) {
+    for (int g = 0; g < lane_groups(self->num_channels); ++g) {
+        const int lanes = lanes_in_group(self->num_channels, g);
+        const float* src[SIMD_LANES];
+        float* dst[SIMD_LANES];
+        for (int c = 0; c < lanes; ++c) {
+            src[c] = in[g * SIMD_LANES + c] + offset;
+            dst[c] = out[g * SIMD_LANES + c] + offset;
+        }
+        biquad_lanes_process_block(group_stages[g], num_stages, src, dst, lanes, n);
+    }
+}
+
+// Envelope detector di un canale (peak detector ispirato al 1176 con tempi program-dependent).
+// Scrive l'envelope e l'alpha di attacco di ogni campione; 'env_out' può coincidere con 'sc'.
+static void detector_process(const DetectorAlphaTable* attack_table, const DetectorAlphaTable* release_table,
+                             float* envelope, const float* sc, float* env_out, float* attack_alpha_out, uint32_t n) {
+    float env = *envelope;
+    for (uint32_t i = 0; i < n; ++i) {
+        // L'1176 è un peak detector, con tempi di attacco e rilascio che dipendono dal segnale.
+        // Più alto il segnale, più veloce il tempo effettivo (tabella per blocco).
+        const float current_abs = fabsf(sc[i]);
+        const float attack_alpha = detector_alpha_lookup(attack_table, fast_min(1.0f, current_abs * 2.0f));
+        const float release_alpha = detector_alpha_lookup(release_table, fast_min(1.0f, env * 0.5f));
+
+        if (current_abs > env) {
+            env = (env * (1.0f - attack_alpha)) + (current_abs * attack_alpha);
+        } else {
+            env = (env * (1.0f - release_alpha)) + (current_abs * release_alpha);
+        }
+        env_out[i] = env;
+        attack_alpha_out[i] = attack_alpha;
+    }
+    *envelope = env;
+}
+
+// Come detector_process, su due canali nello stesso loop: le due catene seriali (envelope ->
+// alpha di rilascio -> envelope) sono indipendenti e la CPU le sovrappone.
+static void detector_process_pair(const DetectorAlphaTable* attack_table, const DetectorAlphaTable* release_table,
+                                  float* envelope, const float* const* sc, float* const* env_out,
+                                  float* const* attack_alpha_out, uint32_t n) {
+    float env_a = envelope[0];
+    float env_b = envelope[1];
+    const float* sc_a = sc[0];
+    const float* sc_b = sc[1];
+    float* out_a = env_out[0];
+    float* out_b = env_out[1];
+    float* alpha_a = attack_alpha_out[0];
+    float* alpha_b = attack_alpha_out[1];
+    for (uint32_t i = 0; i < n; ++i) {
+        const float abs_a = fabsf(sc_a[i]);
+        const float abs_b = fabsf(sc_b[i]);
+        const float attack_a = detector_alpha_lookup(attack_table, fast_min(1.0f, abs_a * 2.0f));
+        const float attack_b = detector_alpha_lookup(attack_table, fast_min(1.0f, abs_b * 2.0f));
+        const float release_a = detector_alpha_lookup(release_table, fast_min(1.0f, env_a * 0.5f));
+        const float release_b = detector_alpha_lookup(release_table, fast_min(1.0f, env_b * 0.5f));
+        const float a = (abs_a > env_a) ? attack_a : release_a;
+        const float b = (abs_b > env_b) ? attack_b : release_b;
+        env_a = (env_a * (1.0f - a)) + (abs_a * a);
+        env_b = (env_b * (1.0f - b)) + (abs_b * b);
+        out_a[i] = env_a;
+        out_b[i] = env_b;
+        alpha_a[i] = attack_a;
+        alpha_b[i] = attack_b;
+    }
+    envelope[0] = env_a;
+    envelope[1] = env_b;
+}
+
+// Ritardo (in campioni alla frequenza interna) che riallinea il gain del detector a frequenza
+// ridotta all'audio: il sidechain non passa dagli ultimi stadi half-band, mentre l'interpolazione
+// lineare porta ogni gain alla fine del suo gruppo di campioni (factor - 1 campioni di ritardo).
+static uint32_t detector_gain_delay(const HalfbandCoeffs* coeffs, int os_num_stages, int detector_os_stages) {
+    double skipped = 0.0;
+    for (int st = detector_os_stages; st < os_num_stages; ++st) {
+        skipped += coeffs[st].group_delay * (double)(1 << (os_num_stages - st - 1));
+    }
+    const double delay = skipped - (double)((1 << (os_num_stages - detector_os_stages)) - 1);
+    if (delay <= 0.0) return 0;
+    const uint32_t rounded = (uint32_t)(delay + 0.5);
+    return (rounded < DETECTOR_GAIN_MAX_DELAY) ? rounded : DETECTOR_GAIN_MAX_DELAY;
+}
+
+// Registro delle banche, una per frequenza di campionamento
+static pthread_mutex_t coeff_bank_mutex = PTHREAD_MUTEX_INITIALIZER;
+static CoeffBank* coeff_bank_list = NULL;
+
+static void coeff_bank_build(CoeffBank* bank, double samplerate) {
+    bank->samplerate = samplerate;
+    for (int i = 0; i < OS_MAX_HALFBAND_STAGES; ++i) {
+        halfband_design(&bank->halfband[i], HALFBAND_STAGE_NUM_COEFS[i], HALFBAND_STAGE_TRANSITION[i]);
+    }
+    for (int st = 0; st <= OS_MAX_HALFBAND_STAGES; ++st) {
+        CoeffBankRate* r = &bank->rates[st];
+        const double rate = samplerate * (1 << st);
+        r->gain_smooth_alpha = 1.0f - expf(-1.0f / (rate * (GAIN_SMOOTH_MS / 1000.0f)));
+        r->sc_filter_smooth_alpha = 1.0f - expf(-(float)SC_FILTER_SMOOTH_BLOCK / (rate * (SC_FILTER_SMOOTH_MS / 1000.0f)));
+        for (int det = 0; det <= st; ++det) r->detector_gain_delay[det] = detector_gain_delay(bank->halfband, st, det);
+    }
+}
+
+// Restituisce la banca per questa frequenza (creandola se è la prima istanza), NULL senza memoria
+static const CoeffBank* coeff_bank_acquire(double samplerate) {
+    pthread_mutex_lock(&coeff_bank_mutex);
+    CoeffBank* bank = coeff_bank_list;
+    while (bank && bank->samplerate != samplerate) bank = bank->next;
+    if (!bank) {
+        bank = (CoeffBank*)calloc(1, sizeof(CoeffBank));
+        if (bank) {
+            coeff_bank_build(bank, samplerate);
+            bank->next = coeff_bank_list;
+            coeff_bank_list = bank;
+        }
+    }
+    if (bank) bank->refcount++;
+    pthread_mutex_unlock(&coeff_bank_mutex);
+    return bank;
+}
+
+static void coeff_bank_release(const CoeffBank* released) {
+    if (!released) return;
+    pthread_mutex_lock(&coeff_bank_mutex);
+    for (CoeffBank** link = &coeff_bank_list; *link; link = &(*link)->next) {
+        CoeffBank* bank = *link;
+        if (bank != released) continue;
+        if (--bank->refcount == 0) {
+            *link = bank->next;
+            free(bank);
+        }
+        break;
+    }
+    pthread_mutex_unlock(&coeff_bank_mutex);
+}
+
+// Detector a frequenza ridotta: porta 'n' valori di gain a n * factor campioni della frequenza
+// interna per interpolazione lineare (l'ultimo sotto-campione vale esattamente il nuovo gain).
+// Sul posto, all'indietro: ogni valore viene letto prima di essere sovrascritto. 'prev' è il gain
+// finale del blocco precedente e viene aggiornato.
+static void gain_interpolate_up(float* gain, uint32_t n, uint32_t factor, float* prev) {
+    const float step = 1.0f / (float)factor;
+    const float last = gain[n - 1];
+    for (uint32_t j = n; j-- > 0;) {
+        const float g1 = gain[j];
+        const float delta = g1 - ((j > 0) ? gain[j - 1] : *prev);
+        float* dst = gain + j * factor;
+        for (uint32_t r = 1; r < factor; ++r) dst[r - 1] = g1 - delta * (float)(factor - r) * step;
+        dst[factor - 1] = g1;
+    }
+    *prev = last;
+}
+
+// Linea di ritardo circolare del gain (uno stato per detector, stessa posizione per tutti)
+static void gain_delay_process(float* gain, uint32_t n, float* line, uint32_t delay, uint32_t pos) {
+    for (uint32_t i = 0; i < n; ++i) {
+        const float delayed = line[pos];
+        line[pos] = gain[i];
+        gain[i] = delayed;
+        if (++pos == delay) pos = 0;
+    }
+}
+
+// Libera tutti i buffer (anche parzialmente allocati) e l'istanza
+static void free_instance(Gua76* self) {
+    for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) {
+        free(self->oversample_buffer[c]);
+        free(self->oversample_sidechain[c]);
+        free(self->detector_buffer[c]);
+        free(self->attack_alpha_buffer[c]);
+        free(self->lookahead_ring[c]);
+        free(self->lookahead_buffer[c]);
+        free(self->lookahead_peak[c].value);
+        free(self->lookahead_peak[c].index);
+        free(self->meter_in_peaks[c]);
+        free(self->meter_out_peaks[c]);
+        free(self->meter_true_peaks[c]);
+    }
+    free(self->meter_gr_min);
+    free(self->meter_gr_max);
+    free(self->telemetry_frames);
+    for (int c = 0; c < 2; ++c) {
+        free(self->midside_in[c]);
+        free(self->midside_sc[c]);
+    }
+    coeff_bank_release(self->coeffs);
+    free(self);
+}
+
+// Legge la lunghezza massima dei blocchi dalle opzioni dell'host (0 se non disponibile)
+static uint32_t read_block_length_option(const LV2_Options_Option* options, LV2_URID_Map* map) {
+    if (!options || !map) return 0;
+    const LV2_URID atom_int = map->map(map->handle, LV2_ATOM__Int);
+    const LV2_URID max_block = map->map(map->handle, LV2_BUF_SIZE__maxBlockLength);
+    const LV2_URID nominal_block = map->map(map->handle, LV2_BUF_SIZE__nominalBlockLength);
+
+    uint32_t max_len = 0;
+    uint32_t nominal_len = 0;
+    for (const LV2_Options_Option* o = options; o->key || o->value; ++o) {
+        if (o->context != LV2_OPTIONS_INSTANCE || o->type != atom_int || !o->value) continue;
+        const int32_t value = *(const int32_t*)o->value;
+        if (value <= 0) continue;
+        if (o->key == max_block) max_len = (uint32_t)value;
+        else if (o->key == nominal_block) nominal_len = (uint32_t)value;
+    }
+    return max_len ? max_len : nominal_len;
+}
+
+// Varianti del plugin: stesso motore e stessi controlli, numero di canali diverso
+typedef struct {
+    const char* uri;
+    int num_channels;
+} Gua76Variant;
+
+#define NUM_VARIANTS 4
+static const Gua76Variant VARIANTS[NUM_VARIANTS] = {
+    { GUA76_URI,      2 }, // Stereo (indice 0, come prima delle varianti)
+    { GUA76_MONO_URI, 1 },
+    { GUA76_51_URI,   6 }, // L R C LFE Ls Rs
+    { GUA76_71_URI,   8 }  // L R C LFE Ls Rs Lrs Rrs
+};
+
+// Crea lo stato del DSP per 'num_channels' canali (1, 2, 6 o 8). I buffer alla frequenza dell'host
+// sono dimensionati su blocchi di block_length campioni (i blocchi più lunghi vengono suddivisi).
+// NULL se l'allocazione fallisce.
+static Gua76* create_instance(int num_channels, double samplerate, uint32_t block_length) {
+    Gua76* self = (Gua76*)calloc(1, sizeof(Gua76));
+    if (!self) return NULL;
+
+    self->num_channels = num_channels;
+    self->samplerate = samplerate;
+    self->os_num_stages = DEFAULT_OS_STAGES;
+    self->oversampled_samplerate = samplerate * (1 << DEFAULT_OS_STAGES);
+    self->detector_os_stages = DEFAULT_OS_STAGES;
+    self->detector_samplerate = self->oversampled_samplerate;
+
+    // Inizializzazione variabili di stato del compressore
+    for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) {
+        self->envelope[c] = 0.0f;
+        self->current_gr_linear[c] = 1.0f; // Inizia senza gain reduction (0dB)
+        self->peak_in_linear[c] = db_to_linear(-90.0f); // Inizializza i meter a -90dB
+        self->peak_out_linear[c] = db_to_linear(-90.0f);
+        self->true_peak_out_linear[c] = db_to_linear(-90.0f);
+    }
+
+
+    // Calcolo coefficienti di smoothing per i meter
+    self->gr_meter_alpha = 1.0f - expf(-1.0f / (self->samplerate * (GR_METER_SMOOTH_MS / 1000.0f)));
+    self->output_meter_alpha = 1.0f - expf(-1.0f / (self->samplerate * (OUTPUT_METER_SMOOTH_MS / 1000.0f)));
+    self->peak_meter_decay_alpha = 1.0f - expf(-1.0f / (self->samplerate * (PEAK_METER_DECAY_MS / 1000.0f)));
+    self->peak_meter_log_decay = (float)(-1.0 / (self->samplerate * (PEAK_METER_DECAY_MS / 1000.0)));
+    self->peak_meter_block_decay = expf(self->peak_meter_log_decay * METER_BLOCK);
+    self->silence_threshold = db_to_linear(SILENCE_THRESHOLD_DB);
+    self->silence_envelope = db_to_linear(SILENCE_ENVELOPE_DB);
+    self->silence_hold_samples = (uint32_t)(samplerate * SILENCE_HOLD_MS / 1000.0);
+
+    // Filtri half-band e costanti per frequenza: dalla banca condivisa (calcolata dalla prima istanza)
+    self->coeffs = coeff_bank_acquire(samplerate);
+    if (!self->coeffs) {
+        free_instance(self);
+        return NULL;
+    }
+
+    // Inizializzazione filtri biquad per il sidechain
+    reset_sidechain_filters(self);
+
+
+    // Buffer alla frequenza dell'host dimensionati sui blocchi dell'host, buffer dei passi di
+    // elaborazione su un micro-blocco (al massimo PIPELINE_BLOCK_OS_SAMPLES alla frequenza interna)
+    self->chunk_length = (block_length < MAX_CHUNK_LENGTH) ? block_length : MAX_CHUNK_LENGTH;
+    self->max_oversample_buffer_size = (self->chunk_length * MAX_UPSAMPLE_FACTOR < PIPELINE_BLOCK_OS_SAMPLES)
+                                       ? self->chunk_length * MAX_UPSAMPLE_FACTOR : PIPELINE_BLOCK_OS_SAMPLES;
+    // Lookahead: la finestra del massimo mobile (alla frequenza interna) arriva a
+    // lookahead_max_samples * MAX_UPSAMPLE_FACTOR + 1 campioni
+    self->lookahead_max_samples = (uint32_t)ceil(samplerate * LOOKAHEAD_MS_MAX / 1000.0);
+    if (self->lookahead_max_samples == 0) self->lookahead_max_samples = 1;
+    uint32_t peak_capacity = 1;
+    while (peak_capacity < self->lookahead_max_samples * MAX_UPSAMPLE_FACTOR + 1) peak_capacity *= 2;
+    const uint32_t meter_blocks = (self->chunk_length + METER_BLOCK - 1) / METER_BLOCK;
+    bool allocated = true;
+    for (int c = 0; c < num_channels; ++c) {
+        self->lookahead_ring[c] = (float*)calloc(self->lookahead_max_samples, sizeof(float));
+        self->lookahead_buffer[c] = (float*)calloc(self->chunk_length, sizeof(float));
+        self->lookahead_peak[c].value = (float*)calloc(peak_capacity, sizeof(float));
+        self->lookahead_peak[c].index = (uint32_t*)calloc(peak_capacity, sizeof(uint32_t));
+        self->lookahead_peak[c].mask = peak_capacity - 1;
+        allocated = allocated && self->lookahead_ring[c] && self->lookahead_buffer[c] &&
+                    self->lookahead_peak[c].value && self->lookahead_peak[c].index;
+        self->meter_in_peaks[c] = (float*)calloc(meter_blocks, sizeof(float));
+        self->meter_out_peaks[c] = (float*)calloc(meter_blocks, sizeof(float));
+        self->meter_true_peaks[c] = (float*)calloc(meter_blocks, sizeof(float));
+        allocated = allocated && self->meter_in_peaks[c] && self->meter_out_peaks[c] && self->meter_true_peaks[c];
+        self->oversample_buffer[c] = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
+        self->oversample_sidechain[c] = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
+        self->detector_buffer[c] = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
+        self->attack_alpha_buffer[c] = (float*)calloc(self->max_oversample_buffer_size, sizeof(float));
+        allocated = allocated && self->oversample_buffer[c] && self->oversample_sidechain[c] &&
+                    self->detector_buffer[c] && self->attack_alpha_buffer[c];
+    }
+    if (num_channels == 2) {
+        for (int c = 0; c < 2; ++c) {
+            self->midside_in[c] = (float*)calloc(pipeline_block_length(self, 0), sizeof(float));
+            self->midside_sc[c] = (float*)calloc(pipeline_block_length(self, 0), sizeof(float));
+            allocated = allocated && self->midside_in[c] && self->midside_sc[c];
+        }
+    }
+    self->meter_gr_min = (float*)calloc(meter_blocks, sizeof(float));
+    self->meter_gr_max = (float*)calloc(meter_blocks, sizeof(float));
+    self->telemetry_max_frames = self->chunk_length / TELEMETRY_FRAME_LENGTH + 1;
+    self->telemetry_frames = (float*)calloc(self->telemetry_max_frames * GUA76_TELEMETRY_FIELDS, sizeof(float));
+    allocated = allocated && self->meter_gr_min && self->meter_gr_max && self->telemetry_frames;
+
+    if (!allocated) {
+        free_instance(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+// Telemetria sulla porta notify: senza urid:map (o senza chiamare questa funzione) resta spenta
+static void enable_telemetry(Gua76* self, LV2_URID_Map* map) {
+    lv2_atom_forge_init(&self->forge, map);
+    self->telemetry_urid = map->map(map->handle, GUA76_TELEMETRY_URI);
+    self->telemetry_frame_length_urid = map->map(map->handle, GUA76_TELEMETRY_FRAME_LENGTH_URI);
+    self->telemetry_frames_urid = map->map(map->handle, GUA76_TELEMETRY_FRAMES_URI);
+    self->telemetry_available = true;
+}
+
+// Azzera lo stato del DSP (attivazione): detector, meter, filtri e linee di ritardo
+static void reset_instance(Gua76* self) {
+    for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) {
+        self->envelope[c] = 0.0f;
+        self->current_gr_linear[c] = 1.0f;
+        self->peak_in_linear[c] = db_to_linear(-90.0f);
+        self->peak_out_linear[c] = db_to_linear(-90.0f);
+        self->true_peak_out_linear[c] = db_to_linear(-90.0f);
+    }
+    self->gr_meter_db = 0.0f;
+
+    // Reinitalizza stati interni dei filtri (cruciale per prevenire clicks e rumori)
+    self->os_num_stages = -1; // Forza il ricalcolo di fattore, filtri e coefficienti al primo run()
+    self->controls.valid = false; // Forza il ricalcolo dei valori derivati (e nessuna rampa) al primo run()
+    reset_oversampling_filters(self); // Per i filtri OS
+    reset_saturation_state(self);
+    reset_sidechain_filters(self);
+    reset_lookahead(self);
+    reset_telemetry(self);
+    self->silent_samples = 0;
+    self->sleeping = false;
+}
+
+
+// Massimi di |x| per sotto-blocchi di METER_BLOCK campioni (quando non c'è un passo in cui raccoglierli)
+static void meter_measure(const float* x, uint32_t n, float* peaks) {
+    for (uint32_t pos = 0, k = 0; pos < n; pos += METER_BLOCK, ++k) {
+        peaks[k] = peak_abs(x + pos, (n - pos < METER_BLOCK) ? n - pos : METER_BLOCK);
+    }
+}
+
+// Aggiorna un peak meter con i massimi per sotto-blocco di 'n' campioni: il picco precedente
+// decade in forma chiusa sui campioni trascorsi (hold e decadimento, tipico dei meter analogici).
+static float meter_fold(const Gua76* self, float peak, const float* peaks, uint32_t n) {
+    for (uint32_t pos = 0, k = 0; pos < n; pos += METER_BLOCK, ++k) {
+        const uint32_t len = (n - pos < METER_BLOCK) ? n - pos : METER_BLOCK;
+        const float decay = (len == METER_BLOCK) ? self->peak_meter_block_decay : fast_exp(self->peak_meter_log_decay * (float)len);
+        peak = fast_max(peaks[k], peak * decay);
+    }
+    return peak;
+}
+
+// Accumula i sotto-blocchi di un chunk (massimi già raccolti per i meter, GR in meter_gr_min/max)
+// nel frame di telemetria corrente; i frame completati finiscono in telemetry_frames (in dB).
+// 'in'/'out' sono i campioni L/R del chunk, per l'energia (RMS).
+static void telemetry_collect(Gua76* self, const float* const* in, const float* const* out, uint32_t n) {
+    const int num_channels = self->num_channels;
+    for (uint32_t pos = 0, k = 0; pos < n; pos += METER_BLOCK, ++k) {
+        const uint32_t len = (n - pos < METER_BLOCK) ? n - pos : METER_BLOCK;
+        if (self->telemetry_samples == 0) {
+            self->telemetry_gr_min = self->meter_gr_min[k];
+            self->telemetry_gr_max = self->meter_gr_max[k];
+        } else {
+            self->telemetry_gr_min = fast_min(self->telemetry_gr_min, self->meter_gr_min[k]);
+            self->telemetry_gr_max = fast_max(self->telemetry_gr_max, self->meter_gr_max[k]);
+        }
+        for (int c = 0; c < num_channels; ++c) {
+            self->telemetry_peak_in = fast_max(self->telemetry_peak_in, self->meter_in_peaks[c][k]);
+            self->telemetry_peak_out = fast_max(self->telemetry_peak_out, self->meter_out_peaks[c][k]);
+            self->telemetry_energy_in[c] += sum_squares(in[c] + pos, len);
+            self->telemetry_energy_out[c] += sum_squares(out[c] + pos, len);
+        }
+        self->telemetry_samples += len;
+        if (self->telemetry_samples < TELEMETRY_FRAME_LENGTH) continue;
+
+        // Frame completo (se il chunk ne ha già prodotti troppi viene scartato)
+        if (self->telemetry_num_frames < self->telemetry_max_frames) {
+            float energy_in = 0.0f;
+            float energy_out = 0.0f;
+            for (int c = 0; c < num_channels; ++c) {
+                energy_in = fast_max(energy_in, self->telemetry_energy_in[c]);
+                energy_out = fast_max(energy_out, self->telemetry_energy_out[c]);
+            }
+            const float inv_samples = 1.0f / (float)self->telemetry_samples;
+            float* frame = self->telemetry_frames + self->telemetry_num_frames++ * GUA76_TELEMETRY_FIELDS;
+            frame[GUA76_TELEMETRY_GR_MIN] = to_db(self->telemetry_gr_min);
+            frame[GUA76_TELEMETRY_GR_MAX] = to_db(self->telemetry_gr_max);
+            frame[GUA76_TELEMETRY_PEAK_IN] = to_db(self->telemetry_peak_in);
+            frame[GUA76_TELEMETRY_PEAK_OUT] = to_db(self->telemetry_peak_out);
+            frame[GUA76_TELEMETRY_RMS_IN] = to_db(sqrtf(energy_in * inv_samples));
+            frame[GUA76_TELEMETRY_RMS_OUT] = to_db(sqrtf(energy_out * inv_samples));
+        }
+        self->telemetry_samples = 0;
+        self->telemetry_peak_in = 0.0f;
+        self->telemetry_peak_out = 0.0f;
+        for (int c = 0; c < num_channels; ++c) {
+            self->telemetry_energy_in[c] = 0.0f;
+            self->telemetry_energy_out[c] = 0.0f;
+        }
+    }
+}
+
+// Scrive i frame di telemetria completati come un evento (all'istante 'frame_time' del blocco)
+// nella sequenza della porta notify. Se lo spazio fornito dall'host non basta i frame vanno persi.
+static void telemetry_write(Gua76* self, uint32_t frame_time) {
+    const uint32_t num_frames = self->telemetry_num_frames;
+    self->telemetry_num_frames = 0;
+    if (num_frames == 0 || !self->telemetry_active) return;
+
+    const uint32_t num_values = num_frames * GUA76_TELEMETRY_FIELDS;
+    const uint32_t event_size = (uint32_t)(sizeof(int64_t) + sizeof(LV2_Atom_Object) +
+                                           2 * sizeof(uint32_t) + lv2_atom_pad_size(sizeof(LV2_Atom_Int)) +
+                                           2 * sizeof(uint32_t) + lv2_atom_pad_size(sizeof(LV2_Atom_Vector) + num_values * sizeof(float)));
+    LV2_Atom_Forge* forge = &self->forge;
+    if (forge->size - forge->offset < event_size) return;
+
+    LV2_Atom_Forge_Frame frame;
+    lv2_atom_forge_frame_time(forge, frame_time);
+    lv2_atom_forge_object(forge, &frame, 0, self->telemetry_urid);
+    lv2_atom_forge_key(forge, self->telemetry_frame_length_urid);
+    lv2_atom_forge_int(forge, TELEMETRY_FRAME_LENGTH);
+    lv2_atom_forge_key(forge, self->telemetry_frames_urid);
+    lv2_atom_forge_vector(forge, sizeof(float), forge->Float, num_values, self->telemetry_frames);
+    lv2_atom_forge_pop(forge, &frame);
+}
+
+// Meter di cui process_stages ha già raccolto i massimi per sotto-blocco
+typedef struct {
+    bool in_measured;
+    bool out_measured;
+    bool true_peak_measured;
+} StageMeters;
+
+// Passi di elaborazione su un micro-blocco: codifica M/S, upsampling, filtri sidechain, detector,
+// gain computer, gain e saturazione, downsampling e decodifica M/S. Ogni passo percorre tutto il
+// micro-blocco prima del successivo (loop semplici e vettorizzabili); il micro-blocco è corto
+// abbastanza (pipeline_block_length) da far restare i buffer intermedi in L1.
+// I massimi per i meter vanno nei sotto-blocchi da 'meter_offset' in poi; il valore restituito
+// dice quali sono stati raccolti.
+static StageMeters process_stages(Gua76* self, const Gua76ChunkParams* params,
+                                  const float* const* in, const float* const* sc_in, float* const* out,
+                                  uint32_t sample_count, uint32_t meter_offset) {
+    const int   num_channels = self->num_channels;
+    const int   os_num_stages = params->os_num_stages;
+    const uint32_t os_factor = 1u << os_num_stages;
+    const int   detector_os_stages = params->detector_os_stages;
+    const uint32_t detector_factor = 1u << detector_os_stages;
+    const bool  reduced_detector_rate = (detector_os_stages < os_num_stages);
+    const bool  is_all_button_mode = params->is_all_button_mode;
+    const bool  external_sidechain = params->external_sidechain;
+    const bool  sc_hpf_on = params->sc_hpf_on;
+    const bool  sc_lpf_on = params->sc_lpf_on;
+    const bool  sidechain_listen = params->sidechain_listen;
+    const bool  midside_mode_on = params->midside_mode_on;
+    const bool  midside_link = params->midside_link;
+    const bool  linked = (params->detector_link != DETECTOR_LINK_INDEPENDENT);
+    const bool  lookahead = (self->lookahead_samples > 0);
+    // Con il lookahead il sidechain (non ritardato) differisce dall'audio anche senza ingresso esterno
+    const bool  separate_sidechain = external_sidechain || lookahead;
+
+    float* meter_in_peaks[GUA76_MAX_CHANNELS];
+    float* meter_out_peaks[GUA76_MAX_CHANNELS];
+    float* meter_true_peaks[GUA76_MAX_CHANNELS];
+    for (int c = 0; c < num_channels; ++c) {
+        meter_in_peaks[c] = self->meter_in_peaks[c] + meter_offset;
+        meter_out_peaks[c] = self->meter_out_peaks[c] + meter_offset;
+        meter_true_peaks[c] = self->meter_true_peaks[c] + meter_offset;
+    }
+    float* meter_gr_min = self->meter_gr_min + meter_offset;
+    float* meter_gr_max = self->meter_gr_max + meter_offset;
+
+    // Meter: quali massimi per sotto-blocco sono già stati raccolti nei passi di elaborazione
+    bool in_measured = midside_mode_on; // In M/S l'ingresso si misura durante la codifica
+    bool out_measured = false;
+    bool true_peak_measured = false;
+
+    const float* chunk_in[GUA76_MAX_CHANNELS];
+    const float* chunk_sc[GUA76_MAX_CHANNELS];
+    for (int c = 0; c < num_channels; ++c) {
+        chunk_in[c] = in[c];
+        chunk_sc[c] = sc_in[c];
+    }
+
+    // --- Mid-Side Encoding (se attivo, solo stereo) ---
+    if (midside_mode_on) {
+        float* temp_in_l = self->midside_in[0];
+        float* temp_in_r = self->midside_in[1];
+        float* temp_sc_l = self->midside_sc[0];
+        float* temp_sc_r = self->midside_sc[1];
+        // Il meter di ingresso misura L/R qui, prima della codifica
+        for (uint32_t start = 0, k = 0; start < sample_count; start += METER_BLOCK, ++k) {
+            const uint32_t end = (sample_count - start < METER_BLOCK) ? sample_count : start + METER_BLOCK;
+            float peak_l = 0.0f;
+            float peak_r = 0.0f;
+            for (uint32_t i = start; i < end; ++i) {
+                const float in_l = chunk_in[0][i], in_r = chunk_in[1][i];
+                const float sc_l = chunk_sc[0][i], sc_r = chunk_sc[1][i];
+                temp_in_l[i] = (in_l + in_r) * 0.5f; // Mid
+                temp_in_r[i] = (in_l - in_r) * 0.5f; // Side
+                temp_sc_l[i] = (sc_l + sc_r) * 0.5f; // Mid Sidechain
+                temp_sc_r[i] = (sc_l - sc_r) * 0.5f; // Side Sidechain
+                peak_l = fast_max(peak_l, fabsf(in_l));
+                peak_r = fast_max(peak_r, fabsf(in_r));
+            }
+            meter_in_peaks[0][k] = peak_l;
+            meter_in_peaks[1][k] = peak_r;
+        }
+        chunk_in[0] = temp_in_l;
+        chunk_in[1] = temp_in_r;
+        chunk_sc[0] = temp_sc_l;
+        chunk_sc[1] = temp_sc_r;
+    }
+
+
+    // --- Loop di elaborazione sul micro-blocco ---
+    // I passaggi: Upsample input (polifase) -> Process (OS) -> Downsample output (polifase)
+    // A 1x il loop legge direttamente dagli ingressi e scrive sulle uscite.
+    // Sidechain, detector e GR lavorano su detector_buffer_size campioni (frequenza del detector).
+    const uint32_t current_oversample_buffer_size = sample_count * os_factor;
+    const uint32_t detector_buffer_size = sample_count * detector_factor;
+
+    const float* proc_in[GUA76_MAX_CHANNELS];
+    const float* proc_sc[GUA76_MAX_CHANNELS];
+    float* proc_out[GUA76_MAX_CHANNELS];
+    for (int c = 0; c < num_channels; ++c) {
+        proc_in[c] = chunk_in[c];
+        proc_sc[c] = chunk_sc[c];
+        proc_out[c] = out[c];
+    }
+
+    if (os_num_stages > 0) {
+        // Upsample polifase (half-band 2x -> ... -> os_factor), la storia dei filtri prosegue tra i blocchi
+        // Audio e sidechain vengono elaborati insieme nelle corsie SIMD, a gruppi di 4 canali. Senza
+        // sidechain esterno il sidechain coincide con l'ingresso e non serve sovracampionarlo due volte.
+        // Con il detector a frequenza ridotta il sidechain viene sovracampionato a parte, sotto.
+        const float* up_in[2 * GUA76_MAX_CHANNELS];
+        float* up_out[2 * GUA76_MAX_CHANNELS];
+        int num_up = 0;
+        for (int c = 0; c < num_channels; ++c) {
+            up_in[num_up] = chunk_in[c];
+            up_out[num_up++] = self->oversample_buffer[c];
+        }
+        if (separate_sidechain && !reduced_detector_rate) {
+            for (int c = 0; c < num_channels; ++c) {
+                up_in[num_up] = chunk_sc[c];
+                up_out[num_up++] = self->oversample_sidechain[c];
+            }
+        }
+        // Il meter di ingresso raccoglie i massimi dai campioni letti qui (corsie sidechain escluse)
+        float* up_peaks[2 * GUA76_MAX_CHANNELS];
+        for (int k = 0; k < num_up; ++k) up_peaks[k] = (k < num_channels) ? meter_in_peaks[k] : NULL;
+        for (int g = 0; g < lane_groups(num_up); ++g) {
+            oversample_up_lanes(self->coeffs->halfband, self->upsample_lanes[g], os_num_stages,
+                                up_in + g * SIMD_LANES, up_out + g * SIMD_LANES, lanes_in_group(num_up, g), sample_count,
+                                in_measured ? NULL : up_peaks + g * SIMD_LANES);
+        }
+        in_measured = true;
+
+        for (int c = 0; c < num_channels; ++c) {
+            proc_in[c] = proc_out[c] = self->oversample_buffer[c];
+            if (!reduced_detector_rate) {
+                proc_sc[c] = separate_sidechain ? self->oversample_sidechain[c] : self->oversample_buffer[c];
+            }
+        }
+    }
+
+    // Sidechain alla frequenza ridotta del detector: quello dell'host (già in proc_sc) o sovracampionato
+    // con i soli primi detector_os_stages stadi half-band, in gruppi di stato separati
+    if (reduced_detector_rate && detector_os_stages > 0) {
+        float* up_out[GUA76_MAX_CHANNELS];
+        for (int c = 0; c < num_channels; ++c) up_out[c] = self->oversample_sidechain[c];
+        for (int g = 0; g < lane_groups(num_channels); ++g) {
+            oversample_up_lanes(self->coeffs->halfband, self->upsample_lanes[MAX_CHANNEL_LANE_GROUPS + g],
+                                detector_os_stages, chunk_sc + g * SIMD_LANES, up_out + g * SIMD_LANES,
+                                lanes_in_group(num_channels, g), sample_count, NULL);
+        }
+        for (int c = 0; c < num_channels; ++c) proc_sc[c] = self->oversample_sidechain[c];
+    }
+
+
+    float* const* detector = self->detector_buffer;
+    float* const* attack_alpha = self->attack_alpha_buffer;
+
+    // --- Passo 1a: Filtri Sidechain (alla frequenza del detector, i canali insieme nelle corsie SIMD) ---
+    // Il sidechain filtrato viene scritto nei buffer del detector, che il passo 1b legge e sovrascrive.
+    const float* det_src[GUA76_MAX_CHANNELS];
+    for (int c = 0; c < num_channels; ++c) det_src[c] = proc_sc[c];
+    BiquadLanes* sc_stages[MAX_CHANNEL_LANE_GROUPS][BIQUAD_LANES_MAX_STAGES];
+    BiquadLanes* const* group_stages[MAX_CHANNEL_LANE_GROUPS];
+    int num_sc_stages = 0;
+    for (int g = 0; g < MAX_CHANNEL_LANE_GROUPS; ++g) {
+        int k_stage = 0;
+        if (sc_hpf_on) {
+            for (int k = 0; k < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++k) sc_stages[g][k_stage++] = &self->sc_hpf_lanes[g][k];
+        }
+        if (sc_lpf_on) {
+            for (int k = 0; k < NUM_BIQUADS_FOR_SIDECHAIN_FILTER; ++k) sc_stages[g][k_stage++] = &self->sc_lpf_lanes[g][k];
+        }
+        group_stages[g] = sc_stages[g];
+        num_sc_stages = k_stage;
+    }
+    if (num_sc_stages > 0) {
+        // Durante una rampa i coefficienti vengono aggiornati ogni SC_FILTER_SMOOTH_BLOCK campioni
+        uint32_t pos = 0;
+        while (self->sc_filter_ramping && pos < detector_buffer_size) {
+            const uint32_t remaining = detector_buffer_size - pos;
+            const uint32_t len = (remaining < SC_FILTER_SMOOTH_BLOCK) ? remaining : SC_FILTER_SMOOTH_BLOCK;
+            advance_sidechain_filters(self);
+            sidechain_filters_process(self, group_stages, num_sc_stages, proc_sc, detector, pos, len);
+            pos += len;
+        }
+        if (pos < detector_buffer_size) {
+            sidechain_filters_process(self, group_stages, num_sc_stages, proc_sc, detector, pos,
+                                      detector_buffer_size - pos);
+        }
+        for (int c = 0; c < num_channels; ++c) det_src[c] = detector[c];
+    } else if (self->sc_filter_ramping) {
+        snap_sidechain_filters(self); // Filtri spenti: nessuna rampa udibile
+    }
+
+    // Se Sidechain Listen è attivo, il segnale sidechain processato va direttamente in uscita
+    // (prima del detector, che sovrascrive i buffer; il passo 3 non tocca l'uscita in questo caso).
+    // Con Sidechain Listen il detector è sempre alla frequenza interna.
+    if (sidechain_listen) {
+        for (int c = 0; c < num_channels; ++c) {
+            if (proc_out[c] != det_src[c]) memcpy(proc_out[c], det_src[c], current_oversample_buffer_size * sizeof(float));
+        }
+    }
+
+    // --- Passo 1b: Envelope Detector (alla frequenza del detector, sequenziale per canale) ---
+    // Con il lookahead il detector riceve il massimo di |sidechain| sulla finestra di lookahead
+    const uint32_t lookahead_window = self->lookahead_samples * detector_factor + 1;
+    int num_detectors = num_channels;
+    if (linked) {
+        // Detector linkato: un solo envelope sul massimo (o sulla media) dei canali rettificati,
+        // così l'immagine multicanale non si sposta quando un canale comprime più degli altri.
+        float* link = detector[0];
+        for (uint32_t i = 0; i < detector_buffer_size; ++i) link[i] = fabsf(det_src[0][i]);
+        if (params->detector_link == DETECTOR_LINK_MAX) {
+            for (int c = 1; c < num_channels; ++c) {
+                const float* src = det_src[c];
+                for (uint32_t i = 0; i < detector_buffer_size; ++i) link[i] = fast_max(link[i], fabsf(src[i]));
+            }
+        } else {
+            for (int c = 1; c < num_channels; ++c) {
+                const float* src = det_src[c];
+                for (uint32_t i = 0; i < detector_buffer_size; ++i) link[i] += fabsf(src[i]);
+            }
+            const float scale = 1.0f / (float)num_channels;
+            for (uint32_t i = 0; i < detector_buffer_size; ++i) link[i] *= scale;
+        }
+        if (lookahead) {
+            sliding_max_process(&self->lookahead_peak[0], lookahead_window, link, link, detector_buffer_size);
+        }
+        detector_process(&self->attack_alpha_table, &self->release_alpha_table, &self->envelope[0],
+                         link, link, attack_alpha[0], detector_buffer_size);
+        num_detectors = 1;
+    } else {
+        if (lookahead) {
+            for (int c = 0; c < num_channels; ++c) {
+                sliding_max_process(&self->lookahead_peak[c], lookahead_window, det_src[c], detector[c],
+                                    detector_buffer_size);
+                det_src[c] = detector[c];
+            }
+        }
+        int c = 0;
+        for (; c + 1 < num_channels; c += 2) {
+            detector_process_pair(&self->attack_alpha_table, &self->release_alpha_table, &self->envelope[c],
+                                  det_src + c, detector + c, attack_alpha + c, detector_buffer_size);
+        }
+        if (c < num_channels) {
+            detector_process(&self->attack_alpha_table, &self->release_alpha_table, &self->envelope[c],
+                             det_src[c], detector[c], attack_alpha[c], detector_buffer_size);
+        }
+        if (midside_mode_on && midside_link) {
+            // Se Mid-Side e Link attivo, il detector usa il massimo tra M e S
+            for (uint32_t i = 0; i < detector_buffer_size; ++i) {
+                const float linked_env = fast_max(detector[0][i], detector[1][i]);
+                detector[0][i] = linked_env;
+                detector[1][i] = linked_env; // Linka il detector anche per Side
+            }
+        }
+    }
+
+    // --- Passo 2: Gain Computer (kernel a blocco, envelope -> gain lineare, in-place) ---
+    for (int d = 0; d < num_detectors; ++d) {
+        gain_computer_process(&params->gain, detector[d], detector_buffer_size);
+    }
+
+    // --- Passo 3a: Smoothing della GR per detector, combinata con l'input/output gain ---
+    // L'input/output gain segue il controllo con una rampa per campione (solo se è cambiato).
+    // Il buffer del detector contiene poi il gain complessivo da applicare a ogni campione.
+    // La GR minima/massima di ogni sotto-blocco dei meter va alla telemetria.
+    // Senza rampa il kernel non aggiorna affatto l'input/output gain (variante senza rampa).
+    const float io_gain_target = params->io_gain_target;
+    const float gain_alpha = self->gain_smooth_alpha;
+    const bool  gain_ramping = (self->io_gain_current != io_gain_target);
+    const uint32_t gr_meter_block = METER_BLOCK * detector_factor;
+    const uint32_t num_gr_blocks = (detector_buffer_size + gr_meter_block - 1) / gr_meter_block;
+    for (uint32_t k = 0; k < num_gr_blocks; ++k) {
+        meter_gr_min[k] = 1.0f;
+        meter_gr_max[k] = 0.0f;
+    }
+    const GrSmoothKernel gr_smooth = GR_SMOOTH_KERNELS[gain_ramping ? 1 : 0];
+    float io_gain_linear = self->io_gain_current;
+    for (int d = 0; d < num_detectors; ++d) {
+        io_gain_linear = self->io_gain_current; // Ogni detector percorre la stessa rampa
+        gr_smooth(detector[d], attack_alpha[d], detector_buffer_size, gr_meter_block,
+                  &self->current_gr_linear[d], &io_gain_linear, io_gain_target, gain_alpha,
+                  meter_gr_min, meter_gr_max);
+    }
+    if (linked) {
+        for (int c = 1; c < num_channels; ++c) self->current_gr_linear[c] = self->current_gr_linear[0];
+    }
+    if (gain_ramping && fabsf(io_gain_target - io_gain_linear) <= io_gain_target * 1e-5f) {
+        io_gain_linear = io_gain_target; // Rampa conclusa
+    }
+    self->io_gain_current = io_gain_linear;
+
+    // --- Passo 3a': gain del detector a frequenza ridotta interpolato fino alla frequenza interna ---
+    if (reduced_detector_rate) {
+        const uint32_t factor = os_factor / detector_factor;
+        const uint32_t delay = self->detector_gain_delay;
+        if (!self->detector_gain_prev_valid) self->detector_gain_delay_pos = 0;
+        const uint32_t delay_pos = self->detector_gain_delay_pos;
+        for (int d = 0; d < num_detectors; ++d) {
+            float* line = self->detector_gain_delay_line[d];
+            if (!self->detector_gain_prev_valid) {
+                self->detector_gain_prev[d] = detector[d][0];
+                for (uint32_t k = 0; k < delay; ++k) line[k] = detector[d][0];
+            }
+            gain_interpolate_up(detector[d], detector_buffer_size, factor, &self->detector_gain_prev[d]);
+            if (delay > 0) gain_delay_process(detector[d], current_oversample_buffer_size, line, delay, delay_pos);
+        }
+        if (delay > 0) self->detector_gain_delay_pos = (delay_pos + current_oversample_buffer_size) % delay;
+        self->detector_gain_prev_valid = true;
+    }
+
+    // --- Passo 3b: Applicazione del gain e saturazione, per canale ---
+    // Per sotto-blocchi di METER_BLOCK campioni (dell'host): i massimi per i meter si leggono
+    // mentre il sotto-blocco è ancora in cache. Sovracampionato: picco inter-campione dell'uscita;
+    // a 1x: picco di ingresso e di uscita (fuori dalla codifica M/S). Il kernel è specializzato
+    // per All-Button e per i meter da misurare.
+    if (!sidechain_listen) { // Altrimenti l'uscita contiene già il sidechain processato
+        const uint32_t meter_block = METER_BLOCK * os_factor;
+        const bool measure_in = (os_num_stages == 0) && !in_measured;
+        const bool measure_out = !midside_mode_on;
+        const GainApplyKernel gain_apply = GAIN_APPLY_KERNELS[params->saturation_mode]
+                                                             [(is_all_button_mode ? 4 : 0) | (measure_in ? 2 : 0) | (measure_out ? 1 : 0)];
+        for (int c = 0; c < num_channels; ++c) {
+            float* out_peaks = (os_num_stages > 0) ? meter_true_peaks[c] : meter_out_peaks[c];
+            gain_apply(&params->saturation, &params->all_button_saturation, self->saturation_adaa[c], proc_in[c], detector[linked ? 0 : c],
+                       proc_out[c], current_oversample_buffer_size, meter_block, meter_in_peaks[c], out_peaks);
+        }
+        in_measured = in_measured || measure_in;
+        if (measure_out) {
+            if (os_num_stages > 0) true_peak_measured = true;
+            else out_measured = true;
+        }
+    }
+
+    // Picco inter-campione in M/S: L = M + S, R = M - S decodificati al volo dai dati sovracampionati
+    if (midside_mode_on && !sidechain_listen && os_num_stages > 0) {
+        const uint32_t meter_block = METER_BLOCK * os_factor;
+        const float* mid = proc_out[0];
+        const float* side = proc_out[1];
+        for (uint32_t start = 0, k = 0; start < current_oversample_buffer_size; start += meter_block, ++k) {
+            const uint32_t end = (current_oversample_buffer_size - start < meter_block) ? current_oversample_buffer_size : start + meter_block;
+            float peak_l = 0.0f;
+            float peak_r = 0.0f;
+            for (uint32_t i = start; i < end; ++i) {
+                peak_l = fast_max(peak_l, fabsf(mid[i] + side[i]));
+                peak_r = fast_max(peak_r, fabsf(mid[i] - side[i]));
+            }
+            meter_true_peaks[0][k] = peak_l;
+            meter_true_peaks[1][k] = peak_r;
+        }
+        true_peak_measured = true;
+    }
+
+
+    // --- Downsample: decimazione polifase (os_factor -> ... -> 2x -> 1x) ---
+    if (os_num_stages > 0) {
+        const float* down_in[GUA76_MAX_CHANNELS];
+        for (int c = 0; c < num_channels; ++c) down_in[c] = self->oversample_buffer[c];
+        // Il meter di uscita raccoglie i massimi dai campioni decimati (fuori dalla codifica M/S)
+        float* const* down_peaks = midside_mode_on ? NULL : meter_out_peaks;
+        for (int g = 0; g < lane_groups(num_channels); ++g) {
+            oversample_down_lanes(self->coeffs->halfband, self->downsample_lanes[g], os_num_stages,
+                                  down_in + g * SIMD_LANES, out + g * SIMD_LANES,
+                                  lanes_in_group(num_channels, g), sample_count,
+                                  down_peaks ? down_peaks + g * SIMD_LANES : NULL);
+        }
+        out_measured = !midside_mode_on;
+    }
+
+    // --- Mid-Side Decoding (se attivo) ---
+    if (midside_mode_on) {
+        float* out_l = out[0];
+        float* out_r = out[1];
+        for (uint32_t start = 0, k = 0; start < sample_count; start += METER_BLOCK, ++k) {
+            const uint32_t end = (sample_count - start < METER_BLOCK) ? sample_count : start + METER_BLOCK;
+            float peak_l = 0.0f;
+            float peak_r = 0.0f;
+            for (uint32_t i = start; i < end; ++i) {
+                float mid = out_l[i];
+                float side = out_r[i];
+                out_l[i] = mid + side;
+                out_r[i] = mid - side;
+                peak_l = fast_max(peak_l, fabsf(out_l[i]));
+                peak_r = fast_max(peak_r, fabsf(out_r[i]));
+            }
+            meter_out_peaks[0][k] = peak_l;
+            meter_out_peaks[1][k] = peak_r;
+        }
+        out_measured = true;
+    }
+
+    StageMeters measured = { in_measured, out_measured, true_peak_measured };
+    return measured;
+}
+
+// Elabora un chunk di al massimo chunk_length campioni: lookahead, i passi di elaborazione a
+// micro-blocchi (process_stages), poi peak meter e telemetria sull'intero chunk.
+// 'in', 'sc_in' e 'out' hanno un puntatore per canale.
+static void process_chunk(Gua76* self, const Gua76ChunkParams* params,
+                          const float* const* in, const float* const* sc_in, float* const* out,
+                          uint32_t sample_count) {
+    const int   num_channels = self->num_channels;
+    const uint32_t block_length = pipeline_block_length(self, params->os_num_stages);
+
+    const float* chunk_in[GUA76_MAX_CHANNELS];
+    for (int c = 0; c < num_channels; ++c) chunk_in[c] = in[c];
+
+    // --- Lookahead: ritardo dell'audio (L/R, prima della codifica M/S) ---
+    if (self->lookahead_samples > 0) {
+        lookahead_delay(self, in, self->lookahead_buffer, sample_count);
+        for (int c = 0; c < num_channels; ++c) chunk_in[c] = self->lookahead_buffer[c];
+    }
+    const float* meter_in[GUA76_MAX_CHANNELS]; // Ingresso L/R per meter e telemetria
+    for (int c = 0; c < num_channels; ++c) meter_in[c] = chunk_in[c];
+
+    // --- Passi di elaborazione, a micro-blocchi ---
+    // Il traffico di memoria per campione non dipende più dalla lunghezza del blocco dell'host:
+    // i dati sovracampionati di un micro-blocco vengono scritti e riletti mentre sono in cache.
+    // Ogni micro-blocco inizia a un multiplo di METER_BLOCK, così i sotto-blocchi dei meter restano
+    // allineati al chunk: block_length è PIPELINE_BLOCK_OS_SAMPLES >> stadi (multiplo di METER_BLOCK
+    // fino a 16x), oppure chunk_length quando è più corto, e allora il chunk è un solo micro-blocco.
+    StageMeters measured = { false, false, false };
+    for (uint32_t pos = 0; pos < sample_count; pos += block_length) {
+        const uint32_t n = (sample_count - pos < block_length) ? sample_count - pos : block_length;
+        const float* block_in[GUA76_MAX_CHANNELS];
+        const float* block_sc[GUA76_MAX_CHANNELS];
+        float* block_out[GUA76_MAX_CHANNELS];
+        for (int c = 0; c < num_channels; ++c) {
+            block_in[c] = chunk_in[c] + pos;
+            block_sc[c] = sc_in[c] + pos;
+            block_out[c] = out[c] + pos;
+        }
+        measured = process_stages(self, params, block_in, block_sc, block_out, n, pos / METER_BLOCK);
+    }
+    const bool in_measured = measured.in_measured;
+    const bool out_measured = measured.out_measured;
+    const bool true_peak_measured = measured.true_peak_measured;
+
+    // --- Peak Meter di ingresso/uscita e true peak (per chunk) ---
+    // Sidechain listen: nessun passo in cui raccogliere i massimi, si misurano qui.
+    // A 1x (o senza dati sovracampionati misurati) il true peak coincide con il picco di uscita;
+    // altrimenti non scende sotto il picco di uscita (il filtro di decimazione può aggiungere ringing).
+    const uint32_t meter_blocks = (sample_count + METER_BLOCK - 1) / METER_BLOCK;
+    for (int c = 0; c < num_channels; ++c) {
+        if (!in_measured) meter_measure(meter_in[c], sample_count, self->meter_in_peaks[c]);
+        if (!out_measured) meter_measure(out[c], sample_count, self->meter_out_peaks[c]);
+        const float* true_peaks = self->meter_out_peaks[c];
+        if (true_peak_measured) {
+            for (uint32_t k = 0; k < meter_blocks; ++k) {
+                self->meter_true_peaks[c][k] = fast_max(self->meter_true_peaks[c][k], self->meter_out_peaks[c][k]);
+            }
+            true_peaks = self->meter_true_peaks[c];
+        }
+        self->peak_in_linear[c] = meter_fold(self, self->peak_in_linear[c], self->meter_in_peaks[c], sample_count);
+        self->peak_out_linear[c] = meter_fold(self, self->peak_out_linear[c], self->meter_out_peaks[c], sample_count);
+        self->true_peak_out_linear[c] = meter_fold(self, self->true_peak_out_linear[c], true_peaks, sample_count);
+    }
+
+    if (self->telemetry_active) telemetry_collect(self, meter_in, out, sample_count);
+}
+
+// Ingresso e sidechain del chunk sotto la soglia di silenzio
+static bool chunk_is_silent(const Gua76* self, const float* const* in, const float* const* sc, uint32_t n) {
+    for (int c = 0; c < self->num_channels; ++c) {
+        if (!(peak_abs(in[c], n) < self->silence_threshold)) return false;
+        if (sc[c] != in[c] && !(peak_abs(sc[c], n) < self->silence_threshold)) return false;
+    }
+    return true;
+}
+
+// Detector scarichi e nessuna GR residua: azzerare lo stato non cambia l'uscita
+static bool dsp_state_settled(const Gua76* self, const Gua76ChunkParams* params) {
+    const int num_detectors = (params->detector_link != DETECTOR_LINK_INDEPENDENT) ? 1 : self->num_channels;
+    for (int d = 0; d < num_detectors; ++d) {
+        if (!(self->envelope[d] < self->silence_envelope) || !(self->current_gr_linear[d] > SILENCE_GR_LINEAR)) return false;
+    }
+    return true;
+}
+
+// Stato e uscita del chunk finiti: un NaN/Inf (dall'ingresso o da un filtro instabile) resta nella
+// storia dei filtri ricorsivi e nell'envelope, quindi arriva anche all'ultimo campione di uscita
+static bool dsp_state_finite(const Gua76* self, float* const* out, uint32_t n) {
+    if (!is_finite_float(self->io_gain_current)) return false;
+    for (int c = 0; c < self->num_channels; ++c) {
+        if (!is_finite_float(self->envelope[c]) || !is_finite_float(self->current_gr_linear[c])) return false;
+        if (n > 0 && !is_finite_float(out[c][n - 1])) return false;
+    }
+    return true;
+}
+
+// Chunk con il DSP sospeso: uscita a zero, meter e telemetria aggiornati senza elaborare.
+// Rampe di gain e filtri sidechain si concludono subito (in silenzio non sono udibili).
+static void sleep_chunk(Gua76* self, const float* const* in, float* const* out, uint32_t n) {
+    const uint32_t meter_blocks = (n + METER_BLOCK - 1) / METER_BLOCK;
+    for (int c = 0; c < self->num_channels; ++c) {
+        meter_measure(in[c], n, self->meter_in_peaks[c]); // Prima di azzerare l'uscita ('in' può coincidere)
+        memset(out[c], 0, n * sizeof(float));
+        memset(self->meter_out_peaks[c], 0, meter_blocks * sizeof(float));
+        self->peak_in_linear[c] = meter_fold(self, self->peak_in_linear[c], self->meter_in_peaks[c], n);
+        self->peak_out_linear[c] = meter_fold(self, self->peak_out_linear[c], self->meter_out_peaks[c], n);
+        self->true_peak_out_linear[c] = meter_fold(self, self->true_peak_out_linear[c], self->meter_out_peaks[c], n);
+    }
+    self->io_gain_current = self->params.io_gain_target;
+    if (self->sc_filter_ramping) snap_sidechain_filters(self);
+    if (self->telemetry_active) {
+        for (uint32_t k = 0; k < meter_blocks; ++k) self->meter_gr_min[k] = self->meter_gr_max[k] = 1.0f;
+        telemetry_collect(self, in, out, n);
+    }
+}
+
+// Inizio di un blocco dell'host: apre la sequenza della telemetria (notify: buffer dell'host o NULL)
+static void block_begin(Gua76* self, LV2_Atom_Sequence* notify) {
+    // atom.size = spazio disponibile
+    self->telemetry_active = false;
+    if (notify && self->telemetry_available) {
+        lv2_atom_forge_set_buffer(&self->forge, (uint8_t*)notify, notify->atom.size);
+        self->telemetry_active = (lv2_atom_forge_sequence_head(&self->forge, &self->notify_frame, 0) != 0);
+    }
+}
+
+// Fine del blocco: chiude la sequenza della telemetria
+static void block_end(Gua76* self) {
+    if (self->telemetry_active) lv2_atom_forge_pop(&self->forge, &self->notify_frame);
+}
+
+// Elaborazione di un tratto di blocco con i parametri di self->settings (senza la gestione della
+// modalità FP), tra block_begin e block_end. Un blocco può essere diviso in più tratti (eventi dei
+// parametri): i valori derivati si ricalcolano solo per i parametri cambiati e lo stato prosegue.
+// frame_offset: inizio del tratto nel blocco (per i timestamp della telemetria).
+// sidechain_in: NULL, o per canale NULL = sidechain interno.
+static void process_segment(Gua76* self, const float* const* audio_in, const float* const* sidechain_in,
+                            float* const* audio_out, uint32_t sample_count, uint32_t frame_offset) {
+    const int num_channels = self->num_channels;
+
+    // Sidechain input - se connesso, usa quello, altrimenti usa l'input principale
+    const float* in[GUA76_MAX_CHANNELS];
+    const float* sc_in[GUA76_MAX_CHANNELS];
+    float* out[GUA76_MAX_CHANNELS];
+    bool external_sidechain = false;
+    for (int c = 0; c < num_channels; ++c) {
+        const float* sc = sidechain_in ? sidechain_in[c] : NULL;
+        in[c] = audio_in[c];
+        out[c] = audio_out[c];
+        sc_in[c] = sc ? sc : in[c];
+        if (sc) external_sidechain = true;
+    }
+
+    // Parametri correnti (dalle porte o dai setter di Gua76Engine); i selettori vengono limitati qui
+    const Gua76Settings* settings = &self->settings;
+    const float input_norm = settings->input;
+    const float output_norm = settings->output;
+    const float attack_norm = settings->attack;   // 0.0=fast, 1.0=slow
+    const float release_norm = settings->release; // 0.0=fast, 1.0=slow
+    const int   ratio_enum = settings->ratio;
+    const bool  bypass = settings->bypass;
+    const float drive_saturation_norm = settings->drive;
+    int os_num_stages = settings->oversampling;
+    if (os_num_stages < 0) os_num_stages = 0;
+    if (os_num_stages > OS_MAX_HALFBAND_STAGES) os_num_stages = OS_MAX_HALFBAND_STAGES;
+    const uint32_t os_factor = 1u << os_num_stages;
+    const bool  sc_hpf_on = settings->sidechain_hpf_on;
+    const float sc_hpf_freq = settings->sidechain_hpf_freq;
+    const float sc_filter_q = settings->sidechain_filter_q;
+    const bool  sc_lpf_on = settings->sidechain_lpf_on;
+    const float sc_lpf_freq = settings->sidechain_lpf_freq;
+    const bool  sidechain_listen = settings->sidechain_listen;
+    const bool  midside_mode_on = settings->midside_mode && num_channels == 2;
+    const bool  midside_link = settings->midside_link;
+    const bool  pad_10db_on = settings->pad_10db;
+    const float knee_db = settings->knee_db;
+    int detector_link = settings->detector_link;
+    if (detector_link < DETECTOR_LINK_INDEPENDENT || detector_link > DETECTOR_LINK_SUM || num_channels == 1) {
+        detector_link = DETECTOR_LINK_INDEPENDENT;
+    }
+    const float lookahead_ms = fminf(fmaxf(settings->lookahead_ms, 0.0f), LOOKAHEAD_MS_MAX);
+    uint32_t lookahead_samples = (uint32_t)(lookahead_ms * 0.001f * self->samplerate + 0.5f);
+    if (lookahead_samples > self->lookahead_max_samples) lookahead_samples = self->lookahead_max_samples;
+    int saturation_mode = settings->saturation_mode;
+    if (saturation_mode < SATURATION_MODE_STANDARD || saturation_mode >= NUM_SATURATION_MODES) {
+        saturation_mode = SATURATION_MODE_STANDARD;
+    }
+    // Frequenza del detector: la frequenza interna divisa per 2^shift, mai sotto il doppio di quella dell'host
+    int detector_shift = settings->detector_rate;
+    if (detector_shift < DETECTOR_RATE_FULL || sidechain_listen) detector_shift = DETECTOR_RATE_FULL;
+    if (detector_shift > os_num_stages - DETECTOR_MIN_OS_STAGES) {
+        detector_shift = (os_num_stages > DETECTOR_MIN_OS_STAGES) ? os_num_stages - DETECTOR_MIN_OS_STAGES : DETECTOR_RATE_FULL;
+    }
+    const int detector_os_stages = os_num_stages - detector_shift;
+
+    const int   ratio_idx = (ratio_enum < 0) ? 0 : (ratio_enum >= NUM_RATIOS ? NUM_RATIOS - 1 : ratio_enum);
+    Gua76Controls* controls = &self->controls;
+    Gua76ChunkParams* params = &self->params;
+    const bool refresh_all = !controls->valid;
+
+    // --- Cambio del fattore di oversampling ---
+    // Nuova frequenza interna: gli stati half-band appartengono al vecchio fattore e vengono azzerati,
+    // e tutto ciò che dipende dalla frequenza interna (alpha, coefficienti dei filtri sidechain) va ricalcolato.
+    const bool os_changed = refresh_all || (os_num_stages != self->os_num_stages);
+    if (os_changed) {
+        self->os_num_stages = os_num_stages;
+        self->oversampled_samplerate = self->samplerate * os_factor;
+        reset_oversampling_filters(self);
+        reset_saturation_state(self);
+    }
+
+    // --- Cambio della frequenza del detector ---
+    // Tutto ciò che gira alla frequenza del detector (alpha, smoothing, filtri sidechain, finestra
+    // del lookahead) va ricalcolato; il sidechain sovracampionato a parte riparte da zero.
+    const bool detector_rate_changed = os_changed || (detector_os_stages != self->detector_os_stages);
+    if (detector_rate_changed) {
+        self->detector_os_stages = detector_os_stages;
+        self->detector_samplerate = self->samplerate * (1 << detector_os_stages);
+        self->detector_gain_prev_valid = false;
+        const CoeffBankRate* detector_rate = &self->coeffs->rates[detector_os_stages];
+        self->detector_gain_delay = self->coeffs->rates[os_num_stages].detector_gain_delay[detector_os_stages];
+        if (!os_changed) reset_sidechain_upsampling(self);
+        self->gain_smooth_alpha = detector_rate->gain_smooth_alpha;
+        self->sc_filter_smooth_alpha = detector_rate->sc_filter_smooth_alpha;
+    }
+
+    // --- Lookahead: un nuovo ritardo (o una nuova finestra alla frequenza del detector) riparte da zero ---
+    if (detector_rate_changed || lookahead_samples != self->lookahead_samples) {
+        self->lookahead_samples = lookahead_samples;
+        reset_lookahead(self);
+    }
+    const uint32_t adaa_delay_samples = adaa_latency_samples(saturation_mode, os_num_stages);
+    if (adaa_delay_samples != self->adaa_delay_samples) {
+        self->adaa_delay_samples = adaa_delay_samples;
+        for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) self->bypass_adaa_last[c] = 0.0f;
+    }
+    self->latency_samples = lookahead_samples + adaa_delay_samples;
+
+    // --- Calcolo Parametri del Compressore (solo per i controlli cambiati) ---
+    if (refresh_all || input_norm != controls->input_norm || output_norm != controls->output_norm ||
+        pad_10db_on != controls->pad_10db_on) {
+        controls->input_norm = input_norm;
+        controls->output_norm = output_norm;
+        controls->pad_10db_on = pad_10db_on;
+        float input_gain_linear = db_to_linear(input_norm * (INPUT_GAIN_DB_MAX - INPUT_GAIN_DB_MIN) + INPUT_GAIN_DB_MIN);
+        const float output_gain_linear = db_to_linear(output_norm * (OUTPUT_GAIN_DB_MAX - OUTPUT_GAIN_DB_MIN) + OUTPUT_GAIN_DB_MIN);
+        if (pad_10db_on) { // Applica il pad prima dell'input gain
+            input_gain_linear *= PAD_10DB_VALUE;
+        }
+        params->io_gain_target = input_gain_linear * output_gain_linear;
+        if (refresh_all) self->io_gain_current = params->io_gain_target; // Nessuna rampa all'attivazione
+    }
+
+    // Mappatura non lineare Attack/Release per il 1176 "feeling"
+    // I tempi effettivi sono spesso mappati in modo inverso logaritmico o esponenziale dalla manopola
+    // Per un feel più 1176, usiamo una potenza per dare più risoluzione verso i tempi veloci.
+    // Le tabelle delle alpha del detector dipendono anche dalla frequenza del detector corrente.
+    if (detector_rate_changed || attack_norm != controls->attack_norm) {
+        controls->attack_norm = attack_norm;
+        const float attack_time_us_mapped = ATTACK_TIME_US_FASTEST + (ATTACK_TIME_US_SLOWEST - ATTACK_TIME_US_FASTEST) * (attack_norm * attack_norm);
+        detector_alpha_table_fill(&self->attack_alpha_table, self->detector_samplerate, attack_time_us_mapped / 1000000.0f);
+    }
+    if (detector_rate_changed || release_norm != controls->release_norm) {
+        controls->release_norm = release_norm;
+        const float release_time_ms_mapped = RELEASE_TIME_MS_FASTEST + (RELEASE_TIME_MS_SLOWEST - RELEASE_TIME_MS_FASTEST) * (release_norm * release_norm);
+        detector_alpha_table_fill(&self->release_alpha_table, self->detector_samplerate, release_time_ms_mapped / 1000.0f);
+    }
+
+    // Rapporto di compressione dal selettore e larghezza del knee
+    if (refresh_all || ratio_idx != controls->ratio_idx || knee_db != controls->knee_db) {
+        controls->ratio_idx = ratio_idx;
+        controls->knee_db = knee_db;
+        params->is_all_button_mode = (ratio_idx == 4); // Special case for All-Button
+        gain_computer_setup(&params->gain, COMPRESSOR_THRESHOLD_DB, RATIO_SLOPES[ratio_idx], fminf(fmaxf(knee_db, 0.0f), KNEE_DB_MAX));
+    }
+
+    if (refresh_all || drive_saturation_norm != controls->drive_saturation_norm) {
+        controls->drive_saturation_norm = drive_saturation_norm;
+        const float drive_amount = drive_saturation_norm * DRIVE_SATURATION_AMOUNT_MAX;
+        soft_clip_setup(&params->saturation, drive_amount);
+        soft_clip_setup(&params->all_button_saturation, drive_amount + 0.2f);
+    }
+    if (refresh_all || saturation_mode != controls->saturation_mode) {
+        controls->saturation_mode = saturation_mode;
+        params->saturation_mode = saturation_mode;
+        reset_saturation_state(self); // Gli ingressi memorizzati appartengono alla modalità precedente
+    }
+
+    // --- Filtri sidechain: i nuovi valori vengono raggiunti con una rampa a sotto-blocchi ---
+    if (detector_rate_changed || sc_hpf_freq != controls->sc_hpf_freq || sc_lpf_freq != controls->sc_lpf_freq ||
+        sc_filter_q != controls->sc_filter_q) {
+        controls->sc_hpf_freq = sc_hpf_freq;
+        controls->sc_lpf_freq = sc_lpf_freq;
+        controls->sc_filter_q = sc_filter_q;
+        if (detector_rate_changed) {
+            snap_sidechain_filters(self); // Nuova frequenza del detector (o attivazione): niente rampa
+        } else {
+            self->sc_filter_ramping = true;
+        }
+    }
+    controls->valid = true;
+
+
+    // --- Logica True Bypass ---
+    // Con il lookahead anche il bypass passa dalla linea di ritardo, e con l'ADAA da un campione di
+    // ritardo in più: la latenza riportata resta valida
+    if (bypass) {
+        // Aggiorna meter e telemetria in bypass per un visuale realistico (mostrano input, senza GR), a chunk
+        for (uint32_t offset = 0; offset < sample_count; offset += self->chunk_length) {
+            const uint32_t n = (sample_count - offset < self->chunk_length) ? sample_count - offset : self->chunk_length;
+            const float* chunk_in[GUA76_MAX_CHANNELS];
+            for (int c = 0; c < num_channels; ++c) {
+                chunk_in[c] = in[c] + offset;
+                meter_measure(chunk_in[c], n, self->meter_in_peaks[c]);
+                memcpy(self->meter_out_peaks[c], self->meter_in_peaks[c], ((n + METER_BLOCK - 1) / METER_BLOCK) * sizeof(float));
+                self->peak_in_linear[c] = meter_fold(self, self->peak_in_linear[c], self->meter_in_peaks[c], n);
+            }
+            if (self->telemetry_active) {
+                for (uint32_t k = 0; k < (n + METER_BLOCK - 1) / METER_BLOCK; ++k) self->meter_gr_min[k] = self->meter_gr_max[k] = 1.0f;
+                telemetry_collect(self, chunk_in, chunk_in, n);
+                telemetry_write(self, frame_offset + offset);
+            }
+        }
+        for (int c = 0; c < num_channels; ++c) {
+            self->peak_out_linear[c] = self->peak_in_linear[c]; // Output = Input in bypass
+            self->true_peak_out_linear[c] = self->peak_in_linear[c];
+        }
+        if (self->lookahead_samples > 0) lookahead_delay(self, in, out, sample_count);
+        for (int c = 0; c < num_channels; ++c) {
+            if (self->lookahead_samples == 0 && in[c] != out[c]) { memcpy(out[c], in[c], sizeof(float) * sample_count); }
+            if (self->adaa_delay_samples > 0) {
+                float last = self->bypass_adaa_last[c];
+                for (uint32_t i = 0; i < sample_count; ++i) {
+                    const float x = out[c][i];
+                    out[c][i] = last;
+                    last = x;
+                }
+                self->bypass_adaa_last[c] = last;
+            }
+        }
+        self->gr_meter_db = 0.0f; // No GR
+        return;
+    }
+
+    // Flag per blocco (nessun valore derivato da ricalcolare)
+    params->os_num_stages = os_num_stages;
+    params->detector_os_stages = detector_os_stages;
+    params->detector_link = detector_link;
+    params->external_sidechain = external_sidechain;
+    params->sc_hpf_on = sc_hpf_on;
+    params->sc_lpf_on = sc_lpf_on;
+    params->sidechain_listen = sidechain_listen;
+    params->midside_mode_on = midside_mode_on;
+    params->midside_link = midside_link;
+
+    // --- Elaborazione a chunk ---
+    // I buffer interni sono dimensionati per chunk_length campioni: i blocchi più lunghi
+    // vengono suddivisi, lo stato di filtri e detector prosegue da un chunk all'altro.
+    for (uint32_t offset = 0; offset < sample_count; offset += self->chunk_length) {
+        const uint32_t remaining = sample_count - offset;
+        const uint32_t n = (remaining < self->chunk_length) ? remaining : self->chunk_length;
+        const float* chunk_in[GUA76_MAX_CHANNELS];
+        const float* chunk_sc[GUA76_MAX_CHANNELS];
+        float* chunk_out[GUA76_MAX_CHANNELS];
+        for (int c = 0; c < num_channels; ++c) {
+            chunk_in[c] = in[c] + offset;
+            chunk_sc[c] = sc_in[c] + offset;
+            chunk_out[c] = out[c] + offset;
+        }
+
+        // Silenzio: dopo la tenuta, con i detector scarichi, il DSP viene sospeso (stato azzerato)
+        const bool silent = SILENCE_SLEEP && chunk_is_silent(self, chunk_in, chunk_sc, n);
+        if (silent && !self->sleeping && dsp_state_settled(self, params) &&
+            self->silent_samples >= self->silence_hold_samples + self->latency_samples) {
+            reset_dsp_state(self);
+            self->sleeping = true;
+        }
+        if (silent && self->sleeping) {
+            sleep_chunk(self, chunk_in, chunk_out, n);
+        } else {
+            self->sleeping = false;
+            process_chunk(self, params, chunk_in, chunk_sc, chunk_out, n);
+            // NaN/Inf: invece di propagarli per sempre nei filtri, si azzera lo stato e il chunk
+            if (!dsp_state_finite(self, chunk_out, n)) {
+                reset_dsp_state(self);
+                reset_telemetry(self);
+                for (int c = 0; c < num_channels; ++c) {
+                    memset(chunk_out[c], 0, n * sizeof(float));
+                    if (!is_finite_float(self->peak_in_linear[c])) self->peak_in_linear[c] = 0.0f;
+                    if (!is_finite_float(self->peak_out_linear[c])) self->peak_out_linear[c] = 0.0f;
+                    if (!is_finite_float(self->true_peak_out_linear[c])) self->true_peak_out_linear[c] = 0.0f;
+                }
+            }
+        }
+        if (!silent) self->silent_samples = 0;
+        else if (self->silent_samples < UINT32_MAX - n) self->silent_samples += n;
+        telemetry_write(self, frame_offset + offset);
+    }
+
+
+    // --- Aggiornamento dei Meter (a fine blocco) ---
+    // GR Meter (prende il massimo della GR tra i canali, es. L/Mid e R/Side, in dB)
+    float max_gr = self->current_gr_linear[0];
+    for (int c = 1; c < num_channels; ++c) max_gr = fmaxf(max_gr, self->current_gr_linear[c]);
+    self->gr_meter_db = to_db(max_gr); // GR è mostrata come valore negativo (es. -6dB)
+
+    // Il meter mode dal parametro controlla quale valore la GUI mostrerà, non il plugin
+    // Quindi il plugin invia sempre tutti i valori di picco.
+}
+
+// --- Plugin LV2: porte dell'host attorno al DSP ---
+
+// Controlli di ingresso (indici della variante stereo): simbolo della porta, che è anche il parametro
+// degli eventi sulla porta control (GUA76_PARAMETER_URI), default e intervallo come in gua76.ttl
+// (detector_link: default della variante stereo, le multicanale partono linkate, control_default).
+// Unica tabella per i default, gli eventi e i tool (gua76_parameter_info).
+#define NUM_CONTROL_INPUTS 23
+static const Gua76ParameterInfo CONTROL_INPUTS[NUM_CONTROL_INPUTS] = {
+    { GUA76_INPUT,               "input",               0.75f,   0.0f,  1.0f },
+    { GUA76_OUTPUT,              "output",              0.75f,   0.0f,  1.0f },
+    { GUA76_ATTACK,              "attack",              0.5f,    0.0f,  1.0f },
+    { GUA76_RELEASE,             "release",             0.5f,    0.0f,  1.0f },
+    { GUA76_RATIO,               "ratio",               0.0f,    0.0f,  4.0f },
+    { GUA76_METER_MODE,          "meter_mode",          0.0f,    0.0f,  2.0f },
+    { GUA76_BYPASS,              "bypass",              0.0f,    0.0f,  1.0f },
+    { GUA76_DRIVE_SATURATION,    "drive_saturation",    0.0f,    0.0f,  1.0f },
+    { GUA76_OVERSAMPLING_FACTOR, "oversampling_factor", (float)DEFAULT_OS_STAGES, 0.0f, 4.0f },
+    { GUA76_SIDECHAIN_HPF_ON,    "sidechain_hpf_on",    0.0f,    0.0f,  1.0f },
+    { GUA76_SIDECHAIN_HPF_FREQ,  "sidechain_hpf_freq",  100.0f,  20.0f, 20000.0f },
+    { GUA77_SIDECHAIN_HPF_Q,     "sidechain_filter_q",  0.707f,  0.1f,  5.0f },
+    { GUA76_SIDECHAIN_LPF_ON,    "sidechain_lpf_on",    0.0f,    0.0f,  1.0f },
+    { GUA76_SIDECHAIN_LPF_FREQ,  "sidechain_lpf_freq",  5000.0f, 20.0f, 20000.0f },
+    { GUA76_SIDECHAIN_LISTEN,    "sidechain_listen",    0.0f,    0.0f,  1.0f },
+    { GUA76_MIDSIDE_MODE,        "mid_side_mode",       0.0f,    0.0f,  1.0f },
+    { GUA76_MIDSIDE_LINK,        "mid_side_link",       1.0f,    0.0f,  1.0f },
+    { GUA76_PAD_10DB,            "pad_10db",            0.0f,    0.0f,  1.0f },
+    { GUA76_KNEE,                "knee",                0.0f,    0.0f,  24.0f },
+    { GUA76_DETECTOR_LINK,       "detector_link",       (float)DETECTOR_LINK_INDEPENDENT, 0.0f, 2.0f },
+    { GUA76_LOOKAHEAD,           "lookahead",           0.0f,    0.0f,  10.0f },
+    { GUA76_SATURATION_MODE,     "saturation_mode",     (float)SATURATION_MODE_STANDARD, 0.0f, 2.0f },
+    { GUA76_DETECTOR_RATE,       "detector_rate",       (float)DETECTOR_RATE_FULL, 0.0f, 4.0f }
+};
+
+// Default di un controllo nella variante con num_channels canali (gua76_variants.ttl: le varianti
+// multicanale partono con il detector linkato)
+static float control_default(const Gua76ParameterInfo* c, int num_channels) {
+    if (c->port == GUA76_DETECTOR_LINK && num_channels > 2) return (float)DETECTOR_LINK_MAX;
+    return c->def;
+}
+
+// Valori dei controlli (indici stereo) -> parametri del DSP, con il significato delle porte
+static void settings_from_controls(const float* v, Gua76Settings* s) {
+    s->input = v[GUA76_INPUT];
+    s->output = v[GUA76_OUTPUT];
+    s->attack = v[GUA76_ATTACK];
+    s->release = v[GUA76_RELEASE];
+    s->ratio = (int)v[GUA76_RATIO];
+    s->bypass = (v[GUA76_BYPASS] > 0.5f);
+    s->drive = v[GUA76_DRIVE_SATURATION];
+    s->oversampling = (int)(v[GUA76_OVERSAMPLING_FACTOR] + 0.5f);
+    s->sidechain_hpf_on = (v[GUA76_SIDECHAIN_HPF_ON] > 0.5f);
+    s->sidechain_hpf_freq = v[GUA76_SIDECHAIN_HPF_FREQ];
+    s->sidechain_filter_q = v[GUA77_SIDECHAIN_HPF_Q];
+    s->sidechain_lpf_on = (v[GUA76_SIDECHAIN_LPF_ON] > 0.5f);
+    s->sidechain_lpf_freq = v[GUA76_SIDECHAIN_LPF_FREQ];
+    s->sidechain_listen = (v[GUA76_SIDECHAIN_LISTEN] > 0.5f);
+    s->midside_mode = (v[GUA76_MIDSIDE_MODE] > 0.5f);
+    s->midside_link = (v[GUA76_MIDSIDE_LINK] > 0.5f);
+    s->pad_10db = (v[GUA76_PAD_10DB] > 0.5f);
+    s->knee_db = v[GUA76_KNEE];
+    s->detector_link = (int)(v[GUA76_DETECTOR_LINK] + 0.5f);
+    s->lookahead_ms = v[GUA76_LOOKAHEAD];
+    s->saturation_mode = (int)(v[GUA76_SATURATION_MODE] + 0.5f);
+    s->detector_rate = (int)(v[GUA76_DETECTOR_RATE] + 0.5f);
+}
+
+// URID per gli eventi dei parametri (patch:Set)
+typedef struct {
+    LV2_URID atom_object;
+    LV2_URID atom_urid;
+    LV2_URID atom_float;
+    LV2_URID atom_double;
+    LV2_URID atom_int;
+    LV2_URID atom_long;
+    LV2_URID atom_bool;
+    LV2_URID patch_set;
+    LV2_URID patch_property;
+    LV2_URID patch_value;
+    LV2_URID parameter[NUM_CONTROL_INPUTS]; // Stesso ordine di CONTROL_INPUTS
+} Gua76EventUrids;
+
+// Istanza LV2: puntatori alle porte e stato del DSP. run() porta i controlli in dsp->settings,
+// elabora il blocco (a tratti tra gli eventi dei parametri) e scrive meter e latenza sulle porte.
+typedef struct {
+    Gua76* dsp;
+
+    // Controlli di ingresso per indice stereo: porta dell'host, ultimo valore letto dalla porta
+    // (NaN = da applicare al prossimo run()) e valore corrente (dalla porta o dall'ultimo evento).
+    // Una porta sovrascrive il valore corrente solo quando cambia: gli eventi restano validi
+    // finché l'host non muove la porta.
+    const float* control_ptr[GUA76_NUM_STEREO_PORTS];
+    float control_port_last[GUA76_NUM_STEREO_PORTS];
+    float control_value[GUA76_NUM_STEREO_PORTS];
+
+    // Eventi dei parametri (opzionale, richiede urid:map)
+    const LV2_Atom_Sequence* control_events_ptr;
+    Gua76EventUrids urids;
+    bool events_available;
+
+    float* latency_ptr;   // Latenza riportata all'host (campioni)
+
+    // Puntatori per i meter (Output del plugin, input per la GUI)
+    float* peak_gr_ptr;
+    float* peak_in_l_ptr;
+    float* peak_in_r_ptr;
+    float* peak_out_l_ptr;
+    float* peak_out_r_ptr;
+    float* true_peak_out_l_ptr; // Picco inter-campione (dai dati sovracampionati)
+    float* true_peak_out_r_ptr;
+    LV2_Atom_Sequence* notify_ptr; // Telemetria per la GUI (opzionale)
+
+    // Puntatori ai buffer audio (per canale)
+    const float* audio_in_ptr[GUA76_MAX_CHANNELS];
+    float* audio_out_ptr[GUA76_MAX_CHANNELS];
+
+    // Ingressi sidechain esterni (opzionali, per canale)
+    const float* sidechain_in_ptr[GUA76_MAX_CHANNELS];
+
+    LV2_Log_Log* log;
+    LV2_Log_Logger logger;
+} Gua76Plugin;
+
+static void map_event_urids(Gua76EventUrids* u, LV2_URID_Map* map) {
+    u->atom_object = map->map(map->handle, LV2_ATOM__Object);
+    u->atom_urid = map->map(map->handle, LV2_ATOM__URID);
+    u->atom_float = map->map(map->handle, LV2_ATOM__Float);
+    u->atom_double = map->map(map->handle, LV2_ATOM__Double);
+    u->atom_int = map->map(map->handle, LV2_ATOM__Int);
+    u->atom_long = map->map(map->handle, LV2_ATOM__Long);
+    u->atom_bool = map->map(map->handle, LV2_ATOM__Bool);
+    u->patch_set = map->map(map->handle, LV2_PATCH__Set);
+    u->patch_property = map->map(map->handle, LV2_PATCH__property);
+    u->patch_value = map->map(map->handle, LV2_PATCH__value);
+    for (int i = 0; i < NUM_CONTROL_INPUTS; ++i) {
+        char uri[128];
+        snprintf(uri, sizeof(uri), "%s#%s", GUA76_URI, CONTROL_INPUTS[i].symbol);
+        u->parameter[i] = map->map(map->handle, uri);
+    }
+}
+
+// Funzione di istanziazione del plugin
+static LV2_Handle
+instantiate(const LV2_Descriptor* descriptor,
+            double              samplerate,
+            const char* bundle_path,
+            const LV2_Feature* const* features) {
+    int num_channels = 0;
+    for (int v = 0; v < NUM_VARIANTS; ++v) {
+        if (!strcmp(descriptor->URI, VARIANTS[v].uri)) num_channels = VARIANTS[v].num_channels;
+    }
+    if (num_channels == 0) return NULL;
+
+    Gua76Plugin* plugin = (Gua76Plugin*)calloc(1, sizeof(Gua76Plugin));
+    if (!plugin) return NULL;
+
+    LV2_URID_Map* map = NULL;
+    const LV2_Options_Option* options = NULL;
+    for (int i = 0; features[i]; ++i) {
+        if (!strcmp(features[i]->URI, LV2_LOG__log)) {
+            plugin->log = (LV2_Log_Log*)features[i]->data;
+        } else if (!strcmp(features[i]->URI, LV2_URID__map)) {
+            map = (LV2_URID_Map*)features[i]->data;
+        } else if (!strcmp(features[i]->URI, LV2_OPTIONS__options)) {
+            options = (const LV2_Options_Option*)features[i]->data;
+        }
+    }
+    lv2_log_logger_init(&plugin->logger, map, plugin->log);
+
+    // Buffer dimensionati sui blocchi dell'host
+    uint32_t block_length = read_block_length_option(options, map);
+    if (block_length == 0) block_length = DEFAULT_MAX_BLOCK_LENGTH;
+    plugin->dsp = create_instance(num_channels, samplerate, block_length);
+    if (!plugin->dsp) {
+        free(plugin);
+        return NULL;
+    }
+    if (map) {
+        enable_telemetry(plugin->dsp, map);
+        map_event_urids(&plugin->urids, map);
+        plugin->events_available = true;
+    }
+
+    // Default per le porte opzionali non collegate (il link del detector: indipendente in stereo,
+    // linkato in multicanale); le porte collegate vengono lette al primo run()
+    for (int i = 0; i < NUM_CONTROL_INPUTS; ++i) {
+        plugin->control_value[CONTROL_INPUTS[i].port] = control_default(&CONTROL_INPUTS[i], num_channels);
+    }
+    for (int p = 0; p < GUA76_NUM_STEREO_PORTS; ++p) plugin->control_port_last[p] = NAN;
+
+    return (LV2_Handle)plugin;
+}
+
+// Funzione per connettere le porte
+static void
+connect_port(LV2_Handle instance, uint32_t port, void* data_location) {
+    Gua76Plugin* self = (Gua76Plugin*)instance;
+
+    // Porte audio: ingressi, uscite e sidechain, num_channels ciascuno
+    const uint32_t n = (uint32_t)self->dsp->num_channels;
+    if (port < n) {
+        self->audio_in_ptr[port] = (const float*)data_location;
+        return;
+    }
+    if (port < 2 * n) {
+        self->audio_out_ptr[port - n] = (float*)data_location;
+        return;
+    }
+    if (port < 3 * n) {
+        self->sidechain_in_ptr[port - 2 * n] = (const float*)data_location;
+        return;
+    }
+
+    // Controlli: stesso ordine della variante stereo
+    const uint32_t index = port - GUA76_CONTROL_PORT_OFFSET(self->dsp->num_channels);
+    switch ((Gua76PortIndex)index) {
+        case GUA76_PEAK_GR:             self->peak_gr_ptr = (float*)data_location; break;
+        case GUA76_PEAK_IN_L:           self->peak_in_l_ptr = (float*)data_location; break;
+        case GUA76_PEAK_IN_R:           self->peak_in_r_ptr = (float*)data_location; break;
+        case GUA76_PEAK_OUT_L:          self->peak_out_l_ptr = (float*)data_location; break;
+        case GUA76_PEAK_OUT_R:          self->peak_out_r_ptr = (float*)data_location; break;
+        case GUA76_LATENCY:             self->latency_ptr = (float*)data_location; break;
+        case GUA76_TRUE_PEAK_OUT_L:     self->true_peak_out_l_ptr = (float*)data_location; break;
+        case GUA76_TRUE_PEAK_OUT_R:     self->true_peak_out_r_ptr = (float*)data_location; break;
+        case GUA76_NOTIFY:              self->notify_ptr = (LV2_Atom_Sequence*)data_location; break;
+        case GUA76_CONTROL_EVENTS:      self->control_events_ptr = (const LV2_Atom_Sequence*)data_location; break;
+
+        default: // Controlli di ingresso
+            if (index < GUA76_NUM_STEREO_PORTS) self->control_ptr[index] = (const float*)data_location;
+            break;
+    }
+}
+
+// Funzione di attivazione (resettare lo stato del plugin)
+static void
+activate(LV2_Handle instance) {
+    Gua76Plugin* self = (Gua76Plugin*)instance;
+    reset_instance(self->dsp);
+    for (int p = 0; p < GUA76_NUM_STEREO_PORTS; ++p) self->control_port_last[p] = NAN; // Valgono le porte
+
+    *self->peak_gr_ptr = 0.0f;
+    *self->peak_in_l_ptr = -90.0f;
+    *self->peak_in_r_ptr = -90.0f;
+    *self->peak_out_l_ptr = -90.0f;
+    *self->peak_out_r_ptr = -90.0f;
+    if (self->true_peak_out_l_ptr) *self->true_peak_out_l_ptr = -90.0f;
+    if (self->true_peak_out_r_ptr) *self->true_peak_out_r_ptr = -90.0f;
+}
+
+// Valori delle porte cambiati dall'ultimo run() (o tutti dopo l'attivazione)
+static void read_control_ports(Gua76Plugin* self) {
+    for (int i = 0; i < NUM_CONTROL_INPUTS; ++i) {
+        const int port = CONTROL_INPUTS[i].port;
+        const float* ptr = self->control_ptr[port];
+        if (ptr && !(*ptr == self->control_port_last[port])) {
+            self->control_port_last[port] = *ptr;
+            self->control_value[port] = *ptr;
+        }
+    }
+}
+
+// Un evento patch:Set per un controllo: indice stereo e valore, limitato all'intervallo della porta
+// come farebbe l'host (false se l'evento non è per noi o il valore non è un numero)
+static bool parse_control_event(const Gua76EventUrids* u, const LV2_Atom* atom, int* port, float* value) {
+    if (atom->type != u->atom_object) return false;
+    const LV2_Atom_Object* object = (const LV2_Atom_Object*)atom;
+    if (object->body.otype != u->patch_set) return false;
+    const LV2_Atom* property = NULL;
+    const LV2_Atom* atom_value = NULL;
+    lv2_atom_object_get(object, u->patch_property, &property, u->patch_value, &atom_value, 0);
+    if (!property || !atom_value || property->type != u->atom_urid) return false;
+
+    if (atom_value->type == u->atom_float) *value = ((const LV2_Atom_Float*)atom_value)->body;
+    else if (atom_value->type == u->atom_double) *value = (float)((const LV2_Atom_Double*)atom_value)->body;
+    else if (atom_value->type == u->atom_int || atom_value->type == u->atom_bool) *value = (float)((const LV2_Atom_Int*)atom_value)->body;
+    else if (atom_value->type == u->atom_long) *value = (float)((const LV2_Atom_Long*)atom_value)->body;
+    else return false;
+
+    const LV2_URID key = ((const LV2_Atom_URID*)property)->body;
+    for (int i = 0; i < NUM_CONTROL_INPUTS; ++i) {
+        if (u->parameter[i] == key) {
+            if (*value != *value) return false; // NaN
+            if (*value < CONTROL_INPUTS[i].min) *value = CONTROL_INPUTS[i].min;
+            if (*value > CONTROL_INPUTS[i].max) *value = CONTROL_INPUTS[i].max;
+            *port = CONTROL_INPUTS[i].port;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Elabora i frame [offset, offset + n) del blocco dell'host con i parametri correnti
+static void run_segment(Gua76Plugin* self, uint32_t offset, uint32_t n) {
+    const float* in[GUA76_MAX_CHANNELS];
+    const float* sc[GUA76_MAX_CHANNELS];
+    float* out[GUA76_MAX_CHANNELS];
+    for (int c = 0; c < self->dsp->num_channels; ++c) {
+        in[c] = self->audio_in_ptr[c] + offset;
+        sc[c] = self->sidechain_in_ptr[c] ? self->sidechain_in_ptr[c] + offset : NULL;
+        out[c] = self->audio_out_ptr[c] + offset;
+    }
+    process_segment(self->dsp, in, sc, out, n, offset);
+}
+
+// Scrive i peak meter sulle porte: in stereo L/R sono i canali 0/1, nelle altre
+// varianti entrambe le porte mostrano il massimo su tutti i canali.
+static void write_peak_meters(Gua76Plugin* self) {
+    const Gua76* dsp = self->dsp;
+    if (dsp->num_channels == 2) {
+        *self->peak_in_l_ptr = to_db(dsp->peak_in_linear[0]);
+        *self->peak_in_r_ptr = to_db(dsp->peak_in_linear[1]);
+        *self->peak_out_l_ptr = to_db(dsp->peak_out_linear[0]);
+        *self->peak_out_r_ptr = to_db(dsp->peak_out_linear[1]);
+        if (self->true_peak_out_l_ptr) *self->true_peak_out_l_ptr = to_db(dsp->true_peak_out_linear[0]);
+        if (self->true_peak_out_r_ptr) *self->true_peak_out_r_ptr = to_db(dsp->true_peak_out_linear[1]);
+        return;
+    }
+    float peak_in = 0.0f;
+    float peak_out = 0.0f;
+    float true_peak_out = 0.0f;
+    for (int c = 0; c < dsp->num_channels; ++c) {
+        peak_in = fmaxf(peak_in, dsp->peak_in_linear[c]);
+        peak_out = fmaxf(peak_out, dsp->peak_out_linear[c]);
+        true_peak_out = fmaxf(true_peak_out, dsp->true_peak_out_linear[c]);
+    }
+    *self->peak_in_l_ptr = *self->peak_in_r_ptr = to_db(peak_in);
+    *self->peak_out_l_ptr = *self->peak_out_r_ptr = to_db(peak_out);
+    if (self->true_peak_out_l_ptr) *self->true_peak_out_l_ptr = to_db(true_peak_out);
+    if (self->true_peak_out_r_ptr) *self->true_peak_out_r_ptr = to_db(true_peak_out);
+}
+
+
+// Funzione di elaborazione audio (run): flush-to-zero/denormals-are-zero solo per la sua durata.
+// Gli eventi dei parametri dividono il blocco: ogni tratto usa i valori in vigore dal suo primo frame.
+static void
+run(LV2_Handle instance, uint32_t sample_count) {
+    Gua76Plugin* self = (Gua76Plugin*)instance;
+    read_control_ports(self);
+    settings_from_controls(self->control_value, &self->dsp->settings);
+    const FpMode fp_mode = fp_mode_enter();
+    block_begin(self->dsp, self->notify_ptr);
+    uint32_t pos = 0;
+    if (self->control_events_ptr && self->events_available) {
+        LV2_ATOM_SEQUENCE_FOREACH(self->control_events_ptr, ev) {
+            int port;
+            float value;
+            if (!parse_control_event(&self->urids, &ev->body, &port, &value)) continue;
+            // Eventi fuori ordine o oltre il blocco: al primo frame possibile
+            const int64_t frame = ev->time.frames;
+            const uint32_t at = (frame <= (int64_t)pos) ? pos : (frame >= (int64_t)sample_count ? sample_count : (uint32_t)frame);
+            if (at > pos) {
+                run_segment(self, pos, at - pos);
+                pos = at;
+            }
+            self->control_value[port] = value;
+            settings_from_controls(self->control_value, &self->dsp->settings);
+        }
+    }
+    if (pos < sample_count || sample_count == 0) run_segment(self, pos, sample_count - pos);
+    block_end(self->dsp);
+    fp_mode_leave(fp_mode);
+
+    // Meter e latenza sulle porte di uscita
+    if (self->latency_ptr) *self->latency_ptr = (float)self->dsp->latency_samples;
+    *self->peak_gr_ptr = self->dsp->gr_meter_db;
+    write_peak_meters(self);
+}
+
+// Funzione di pulizia (liberare memoria)
+static void
+cleanup(LV2_Handle instance) {
+    Gua76Plugin* self = (Gua76Plugin*)instance;
+    free_instance(self->dsp);
+    free(self);
+}
+
+// Funzione per restituire interfacce (come l'idle interface)
 static const void*
 extension_data(const char* uri) {
     return NULL;
@@ -741,21 +3372,175 @@ static void deactivate(LV2_Handle instance) {
     (void)instance;
 }
 
-// Descrittore del plugin LV2
-static const LV2_Descriptor descriptor = {
-    GUA76_URI,
-    instantiate,
-    connect_port,
-    activate,
-    run,
-    deactivate, // Necessario per LV2, anche se vuoto
-    cleanup,
-    extension_data
+// Descrittori del plugin LV2, uno per variante (stesso ordine di VARIANTS)
+#define GUA76_DESCRIPTOR(uri) { uri, instantiate, connect_port, activate, run, deactivate, cleanup, extension_data }
+static const LV2_Descriptor descriptors[NUM_VARIANTS] = {
+    GUA76_DESCRIPTOR(GUA76_URI),
+    GUA76_DESCRIPTOR(GUA76_MONO_URI),
+    GUA76_DESCRIPTOR(GUA76_51_URI),
+    GUA76_DESCRIPTOR(GUA76_71_URI)
 };
 
+#ifdef GUA76_REFERENCE_BUILD
+// La build di riferimento non è un plugin installabile: solo per tools/gua76_nulltest.cpp
+extern "C" const LV2_Descriptor*
+gua76_reference_descriptor(uint32_t index) {
+    if (index < NUM_VARIANTS) return &descriptors[index];
+    return NULL;
+}
+#else
 LV2_SYMBOL_EXPORT
 const LV2_Descriptor*
 lv2_descriptor(uint32_t index) {
-    if (index == 0) return &descriptor;
+    if (index < NUM_VARIANTS) return &descriptors[index];
     return NULL;
 }
+#endif
+
+
+#ifndef GUA76_REFERENCE_BUILD
+// --- Gua76Engine: lo stesso DSP senza host LV2 (gua76_engine.h) ---
+// Come run(): i parametri vengono copiati in dsp->settings e il blocco passa da process_block.
+
+// Un blocco intero con i parametri di self->settings (senza la gestione della modalità FP):
+// il motore non ha eventi dei parametri, quindi un solo tratto
+static void process_block(Gua76* self, const float* const* audio_in, const float* const* sidechain_in,
+                          float* const* audio_out, LV2_Atom_Sequence* notify, uint32_t sample_count) {
+    block_begin(self, notify);
+    process_segment(self, audio_in, sidechain_in, audio_out, sample_count, 0);
+    block_end(self);
+}
+
+void gua76_default_settings(Gua76Settings* s, int num_channels) {
+    float controls[GUA76_NUM_STEREO_PORTS] = { 0.0f };
+    for (int i = 0; i < NUM_CONTROL_INPUTS; ++i) controls[CONTROL_INPUTS[i].port] = control_default(&CONTROL_INPUTS[i], num_channels);
+    memset(s, 0, sizeof(Gua76Settings));
+    settings_from_controls(controls, s);
+}
+
+int gua76_num_parameters(void) {
+    return NUM_CONTROL_INPUTS;
+}
+
+const Gua76ParameterInfo* gua76_parameter_info(int index) {
+    return (index >= 0 && index < NUM_CONTROL_INPUTS) ? &CONTROL_INPUTS[index] : NULL;
+}
+
+const Gua76ParameterInfo* gua76_find_parameter(const char* symbol) {
+    for (int i = 0; i < NUM_CONTROL_INPUTS; ++i) {
+        if (!strcmp(CONTROL_INPUTS[i].symbol, symbol)) return &CONTROL_INPUTS[i];
+    }
+    return NULL;
+}
+
+float gua76_parameter_default(const Gua76ParameterInfo* info, int num_channels) {
+    return control_default(info, num_channels);
+}
+
+Gua76Engine::Gua76Engine(int numChannels)
+    : dsp(NULL), num_channels(numChannels), sample_rate(0.0), max_block(0), planar(NULL) {
+    gua76_default_settings(&settings, numChannels);
+}
+
+Gua76Engine::~Gua76Engine() {
+    if (dsp) free_instance(dsp);
+    free(planar);
+}
+
+bool Gua76Engine::prepare(double sampleRate, uint32_t maxBlock) {
+    bool supported = false;
+    for (int v = 0; v < NUM_VARIANTS; ++v) {
+        if (VARIANTS[v].num_channels == num_channels) supported = true;
+    }
+    if (!supported || maxBlock == 0 || !(sampleRate > 0.0)) return false;
+
+    if (dsp) free_instance(dsp);
+    free(planar);
+    dsp = create_instance(num_channels, sampleRate, maxBlock);
+    planar = (float*)malloc(2 * (size_t)num_channels * maxBlock * sizeof(float));
+    if (!dsp || !planar) {
+        if (dsp) free_instance(dsp);
+        free(planar);
+        dsp = NULL;
+        planar = NULL;
+        return false;
+    }
+    sample_rate = sampleRate;
+    max_block = maxBlock;
+    reset_instance(dsp);
+    return true;
+}
+
+void Gua76Engine::reset() {
+    if (dsp) reset_instance(dsp);
+}
+
+// Un blocco planare senza la gestione della modalità FP (già attiva nel chiamante)
+void Gua76Engine::process_planar(const float* const* in, float* const* out, uint32_t frames,
+                                 const float* const* sidechain) {
+    dsp->settings = settings;
+    process_block(dsp, in, sidechain, out, NULL, frames);
+}
+
+void Gua76Engine::process(const float* const* in, float* const* out, uint32_t frames, const float* const* sidechain) {
+    if (!dsp) return;
+    const FpMode fp_mode = fp_mode_enter();
+    process_planar(in, out, frames, sidechain);
+    fp_mode_leave(fp_mode);
+}
+
+// Interlacciato: a blocchi di max_block frame attraverso i buffer planari (in e out possono coincidere)
+void Gua76Engine::process(const float* in, float* out, uint32_t frames) {
+    if (!dsp) return;
+    float* in_planar[GUA76_MAX_CHANNELS];
+    float* out_planar[GUA76_MAX_CHANNELS];
+    for (int c = 0; c < num_channels; ++c) {
+        in_planar[c] = planar + (size_t)c * max_block;
+        out_planar[c] = planar + (size_t)(num_channels + c) * max_block;
+    }
+    const FpMode fp_mode = fp_mode_enter();
+    for (uint32_t offset = 0; offset < frames; offset += max_block) {
+        const uint32_t n = (frames - offset < max_block) ? frames - offset : max_block;
+        const float* src = in + (size_t)offset * num_channels;
+        for (uint32_t i = 0; i < n; ++i) {
+            for (int c = 0; c < num_channels; ++c) in_planar[c][i] = *src++;
+        }
+        process_planar(in_planar, out_planar, n, NULL);
+        float* dst = out + (size_t)offset * num_channels;
+        for (uint32_t i = 0; i < n; ++i) {
+            for (int c = 0; c < num_channels; ++c) *dst++ = out_planar[c][i];
+        }
+    }
+    fp_mode_leave(fp_mode);
+}
+
+// Più motori con una sola impostazione della modalità FP; i motori non preparati vengono saltati
+void Gua76Engine::process(const Gua76EngineBlock* blocks, int count, uint32_t frames) {
+    const FpMode fp_mode = fp_mode_enter();
+    for (int i = 0; i < count; ++i) {
+        Gua76Engine* engine = blocks[i].engine;
+        if (engine && engine->dsp) engine->process_planar(blocks[i].in, blocks[i].out, frames, blocks[i].sidechain);
+    }
+    fp_mode_leave(fp_mode);
+}
+
+uint32_t Gua76Engine::latencySamples() const {
+    return dsp ? dsp->latency_samples : 0;
+}
+
+float Gua76Engine::gainReductionDb() const {
+    return dsp ? dsp->gr_meter_db : 0.0f;
+}
+
+float Gua76Engine::peakInDb(int channel) const {
+    return (dsp && channel >= 0 && channel < num_channels) ? to_db(dsp->peak_in_linear[channel]) : -90.0f;
+}
+
+float Gua76Engine::peakOutDb(int channel) const {
+    return (dsp && channel >= 0 && channel < num_channels) ? to_db(dsp->peak_out_linear[channel]) : -90.0f;
+}
+
+float Gua76Engine::truePeakOutDb(int channel) const {
+    return (dsp && channel >= 0 && channel < num_channels) ? to_db(dsp->true_peak_out_linear[channel]) : -90.0f;
+}
+#endif
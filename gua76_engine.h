@@ -0,0 +1,182 @@
+#ifndef GUA76_ENGINE_H
+#define GUA76_ENGINE_H
+
+// Motore del compressore incorporabile senza host LV2: stesso DSP del plugin (gua76.cpp), con
+// parametri tipizzati al posto delle porte di controllo e buffer passati a ogni process().
+// Il plugin LV2 legge le porte in un Gua76Settings e chiama lo stesso codice.
+//
+// Uso:
+//   Gua76Engine engine(2);
+//   engine.prepare(48000.0, 512);
+//   engine.setRatio(GUA76_RATIO_8_1);
+//   engine.process(in, out, frames); // Planare: in[c], out[c]
+//
+// prepare() alloca (non va chiamato dal thread audio), process() e i setter no. Un motore non è
+// thread-safe: ogni istanza va usata da un thread alla volta, istanze diverse sono indipendenti.
+
+#include "gua76.h"
+#include <stdint.h>
+
+// Valori dei selettori, uguali a quelli delle porte di controllo
+typedef enum {
+    GUA76_RATIO_4_1 = 0,
+    GUA76_RATIO_8_1,
+    GUA76_RATIO_12_1,
+    GUA76_RATIO_20_1,
+    GUA76_RATIO_ALL_BUTTON
+} Gua76Ratio;
+
+typedef enum {
+    GUA76_OVERSAMPLING_1X = 0,
+    GUA76_OVERSAMPLING_2X,
+    GUA76_OVERSAMPLING_4X,
+    GUA76_OVERSAMPLING_8X,
+    GUA76_OVERSAMPLING_16X
+} Gua76Oversampling;
+
+typedef enum {
+    GUA76_DETECTOR_LINK_INDEPENDENT = 0,
+    GUA76_DETECTOR_LINK_MAX,
+    GUA76_DETECTOR_LINK_SUM
+} Gua76DetectorLink;
+
+typedef enum {
+    GUA76_SATURATION_STANDARD = 0, // Curva semplice
+    GUA76_SATURATION_ADAA1,        // Antiderivata di 1° ordine
+    GUA76_SATURATION_ADAA2         // Antiderivata di 2° ordine
+} Gua76SaturationMode;
+
+typedef enum {
+    GUA76_DETECTOR_RATE_FULL = 0, // Frequenza interna (sovracampionata)
+    GUA76_DETECTOR_RATE_HALF,
+    GUA76_DETECTOR_RATE_QUARTER,
+    GUA76_DETECTOR_RATE_EIGHTH,
+    GUA76_DETECTOR_RATE_LOWEST    // La più bassa: il doppio della frequenza dell'host
+} Gua76DetectorRate;
+
+// Tutti i parametri, con le unità delle porte di controllo. I selettori sono int (valori delle
+// enum sopra) perché arrivano anche dalle porte: i valori fuori intervallo vengono limitati.
+typedef struct {
+    float input;              // Manopola input (0-1)
+    float output;             // Manopola output (0-1)
+    float attack;             // 0 = veloce, 1 = lento
+    float release;            // 0 = veloce, 1 = lento
+    int   ratio;              // Gua76Ratio
+    bool  bypass;
+    float drive;              // Saturazione aggiuntiva (0-1)
+    int   oversampling;       // Gua76Oversampling
+    bool  sidechain_hpf_on;
+    float sidechain_hpf_freq; // Hz
+    float sidechain_filter_q; // Q di HPF e LPF del sidechain
+    bool  sidechain_lpf_on;
+    float sidechain_lpf_freq; // Hz
+    bool  sidechain_listen;   // In uscita il sidechain filtrato
+    bool  midside_mode;       // Solo stereo
+    bool  midside_link;
+    bool  pad_10db;
+    float knee_db;            // Larghezza del soft knee (0 = knee duro)
+    int   detector_link;      // Gua76DetectorLink
+    float lookahead_ms;       // 0-10, 0 = spento
+    int   saturation_mode;    // Gua76SaturationMode
+    int   detector_rate;      // Gua76DetectorRate
+} Gua76Settings;
+
+// Default delle porte di controllo della variante con num_channels canali (gua76.ttl,
+// gua76_variants.ttl): in multicanale il detector parte linkato
+void gua76_default_settings(Gua76Settings* settings, int num_channels);
+
+// Un controllo di ingresso del plugin: indice della porta nella variante stereo, simbolo (della
+// porta e del parametro degli eventi, GUA76_PARAMETER_URI), default della variante stereo e
+// intervallo di gua76.ttl
+typedef struct {
+    int port;           // Gua76PortIndex
+    const char* symbol;
+    float def;
+    float min;
+    float max;
+} Gua76ParameterInfo;
+
+int gua76_num_parameters(void);
+const Gua76ParameterInfo* gua76_parameter_info(int index);         // NULL fuori intervallo
+const Gua76ParameterInfo* gua76_find_parameter(const char* symbol); // NULL se sconosciuto
+float gua76_parameter_default(const Gua76ParameterInfo* info, int num_channels); // Default per variante
+
+struct Gua76;
+class Gua76Engine;
+
+// Un motore con i suoi buffer, per l'elaborazione di più motori in una chiamata
+typedef struct {
+    Gua76Engine* engine;
+    const float* const* in;        // Planare, numChannels() canali
+    float* const* out;
+    const float* const* sidechain; // NULL = sidechain interno (il segnale stesso)
+} Gua76EngineBlock;
+
+class Gua76Engine {
+public:
+    // Canali: 1, 2, 6 o 8 (come le varianti del plugin)
+    explicit Gua76Engine(int numChannels = 2);
+    ~Gua76Engine();
+
+    // Alloca lo stato per una frequenza e una lunghezza massima dei blocchi, poi azzera lo stato.
+    // false se i canali non sono supportati o l'allocazione fallisce.
+    bool prepare(double sampleRate, uint32_t maxBlock);
+    bool isPrepared() const { return dsp != 0; }
+    // Azzera filtri, detector e meter (come activate() del plugin)
+    void reset();
+
+    int numChannels() const { return num_channels; }
+    double sampleRate() const { return sample_rate; }
+
+    // Parametri: valgono dal prossimo process(); i cambiamenti seguono le stesse rampe del plugin
+    void setInput(float norm)                    { settings.input = norm; }
+    void setOutput(float norm)                   { settings.output = norm; }
+    void setAttack(float norm)                   { settings.attack = norm; }
+    void setRelease(float norm)                  { settings.release = norm; }
+    void setRatio(Gua76Ratio ratio)              { settings.ratio = ratio; }
+    void setBypass(bool on)                      { settings.bypass = on; }
+    void setDrive(float norm)                    { settings.drive = norm; }
+    void setOversampling(Gua76Oversampling os)   { settings.oversampling = os; }
+    void setSidechainHpf(bool on, float freqHz)  { settings.sidechain_hpf_on = on; settings.sidechain_hpf_freq = freqHz; }
+    void setSidechainLpf(bool on, float freqHz)  { settings.sidechain_lpf_on = on; settings.sidechain_lpf_freq = freqHz; }
+    void setSidechainFilterQ(float q)            { settings.sidechain_filter_q = q; }
+    void setSidechainListen(bool on)             { settings.sidechain_listen = on; }
+    void setMidSide(bool on, bool link)          { settings.midside_mode = on; settings.midside_link = link; }
+    void setPad10dB(bool on)                     { settings.pad_10db = on; }
+    void setKnee(float db)                       { settings.knee_db = db; }
+    void setDetectorLink(Gua76DetectorLink link) { settings.detector_link = link; }
+    void setLookahead(float ms)                  { settings.lookahead_ms = ms; }
+    void setSaturationMode(Gua76SaturationMode mode) { settings.saturation_mode = mode; }
+    void setDetectorRate(Gua76DetectorRate rate) { settings.detector_rate = rate; }
+    void setSettings(const Gua76Settings& s)     { settings = s; }
+    const Gua76Settings& getSettings() const     { return settings; }
+
+    // Buffer planari (in[c], out[c], anche coincidenti); blocchi di qualunque lunghezza.
+    // sidechain: ingressi esterni per canale (NULL = il segnale stesso).
+    void process(const float* const* in, float* const* out, uint32_t frames, const float* const* sidechain = 0);
+    // Buffer interlacciati (frame di numChannels() campioni, anche coincidenti)
+    void process(const float* in, float* out, uint32_t frames);
+    // Più motori in una chiamata (es. tutti i bus di un mixer), stessa lunghezza per tutti
+    static void process(const Gua76EngineBlock* blocks, int count, uint32_t frames);
+
+    // Stato dopo l'ultimo process()
+    uint32_t latencySamples() const;  // Ritardo del lookahead + ritardo dell'ADAA (campioni dell'host)
+    float gainReductionDb() const;    // Massimo sui canali (negativa)
+    float peakInDb(int channel) const;
+    float peakOutDb(int channel) const;
+    float truePeakOutDb(int channel) const;
+
+private:
+    Gua76Engine(const Gua76Engine&) = delete;
+    Gua76Engine& operator=(const Gua76Engine&) = delete;
+    void process_planar(const float* const* in, float* const* out, uint32_t frames, const float* const* sidechain);
+
+    struct Gua76* dsp;
+    Gua76Settings settings;
+    int num_channels;
+    double sample_rate;
+    uint32_t max_block;
+    float* planar; // 2 * num_channels * max_block campioni, per process() interlacciato
+};
+
+#endif // GUA76_ENGINE_H
@@ -0,0 +1,170 @@
+// Approssimazioni veloci di exp2/log2/pow10 e conversioni dB <-> lineare per il percorso audio.
+//
+// Selezione a compile time con GUA76_FAST_MATH:
+//   1 (default): polinomi e manipolazione dei bit, senza salti né tabelle (vettorizzabili;
+//                con SSE2 ci sono anche le versioni su 4 corsie, stesse operazioni e stessi risultati)
+//   0:           le stesse funzioni chiamano libm (exp2f, log2f, ...): build esatta
+// La build di riferimento (GUA76_REFERENCE_BUILD) usa sempre la versione esatta.
+//
+// Errori massimi (misurati da tools/gua76_mathtest.cpp su tutto il dominio, contro libm in double):
+//   fast_exp2(x)          x in [-126, 127] (fuori: saturato)   errore relativo    <= 2.5e-7
+//   fast_log2(x)          x float normale > 0                  errore assoluto    <= 2.0e-7 per x in [0.5, 2),
+//                                                              altrove relativo   <= 1.5e-7
+//   fast_exp(x)           x in [-87, 88]                       errore relativo    <= 3.0e-7 + |x| * 8e-8
+//   fast_pow10(x)         x in [-37, 38]                       errore relativo    <= 3.0e-7 + |x| * 2.5e-7
+//   fast_db_to_gain(db)   db in [-758, 764]                    errore relativo    <= 3.0e-7 + |db| * 1e-8
+//   fast_gain_to_db(g)    g float normale > 0                  errore assoluto    <= 1.5e-6 dB per g in [0.5, 2),
+//                                                              altrove relativo   <= 2.0e-7
+// (per exp/pow10/dB l'errore cresce con |x| perché l'arrotondamento di x * costante in float
+//  viene amplificato dall'esponenziale: a +-120 dB resta sotto 1.5e-6, cioè 1.3e-5 dB)
+//
+// fast_min/fast_max: minimo/massimo con un confronto (minss/maxss) invece di fminf/fmaxf,
+// che senza -ffinite-math-only sono chiamate a libm. Differiscono solo con NaN.
+#ifndef GUA76_FASTMATH_H
+#define GUA76_FASTMATH_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef GUA76_FAST_MATH
+#define GUA76_FAST_MATH 1
+#endif
+
+#if GUA76_FAST_MATH && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define GUA76_FASTMATH_SSE2 1
+#endif
+
+#define FASTMATH_LOG2_10   3.32192809f  // log2(10)
+#define FASTMATH_LOG2_E    1.44269504f  // log2(e)
+#define FASTMATH_DB_TO_LOG2 0.166096404f // log2(10) / 20
+#define FASTMATH_LOG2_TO_DB 6.02059991f  // 20 * log10(2)
+
+// exp2: 2^x = 2^n * 2^f, n = round(x), f in [-0.5, 0.5]. 2^f - 1 = f * P(f), P minimax di grado 4
+// sull'errore relativo (2^0 = 1 esatto: a 0 dB il gain è esattamente 1).
+#define FASTMATH_EXP2_C1 6.931469776e-01f
+#define FASTMATH_EXP2_C2 2.402224209e-01f
+#define FASTMATH_EXP2_C3 5.550733744e-02f
+#define FASTMATH_EXP2_C4 9.671512649e-03f
+#define FASTMATH_EXP2_C5 1.326472707e-03f
+#define FASTMATH_EXP2_MIN -126.0f
+#define FASTMATH_EXP2_MAX 127.0f
+
+// log2: x = 2^e * m con m in [sqrt(1/2), sqrt(2)), log2(m) = s * Q(s^2) con s = (m - 1) / (m + 1)
+// (|s| <= 0.1716), Q minimax di grado 2 sull'errore assoluto
+#define FASTMATH_LOG2_C1 2.885391289e+00f
+#define FASTMATH_LOG2_C3 9.614708092e-01f
+#define FASTMATH_LOG2_C5 5.989738788e-01f
+#define FASTMATH_SQRT_HALF_BITS 0x3f3504f3u // sqrt(1/2)
+
+static inline float fast_min(float a, float b) {
+#if GUA76_FAST_MATH
+    return (b < a) ? b : a;
+#else
+    return fminf(a, b);
+#endif
+}
+
+static inline float fast_max(float a, float b) {
+#if GUA76_FAST_MATH
+    return (b > a) ? b : a;
+#else
+    return fmaxf(a, b);
+#endif
+}
+
+static inline float fast_exp2(float x) {
+#if GUA76_FAST_MATH
+    x = fast_min(fast_max(x, FASTMATH_EXP2_MIN), FASTMATH_EXP2_MAX);
+    const int32_t n = (int32_t)(x + 128.5f) - 128; // round(x), argomento sempre positivo
+    const float f = x - (float)n;
+    const float p = 1.0f + f * (FASTMATH_EXP2_C1 + f * (FASTMATH_EXP2_C2 + f * (FASTMATH_EXP2_C3 +
+                           f * (FASTMATH_EXP2_C4 + f * FASTMATH_EXP2_C5))));
+    const uint32_t scale_bits = (uint32_t)(n + 127) << 23;
+    float scale;
+    memcpy(&scale, &scale_bits, sizeof(scale));
+    return p * scale;
+#else
+    return exp2f(x);
+#endif
+}
+
+static inline float fast_log2(float x) {
+#if GUA76_FAST_MATH
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    // Esponente rispetto a sqrt(1/2): la mantissa ricostruita cade in [sqrt(1/2), sqrt(2))
+    const int32_t e = (int32_t)(bits - FASTMATH_SQRT_HALF_BITS) >> 23;
+    const uint32_t m_bits = bits - ((uint32_t)e << 23);
+    float m;
+    memcpy(&m, &m_bits, sizeof(m));
+    const float s = (m - 1.0f) / (m + 1.0f);
+    const float s2 = s * s;
+    return (float)e + s * (FASTMATH_LOG2_C1 + s2 * (FASTMATH_LOG2_C3 + s2 * FASTMATH_LOG2_C5));
+#else
+    return log2f(x);
+#endif
+}
+
+static inline float fast_exp(float x) {
+#if GUA76_FAST_MATH
+    return fast_exp2(x * FASTMATH_LOG2_E);
+#else
+    return expf(x);
+#endif
+}
+
+static inline float fast_pow10(float x) {
+#if GUA76_FAST_MATH
+    return fast_exp2(x * FASTMATH_LOG2_10);
+#else
+    return powf(10.0f, x);
+#endif
+}
+
+static inline float fast_db_to_gain(float db) {
+#if GUA76_FAST_MATH
+    return fast_exp2(db * FASTMATH_DB_TO_LOG2);
+#else
+    return powf(10.0f, db / 20.0f);
+#endif
+}
+
+static inline float fast_gain_to_db(float gain) {
+#if GUA76_FAST_MATH
+    return fast_log2(gain) * FASTMATH_LOG2_TO_DB;
+#else
+    return 20.0f * log10f(gain);
+#endif
+}
+
+#ifdef GUA76_FASTMATH_SSE2
+// Versioni su 4 corsie: stesse operazioni nello stesso ordine delle scalari (risultati identici)
+static inline __m128 fast_exp2_ps(__m128 x) {
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(FASTMATH_EXP2_MIN)), _mm_set1_ps(FASTMATH_EXP2_MAX));
+    const __m128i n = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(x, _mm_set1_ps(128.5f))), _mm_set1_epi32(128));
+    const __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(n));
+    __m128 p = _mm_add_ps(_mm_set1_ps(FASTMATH_EXP2_C4), _mm_mul_ps(f, _mm_set1_ps(FASTMATH_EXP2_C5)));
+    p = _mm_add_ps(_mm_set1_ps(FASTMATH_EXP2_C3), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(FASTMATH_EXP2_C2), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(FASTMATH_EXP2_C1), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(f, p));
+    const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(p, scale);
+}
+
+static inline __m128 fast_log2_ps(__m128 x) {
+    const __m128i bits = _mm_castps_si128(x);
+    const __m128i e = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32((int32_t)FASTMATH_SQRT_HALF_BITS)), 23);
+    const __m128 m = _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, 23)));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 s = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    const __m128 s2 = _mm_mul_ps(s, s);
+    __m128 q = _mm_add_ps(_mm_set1_ps(FASTMATH_LOG2_C3), _mm_mul_ps(s2, _mm_set1_ps(FASTMATH_LOG2_C5)));
+    q = _mm_add_ps(_mm_set1_ps(FASTMATH_LOG2_C1), _mm_mul_ps(s2, q));
+    return _mm_add_ps(_mm_cvtepi32_ps(e), _mm_mul_ps(s, q));
+}
+#endif
+
+#endif // GUA76_FASTMATH_H
@@ -0,0 +1,167 @@
+// Gua76 Alias Test
+// Misura l'aliasing della saturazione per ogni modalità (curva semplice, ADAA di ordine 1 e 2)
+// e fattore di oversampling. Un seno di ampiezza costante, a frequenza esatta su un bin dispari
+// della FFT, viene elaborato dalla variante stereo con drive e output al massimo (la curva entra
+// nel clip); a regime si prende la FFT (finestra Blackman-Harris) di ALIASTEST_FFT_SIZE campioni
+// e si somma la potenza fuori dalle armoniche (e dalla continua): sono le armoniche oltre Nyquist
+// ripiegate in banda. Il risultato è in dB rispetto alla fondamentale (più basso = meno aliasing).
+// Con livelli che non arrivano al clip resta l'aliasing della modulazione della GR, uguale in
+// tutte le modalità: l'ADAA agisce solo sulla curva di saturazione.
+//
+// Uso:
+//   gua76_aliastest [--freq HZ] [--drive D] [--input I] [--output O]
+
+#include "gua76.h"
+#include "gua76_host.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIASTEST_SAMPLERATE 48000.0
+#define ALIASTEST_BLOCK 512
+#define ALIASTEST_FFT_SIZE 16384
+#define ALIASTEST_WARMUP_SAMPLES 24576 // GR e filtri a regime prima della finestra analizzata
+#define ALIASTEST_GUARD_BINS 4         // Lobo principale della finestra attorno a ogni armonica
+#define ALIASTEST_MAX_OS_STAGES 3      // 1x .. 8x
+#define ALIASTEST_DEFAULT_FREQS { 2500.0, 5000.0, 10000.0 }
+
+// Elabora il seno con una modalità di saturazione e un oversampling, scrive la finestra analizzata (canale sinistro)
+static bool render(const LV2_Descriptor* desc, double freq, float input_norm, float output_norm, float drive_norm,
+                   int saturation_mode, int os_stages, float* out) {
+    static HostFeatures host;
+    host_features_init(&host, ALIASTEST_BLOCK);
+    LV2_Handle handle = desc->instantiate(desc, ALIASTEST_SAMPLERATE, "", host.features);
+    if (!handle) return false;
+
+    float controls[HOST_NUM_CONTROLS];
+    host_default_controls(controls);
+    controls[GUA76_INPUT] = input_norm;
+    controls[GUA76_OUTPUT] = output_norm;
+    controls[GUA76_DRIVE_SATURATION] = drive_norm;
+    controls[GUA76_OVERSAMPLING_FACTOR] = (float)os_stages;
+    controls[GUA76_SATURATION_MODE] = (float)saturation_mode;
+
+    float block_in[2][ALIASTEST_BLOCK];
+    float block_out[2][ALIASTEST_BLOCK];
+    float* in_ptr[2] = { block_in[0], block_in[1] };
+    float* out_ptr[2] = { block_out[0], block_out[1] };
+    host_connect_ports(desc, handle, 2, in_ptr, out_ptr, NULL, controls, NULL);
+    desc->activate(handle);
+
+    const uint32_t total = ALIASTEST_WARMUP_SAMPLES + ALIASTEST_FFT_SIZE;
+    for (uint32_t pos = 0; pos < total; pos += ALIASTEST_BLOCK) {
+        for (uint32_t i = 0; i < ALIASTEST_BLOCK; ++i) {
+            const double phase = fmod(freq * (double)(pos + i) / ALIASTEST_SAMPLERATE, 1.0);
+            block_in[0][i] = block_in[1][i] = 0.9f * (float)sin(2.0 * M_PI * phase);
+        }
+        desc->run(handle, ALIASTEST_BLOCK);
+        if (pos >= ALIASTEST_WARMUP_SAMPLES) {
+            memcpy(out + (pos - ALIASTEST_WARMUP_SAMPLES), block_out[0], ALIASTEST_BLOCK * sizeof(float));
+        }
+    }
+    if (desc->deactivate) desc->deactivate(handle);
+    desc->cleanup(handle);
+    return true;
+}
+
+// FFT radix-2 sul posto (n potenza di 2)
+static void fft(double* re, double* im, uint32_t n) {
+    for (uint32_t i = 1, j = 0; i < n; ++i) {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        const double angle = -2.0 * M_PI / (double)len;
+        for (uint32_t i = 0; i < n; i += len) {
+            for (uint32_t k = 0; k < len / 2; ++k) {
+                const double wr = cos(angle * k), wi = sin(angle * k);
+                const uint32_t a = i + k, b = i + k + len / 2;
+                const double xr = re[b] * wr - im[b] * wi;
+                const double xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr; im[b] = im[a] - xi;
+                re[a] += xr;        im[a] += xi;
+            }
+        }
+    }
+}
+
+// Potenza fuori dalle armoniche (aliasing) rispetto alla fondamentale, in dB
+static double alias_db(const float* y, uint32_t bin) {
+    static double re[ALIASTEST_FFT_SIZE], im[ALIASTEST_FFT_SIZE];
+    const uint32_t n = ALIASTEST_FFT_SIZE;
+    for (uint32_t i = 0; i < n; ++i) { // Blackman-Harris a 4 termini (lobi laterali a -92 dB)
+        const double t = 2.0 * M_PI * (double)i / (double)n;
+        const double w = 0.35875 - 0.48829 * cos(t) + 0.14128 * cos(2.0 * t) - 0.01168 * cos(3.0 * t);
+        re[i] = w * (double)y[i];
+        im[i] = 0.0;
+    }
+    fft(re, im, n);
+
+    double fundamental = 0.0, alias = 0.0;
+    for (uint32_t k = 0; k <= n / 2; ++k) {
+        const double power = re[k] * re[k] + im[k] * im[k];
+        const uint32_t harmonic = (k + bin / 2) / bin; // Armonica più vicina
+        const uint32_t distance = (k > harmonic * bin) ? k - harmonic * bin : harmonic * bin - k;
+        if (distance > ALIASTEST_GUARD_BINS) alias += power;
+        else if (harmonic == 1) fundamental += power;
+    }
+    return 10.0 * log10((alias + 1e-30) / (fundamental + 1e-30));
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [--freq HZ] [--drive D] [--input I] [--output O]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    double freqs[] = ALIASTEST_DEFAULT_FREQS;
+    int num_freqs = (int)(sizeof(freqs) / sizeof(freqs[0]));
+    float drive_norm = 1.0f;
+    float input_norm = 0.75f;
+    float output_norm = 1.0f;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--freq") && i + 1 < argc) { freqs[0] = atof(argv[++i]); num_freqs = 1; }
+        else if (!strcmp(argv[i], "--drive") && i + 1 < argc) drive_norm = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--input") && i + 1 < argc) input_norm = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--output") && i + 1 < argc) output_norm = (float)atof(argv[++i]);
+        else { usage(argv[0]); return 2; }
+    }
+
+    const LV2_Descriptor* desc = lv2_descriptor(0);
+    if (!desc) {
+        fprintf(stderr, "Descrittore non disponibile\n");
+        return 1;
+    }
+    static const char* const MODE_NAMES[] = { "standard", "adaa1", "adaa2" };
+    static float out[ALIASTEST_FFT_SIZE];
+
+    for (int f = 0; f < num_freqs; ++f) {
+        // Bin dispari più vicino: le armoniche ripiegate non cadono mai su un'armonica in banda
+        uint32_t bin = (uint32_t)(freqs[f] * ALIASTEST_FFT_SIZE / ALIASTEST_SAMPLERATE) | 1u;
+        if (bin < 3) bin = 3;
+        const double freq = (double)bin * ALIASTEST_SAMPLERATE / ALIASTEST_FFT_SIZE;
+        printf("Seno a %.1f Hz (bin %u), drive %.2f, input %.2f, output %.2f: aliasing rispetto alla fondamentale (dB)\n",
+               freq, bin, drive_norm, input_norm, output_norm);
+        printf("  %-9s", "modo");
+        for (int os = 0; os <= ALIASTEST_MAX_OS_STAGES; ++os) printf("  %6ux", 1u << os);
+        printf("\n");
+        for (int mode = 0; mode < 3; ++mode) {
+            printf("  %-9s", MODE_NAMES[mode]);
+            for (int os = 0; os <= ALIASTEST_MAX_OS_STAGES; ++os) {
+                if (!render(desc, freq, input_norm, output_norm, drive_norm, mode, os, out)) {
+                    fprintf(stderr, "Istanziazione fallita\n");
+                    return 1;
+                }
+                printf("  %7.1f", alias_db(out, bin));
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
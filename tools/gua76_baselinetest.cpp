@@ -0,0 +1,234 @@
+// Gua76 Baseline Test
+// Confronta il plugin attuale con la copia congelata del DSP originale (tools/gua76_baseline.cpp,
+// commit 6764504). Il null test confronta due build dello stesso sorgente e non vede una deriva
+// del suono rispetto all'originale: questo test la misura, ai default dei controlli di ciascuna
+// versione.
+//
+// L'oversampling resta spento da entrambe le parti (porta 14 = 0: "off" nell'originale, 1x ora).
+// Acceso, l'originale filtra l'uscita con un passa-basso a fs/16 applicato alla frequenza sbagliata
+// (circa 375 Hz a 48 kHz, un seno a 1 kHz esce a -52 dB): quella differenza è una correzione e
+// non ha senso confrontarla.
+//
+// Due configurazioni:
+// - "sotto soglia": il corpus attenuato di 26 dB, nessun segnale arriva alla soglia (-20 dB; il
+//   detector legge l'ingresso prima del guadagno di input, il controllo non basta). Il percorso
+//   del segnale (guadagni, saturazione a drive 0) è lo stesso: il null deve restare sotto -80 dB
+//   (misurato: -145 dB, solo arrotondamenti).
+// - "default": i segnali comprimono. Il gain computer lavora ora in dB (cf96155) e comprime di più
+//   sopra la soglia della curva lineare originale, (soglia + (x - soglia) / ratio) / x: a 4:1 un
+//   seno a -6 dBFS perde 2.5 dB in più, con l'inviluppo a 0 dBFS la GR passa da -9.8 a -15 dB.
+//   Il livello del plugin attuale, misurato su finestre di 10 ms, non deve mai superare quello
+//   dell'originale di più di 0.5 dB e può scendere al massimo di 6 dB sotto (misurato: da -4.6 a
+//   -1.2 dB; il seno -2.5 dB, come previsto dalle due curve).
+// Esce con codice 1 se una configurazione supera le soglie.
+//
+// Uso:
+//   gua76_baselinetest [--verbose] [--seconds S]
+
+#include "gua76.h"
+#include "gua76_engine.h"
+#include "gua76_host.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" const LV2_Descriptor* gua76_baseline_descriptor(uint32_t index);
+
+#define BASELINETEST_SAMPLERATE 48000.0
+#define BASELINETEST_BLOCK 512
+#define BASELINETEST_DEFAULT_SECONDS 1.0 // Per segnale del corpus
+#define BASELINETEST_WINDOW_MS 10.0
+#define BASELINETEST_BELOW_GAIN_DB -26.0 // Corpus sotto soglia: picco massimo 0.9 -> -27 dBFS
+#define BASELINETEST_SETTLE_MS 100.0     // Escluso all'inizio di ogni segnale (inviluppi a regime)
+#define BASELINETEST_SILENCE_DB -60.0    // Finestre più basse escluse dal confronto di livello
+#define BASELINETEST_MAX_NULL_DB -80.0   // Sotto soglia
+#define BASELINETEST_MAX_LOUDER_DB 0.5   // Default: livello attuale - originale, massimo
+#define BASELINETEST_MAX_QUIETER_DB 6.0  // Default: livello originale - attuale, massimo
+#define BASELINE_NUM_PORTS 29            // Porte 0-28 dell'originale
+
+// Default di manifest.ttl al commit 6764504 (porte di controllo 6-23)
+static void baseline_default_controls(float* controls) {
+    memset(controls, 0, BASELINE_NUM_PORTS * sizeof(float));
+    controls[GUA76_INPUT] = 0.75f;
+    controls[GUA76_OUTPUT] = 0.75f;
+    controls[GUA76_ATTACK] = 0.5f;
+    controls[GUA76_RELEASE] = 0.5f;
+    controls[GUA76_SIDECHAIN_HPF_FREQ] = 100.0f;
+    controls[GUA77_SIDECHAIN_HPF_Q] = 0.707f;
+    controls[GUA76_SIDECHAIN_LPF_FREQ] = 5000.0f;
+    controls[GUA76_MIDSIDE_LINK] = 1.0f;
+}
+
+static void current_default_controls(float* controls) {
+    memset(controls, 0, HOST_NUM_CONTROLS * sizeof(float));
+    for (int i = 0; i < gua76_num_parameters(); ++i) {
+        const Gua76ParameterInfo* p = gua76_parameter_info(i);
+        controls[p->port] = gua76_parameter_default(p, 2);
+    }
+}
+
+// Elabora il corpus stereo; 'baseline' collega le porte dell'originale (0-28, meter compresi)
+static bool render(const LV2_Descriptor* desc, bool baseline, float* controls,
+                   float* const* in, float* const* out, uint32_t total) {
+    static HostFeatures host;
+    host_features_init(&host, BASELINETEST_BLOCK);
+    LV2_Handle handle = desc->instantiate(desc, BASELINETEST_SAMPLERATE, "", host.features);
+    if (!handle) return false;
+
+    float block_in[2][BASELINETEST_BLOCK];
+    float block_out[2][BASELINETEST_BLOCK];
+    float* in_ptr[2] = { block_in[0], block_in[1] };
+    float* out_ptr[2] = { block_out[0], block_out[1] };
+    if (baseline) {
+        for (uint32_t port = 0; port < BASELINE_NUM_PORTS; ++port) {
+            void* location;
+            if (port <= GUA76_AUDIO_IN_R) location = in_ptr[port];
+            else if (port <= GUA76_AUDIO_OUT_R) location = out_ptr[port - GUA76_AUDIO_OUT_L];
+            else if (port <= GUA76_SIDECHAIN_IN_R) location = NULL; // Sidechain interno
+            else location = &controls[port];
+            desc->connect_port(handle, port, location);
+        }
+    } else {
+        host_connect_ports(desc, handle, 2, in_ptr, out_ptr, NULL, controls, NULL);
+    }
+    desc->activate(handle);
+
+    for (uint32_t pos = 0; pos < total; pos += BASELINETEST_BLOCK) {
+        const uint32_t n = (total - pos < BASELINETEST_BLOCK) ? total - pos : BASELINETEST_BLOCK;
+        for (int ch = 0; ch < 2; ++ch) memcpy(block_in[ch], in[ch] + pos, n * sizeof(float));
+        desc->run(handle, n);
+        for (int ch = 0; ch < 2; ++ch) memcpy(out[ch] + pos, block_out[ch], n * sizeof(float));
+    }
+
+    if (desc->deactivate) desc->deactivate(handle);
+    desc->cleanup(handle);
+    return true;
+}
+
+static double to_db_floor(double v) {
+    return (v > 1e-15) ? 10.0 * log10(v) : -300.0; // v è un'energia
+}
+
+typedef struct {
+    double null_db;      // Errore RMS rispetto all'originale (dB), -300 se identico
+    double min_level_db; // Differenza di livello per finestra, attuale - originale
+    double max_level_db;
+    int windows;
+} BaselineResult;
+
+// Confronta un segnale del corpus, saltando l'assestamento iniziale
+static void compare(float* const* ref, float* const* out, uint32_t start, uint32_t n, BaselineResult* r) {
+    const uint32_t settle = (uint32_t)(BASELINETEST_SAMPLERATE * BASELINETEST_SETTLE_MS / 1000.0);
+    const uint32_t window = (uint32_t)(BASELINETEST_SAMPLERATE * BASELINETEST_WINDOW_MS / 1000.0);
+    double err_sq = 0.0, ref_sq = 0.0;
+    r->min_level_db = 0.0;
+    r->max_level_db = 0.0;
+    r->windows = 0;
+    for (uint32_t w = start + settle; w + window <= start + n; w += window) {
+        double ref_w = 0.0, out_w = 0.0;
+        for (int ch = 0; ch < 2; ++ch) {
+            for (uint32_t i = w; i < w + window; ++i) {
+                const double e = (double)out[ch][i] - (double)ref[ch][i];
+                err_sq += e * e;
+                ref_w += (double)ref[ch][i] * ref[ch][i];
+                out_w += (double)out[ch][i] * out[ch][i];
+            }
+        }
+        ref_sq += ref_w;
+        const double floor_energy = 2.0 * window * pow(10.0, BASELINETEST_SILENCE_DB / 10.0);
+        if (ref_w < floor_energy && out_w < floor_energy) continue;
+        const double diff = to_db_floor(out_w) - to_db_floor(ref_w);
+        if (r->windows == 0 || diff < r->min_level_db) r->min_level_db = diff;
+        if (r->windows == 0 || diff > r->max_level_db) r->max_level_db = diff;
+        ++r->windows;
+    }
+    r->null_db = (ref_sq > 0.0) ? to_db_floor(err_sq) - to_db_floor(ref_sq) : to_db_floor(err_sq);
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    double seconds = BASELINETEST_DEFAULT_SECONDS;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else {
+            fprintf(stderr, "Uso: %s [--verbose] [--seconds S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seconds <= 0.0) seconds = BASELINETEST_DEFAULT_SECONDS;
+
+    const uint32_t per_signal = (uint32_t)(BASELINETEST_SAMPLERATE * seconds);
+    const uint32_t total = per_signal * NUM_SIGNALS;
+    float* in[2];
+    float* quiet[2];
+    float* ref_out[2];
+    float* out[2];
+    for (int ch = 0; ch < 2; ++ch) {
+        in[ch] = (float*)malloc(total * sizeof(float));
+        quiet[ch] = (float*)malloc(total * sizeof(float));
+        ref_out[ch] = (float*)malloc(total * sizeof(float));
+        out[ch] = (float*)malloc(total * sizeof(float));
+        if (!in[ch] || !quiet[ch] || !ref_out[ch] || !out[ch]) {
+            fprintf(stderr, "Memoria insufficiente\n");
+            return 2;
+        }
+    }
+    for (int s = 0; s < NUM_SIGNALS; ++s) {
+        float* segment[2] = { in[0] + s * per_signal, in[1] + s * per_signal };
+        host_generate_channels((HostSignal)s, BASELINETEST_SAMPLERATE, segment, 2, per_signal);
+    }
+    const float below_gain = (float)pow(10.0, BASELINETEST_BELOW_GAIN_DB / 20.0);
+    for (int ch = 0; ch < 2; ++ch) {
+        for (uint32_t i = 0; i < total; ++i) quiet[ch][i] = below_gain * in[ch][i];
+    }
+
+    const LV2_Descriptor* baseline_desc = gua76_baseline_descriptor(0);
+    const LV2_Descriptor* current_desc = lv2_descriptor(0);
+    if (!baseline_desc || !current_desc) {
+        fprintf(stderr, "Descrittore non disponibile\n");
+        return 2;
+    }
+
+    int failures = 0;
+    for (int below = 1; below >= 0; --below) {
+        float baseline_controls[BASELINE_NUM_PORTS];
+        float current_controls[HOST_NUM_CONTROLS];
+        baseline_default_controls(baseline_controls);
+        current_default_controls(current_controls);
+        baseline_controls[GUA76_OVERSAMPLING_FACTOR] = 0.0f;
+        current_controls[GUA76_OVERSAMPLING_FACTOR] = 0.0f;
+        float* const* source = below ? quiet : in;
+        if (!render(baseline_desc, true, baseline_controls, source, ref_out, total) ||
+            !render(current_desc, false, current_controls, source, out, total)) {
+            fprintf(stderr, "Istanziazione fallita\n");
+            return 2;
+        }
+
+        const char* name = below ? "sotto soglia" : "default";
+        for (int s = 0; s < NUM_SIGNALS; ++s) {
+            BaselineResult r;
+            compare(ref_out, out, s * per_signal, per_signal, &r);
+            bool fail;
+            if (below) fail = !(r.null_db <= BASELINETEST_MAX_NULL_DB);
+            else fail = !(r.max_level_db <= BASELINETEST_MAX_LOUDER_DB) || !(r.min_level_db >= -BASELINETEST_MAX_QUIETER_DB);
+            if (fail) ++failures;
+            if (fail || verbose) {
+                printf("%s %-12s %-8s null=%7.1f dB  livello %+6.2f .. %+6.2f dB (%d finestre)\n",
+                       fail ? "FAIL" : "ok  ", name, host_signal_name((HostSignal)s), r.null_db,
+                       r.min_level_db, r.max_level_db, r.windows);
+            }
+        }
+    }
+
+    printf("%d segnali x 2 configurazioni, %d fuori soglia (sotto soglia: null <= %.0f dB; "
+           "default: livello tra -%.1f e +%.1f dB)\n", NUM_SIGNALS, failures,
+           BASELINETEST_MAX_NULL_DB, BASELINETEST_MAX_QUIETER_DB, BASELINETEST_MAX_LOUDER_DB);
+
+    for (int ch = 0; ch < 2; ++ch) {
+        free(in[ch]); free(quiet[ch]); free(ref_out[ch]); free(out[ch]);
+    }
+    return failures > 0 ? 1 : 0;
+}
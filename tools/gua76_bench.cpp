@@ -0,0 +1,302 @@
+// Gua76 Benchmark
+// Host minimale che pilota il plugin tramite lv2_descriptor() (linkato direttamente con gua76.o),
+// collega tutte le porte della variante (stereo, mono, 5.1, 7.1) e misura run() con segnali sintetici.
+//
+// Uso:
+//   gua76_bench [--quick] [--seconds S] [--out FILE] [--baseline FILE] [--tolerance PCT]
+//
+// Il risultato è JSON (una riga per caso) su stdout o in --out. Con --baseline ogni caso viene
+// confrontato con un JSON salvato in precedenza: i casi più lenti oltre la tolleranza
+// vengono segnalati su stderr e il programma esce con codice 1.
+
+#include "gua76.h"
+#include "gua76_host.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_BLOCK 8192
+#define BENCH_DEFAULT_SECONDS 2.0
+#define BENCH_REPEATS 3 // Si tiene il tempo migliore (meno disturbato dal sistema)
+#define BENCH_DEFAULT_TOLERANCE_PCT 10.0
+#define BENCH_MAX_CASES 64
+
+// Varianti: indice di lv2_descriptor() e numero di canali
+typedef struct {
+    uint32_t index;
+    int channels;
+} BenchVariant;
+
+static const BenchVariant BENCH_VARIANTS[] = { { 0, 2 }, { 1, 1 }, { 2, 6 }, { 3, 8 } };
+#define BENCH_NUM_VARIANTS ((int)(sizeof(BENCH_VARIANTS) / sizeof(BENCH_VARIANTS[0])))
+
+// --- Caso di benchmark ---
+typedef struct {
+    int variant;            // Indice in BENCH_VARIANTS
+    int detector_link;      // 0 = indipendente, 1 = massimo, 2 = somma
+    float lookahead_ms;
+    HostSignal signal;
+    double samplerate;
+    uint32_t block;
+    int os_stages;          // 0 = 1x ... 4 = 16x
+    bool midside;
+    bool sidechain_filters; // HPF + LPF sidechain attivi
+    bool external_sidechain;
+    bool all_button;
+    char id[128];
+} BenchCase;
+
+typedef struct {
+    double ns_per_sample;   // Per frame (tutti i canali), tempo migliore su BENCH_REPEATS
+    double realtime_factor; // Secondi di audio elaborati per secondo di CPU
+    double baseline_ns_per_sample; // 0 se non c'è baseline per questo caso
+} BenchResult;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench_case_set_id(BenchCase* c) {
+    snprintf(c->id, sizeof(c->id), "signal=%s sr=%.0f block=%u os=%ux ms=%d scf=%d extsc=%d allbutton=%d",
+             host_signal_name(c->signal), c->samplerate, c->block, 1u << c->os_stages,
+             c->midside ? 1 : 0, c->sidechain_filters ? 1 : 0, c->external_sidechain ? 1 : 0, c->all_button ? 1 : 0);
+    // Gli id dei casi stereo indipendenti restano quelli delle baseline salvate prima delle varianti
+    if (c->variant != 0 || c->detector_link != 0) {
+        const size_t len = strlen(c->id);
+        snprintf(c->id + len, sizeof(c->id) - len, " ch=%d link=%d", BENCH_VARIANTS[c->variant].channels, c->detector_link);
+    }
+    if (c->lookahead_ms > 0.0f) {
+        const size_t len = strlen(c->id);
+        snprintf(c->id + len, sizeof(c->id) - len, " lookahead=%.0fms", c->lookahead_ms);
+    }
+}
+
+// Casi del benchmark: un caso di riferimento e una variazione alla volta per ogni dimensione
+static int build_cases(BenchCase* cases, bool quick) {
+    static const uint32_t BLOCKS[] = { 16, 64, 256, 1024, 4096, 8192 };
+    static const double SAMPLERATES[] = { 44100.0, 96000.0 };
+    BenchCase base;
+    memset(&base, 0, sizeof(base));
+    base.signal = SIGNAL_DRUMS;
+    base.samplerate = 48000.0;
+    base.block = 512;
+    base.os_stages = 3;
+
+    int n = 0;
+    cases[n++] = base;
+    for (int s = 0; s < NUM_SIGNALS; ++s) {
+        if (s == (int)base.signal) continue;
+        BenchCase c = base; c.signal = (HostSignal)s; cases[n++] = c;
+    }
+    for (int os = 0; os <= 4; ++os) {
+        if (os == base.os_stages) continue;
+        BenchCase c = base; c.os_stages = os; cases[n++] = c;
+    }
+    if (!quick) {
+        for (size_t b = 0; b < sizeof(BLOCKS) / sizeof(BLOCKS[0]); ++b) {
+            BenchCase c = base; c.block = BLOCKS[b]; cases[n++] = c;
+        }
+        for (size_t s = 0; s < sizeof(SAMPLERATES) / sizeof(SAMPLERATES[0]); ++s) {
+            BenchCase c = base; c.samplerate = SAMPLERATES[s]; cases[n++] = c;
+        }
+    }
+    { BenchCase c = base; c.midside = true; cases[n++] = c; }
+    { BenchCase c = base; c.sidechain_filters = true; cases[n++] = c; }
+    { BenchCase c = base; c.external_sidechain = true; cases[n++] = c; }
+    { BenchCase c = base; c.all_button = true; cases[n++] = c; }
+    { BenchCase c = base; c.detector_link = 1; cases[n++] = c; }
+    { BenchCase c = base; c.lookahead_ms = 5.0f; cases[n++] = c; }
+    for (int v = 1; v < BENCH_NUM_VARIANTS; ++v) {
+        BenchCase c = base;
+        c.variant = v;
+        c.detector_link = (BENCH_VARIANTS[v].channels > 2) ? 1 : 0; // Default delle varianti multicanale
+        cases[n++] = c;
+    }
+
+    for (int i = 0; i < n; ++i) bench_case_set_id(&cases[i]);
+    return n;
+}
+
+// Esegue un caso: istanzia il plugin, collega tutte le porte e misura il tempo di run()
+static bool run_case(const BenchCase* c, double seconds, BenchResult* result) {
+    const int channels = BENCH_VARIANTS[c->variant].channels;
+    const LV2_Descriptor* desc = lv2_descriptor(BENCH_VARIANTS[c->variant].index);
+    if (!desc) return false;
+
+    const uint32_t total = (uint32_t)(c->samplerate * seconds);
+    float* sig[GUA76_MAX_CHANNELS] = { NULL };
+    float* in[GUA76_MAX_CHANNELS] = { NULL };
+    float* out[GUA76_MAX_CHANNELS] = { NULL };
+    bool allocated = true;
+    for (int ch = 0; ch < channels; ++ch) {
+        sig[ch] = (float*)malloc(total * sizeof(float));
+        in[ch] = (float*)malloc(c->block * sizeof(float));
+        out[ch] = (float*)malloc(c->block * sizeof(float));
+        allocated = allocated && sig[ch] && in[ch] && out[ch];
+    }
+    if (!allocated || !host_generate_channels(c->signal, c->samplerate, sig, channels, total)) {
+        for (int ch = 0; ch < channels; ++ch) { free(sig[ch]); free(in[ch]); free(out[ch]); }
+        return false;
+    }
+
+    // Feature: urid:map e opzioni bufsz con la dimensione di blocco del caso
+    static HostFeatures host;
+    static HostNotifyBuffer notify; // Telemetria: collegata come farebbe un host con la GUI aperta
+    host_features_init(&host, c->block);
+
+    LV2_Handle handle = desc->instantiate(desc, c->samplerate, "", host.features);
+    if (!handle) {
+        for (int ch = 0; ch < channels; ++ch) { free(sig[ch]); free(in[ch]); free(out[ch]); }
+        return false;
+    }
+
+    // Controlli: valori tipici di utilizzo, più i toggle del caso
+    float controls[HOST_NUM_CONTROLS];
+    host_default_controls(controls);
+    controls[GUA76_RATIO] = c->all_button ? 4.0f : 0.0f;
+    controls[GUA76_OVERSAMPLING_FACTOR] = (float)c->os_stages;
+    controls[GUA76_SIDECHAIN_HPF_ON] = c->sidechain_filters ? 1.0f : 0.0f;
+    controls[GUA76_SIDECHAIN_HPF_FREQ] = 100.0f;
+    controls[GUA76_SIDECHAIN_LPF_ON] = c->sidechain_filters ? 1.0f : 0.0f;
+    controls[GUA76_SIDECHAIN_LPF_FREQ] = 8000.0f;
+    controls[GUA76_MIDSIDE_MODE] = c->midside ? 1.0f : 0.0f;
+    controls[GUA76_MIDSIDE_LINK] = 1.0f;
+    controls[GUA76_DETECTOR_LINK] = (float)c->detector_link;
+    controls[GUA76_LOOKAHEAD] = c->lookahead_ms;
+
+    // Sidechain esterno: i canali di ingresso in ordine inverso
+    float* sidechain[GUA76_MAX_CHANNELS];
+    for (int ch = 0; ch < channels; ++ch) sidechain[ch] = in[channels - 1 - ch];
+    host_connect_ports(desc, handle, channels, in, out, c->external_sidechain ? sidechain : NULL, controls, &notify);
+    desc->activate(handle);
+
+    double best = -1.0;
+    for (int rep = 0; rep <= BENCH_REPEATS; ++rep) { // Il primo giro serve da riscaldamento
+        double elapsed = 0.0;
+        for (uint32_t pos = 0; pos + c->block <= total; pos += c->block) {
+            for (int ch = 0; ch < channels; ++ch) memcpy(in[ch], sig[ch] + pos, c->block * sizeof(float));
+            host_notify_reset(&host, &notify);
+            const double t0 = now_seconds();
+            desc->run(handle, c->block);
+            elapsed += now_seconds() - t0;
+        }
+        if (rep > 0 && (best < 0.0 || elapsed < best)) best = elapsed;
+    }
+
+    const uint32_t processed = (total / c->block) * c->block;
+    result->ns_per_sample = best * 1e9 / (double)processed;
+    result->realtime_factor = ((double)processed / c->samplerate) / best;
+
+    desc->deactivate(handle);
+    desc->cleanup(handle);
+    for (int ch = 0; ch < channels; ++ch) { free(sig[ch]); free(in[ch]); free(out[ch]); }
+    return true;
+}
+
+// Legge ns_per_sample dal JSON di una baseline (formato scritto da questo programma, un caso per riga)
+static double baseline_lookup(FILE* f, const char* id) {
+    if (!f) return 0.0;
+    char line[1024];
+    char key[160];
+    snprintf(key, sizeof(key), "\"id\": \"%s\"", id);
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (!strstr(line, key)) continue;
+        const char* field = strstr(line, "\"ns_per_sample\": ");
+        if (field) return atof(field + strlen("\"ns_per_sample\": "));
+    }
+    return 0.0;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [--quick] [--seconds S] [--out FILE] [--baseline FILE] [--tolerance PCT]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    double seconds = BENCH_DEFAULT_SECONDS;
+    double tolerance_pct = BENCH_DEFAULT_TOLERANCE_PCT;
+    const char* out_path = NULL;
+    const char* baseline_path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--quick")) quick = true;
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) out_path = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baseline_path = argv[++i];
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance_pct = atof(argv[++i]);
+        else { usage(argv[0]); return 2; }
+    }
+    if (seconds <= 0.0) seconds = BENCH_DEFAULT_SECONDS;
+
+    const LV2_Descriptor* desc = lv2_descriptor(0);
+    if (!desc) {
+        fprintf(stderr, "lv2_descriptor(0) non disponibile\n");
+        return 2;
+    }
+
+    FILE* baseline = NULL;
+    if (baseline_path) {
+        baseline = fopen(baseline_path, "r");
+        if (!baseline) {
+            fprintf(stderr, "Impossibile aprire la baseline %s\n", baseline_path);
+            return 2;
+        }
+    }
+
+    static BenchCase cases[BENCH_MAX_CASES];
+    static BenchResult results[BENCH_MAX_CASES];
+    const int num_cases = build_cases(cases, quick);
+
+    int regressions = 0;
+    for (int i = 0; i < num_cases; ++i) {
+        if (!run_case(&cases[i], seconds, &results[i])) {
+            fprintf(stderr, "Caso fallito: %s\n", cases[i].id);
+            if (baseline) fclose(baseline);
+            return 2;
+        }
+        results[i].baseline_ns_per_sample = baseline_lookup(baseline, cases[i].id);
+        const double base = results[i].baseline_ns_per_sample;
+        const double change = (base > 0.0) ? (results[i].ns_per_sample / base - 1.0) * 100.0 : 0.0;
+        const bool regression = (base > 0.0 && change > tolerance_pct);
+        if (regression) ++regressions;
+        fprintf(stderr, "%-80s %9.1f ns/sample %8.1fx realtime%s", cases[i].id,
+                results[i].ns_per_sample, results[i].realtime_factor, regression ? "  REGRESSIONE" : "");
+        if (base > 0.0) fprintf(stderr, " (%+.1f%%)", change);
+        fprintf(stderr, "\n");
+    }
+    if (baseline) fclose(baseline);
+
+    FILE* out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Impossibile scrivere %s\n", out_path);
+        return 2;
+    }
+    fprintf(out, "{\n  \"plugin\": \"%s\",\n  \"seconds_per_case\": %.3f,\n  \"tolerance_pct\": %.1f,\n  \"regressions\": %d,\n  \"cases\": [\n",
+            desc->URI, seconds, tolerance_pct, regressions);
+    for (int i = 0; i < num_cases; ++i) {
+        const BenchCase* c = &cases[i];
+        const BenchResult* r = &results[i];
+        fprintf(out, "    {\"id\": \"%s\", \"channels\": %d, \"detector_link\": %d, \"lookahead_ms\": %.1f, \"signal\": \"%s\", \"samplerate\": %.0f, \"block\": %u, \"oversampling\": %u, "
+                     "\"midside\": %s, \"sidechain_filters\": %s, \"external_sidechain\": %s, \"all_button\": %s, "
+                     "\"ns_per_sample\": %.2f, \"realtime_factor\": %.2f, \"instances_per_core\": %d",
+                c->id, BENCH_VARIANTS[c->variant].channels, c->detector_link, c->lookahead_ms, host_signal_name(c->signal), c->samplerate, c->block, 1u << c->os_stages,
+                c->midside ? "true" : "false", c->sidechain_filters ? "true" : "false",
+                c->external_sidechain ? "true" : "false", c->all_button ? "true" : "false",
+                r->ns_per_sample, r->realtime_factor, (int)floor(r->realtime_factor));
+        if (r->baseline_ns_per_sample > 0.0) {
+            fprintf(out, ", \"baseline_ns_per_sample\": %.2f, \"change_pct\": %.2f",
+                    r->baseline_ns_per_sample, (r->ns_per_sample / r->baseline_ns_per_sample - 1.0) * 100.0);
+        }
+        fprintf(out, "}%s\n", (i + 1 < num_cases) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) fclose(out);
+
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+// Gua76 Detector Test
+// Valida il detector a frequenza ridotta (porta detector_rate) contro quello alla frequenza
+// interna: lo stesso corpus di segnali generati viene elaborato con detector_rate = 0 e con
+// ogni frequenza ridotta (1/2 .. 1/8 e la più bassa), per oversampling 2x/4x/8x, ratio 4:1 e
+// All-Button, filtri sidechain accesi e spenti, Mid-Side linkato, lookahead e la variante 5.1
+// con detector linkato. Il detector non scende sotto il doppio della frequenza dell'host: a 1x
+// e a 2x la porta non ha effetto, come le frequenze oltre quel limite, e l'uscita deve essere
+// identica.
+//
+// Per ogni combinazione vengono riportati errore assoluto massimo e profondità del null (errore
+// RMS rispetto all'uscita del detector a frequenza piena, dB). Resta solo l'errore del gain
+// interpolato e dell'inviluppo calcolato su meno campioni: le soglie sono quelle misurate
+// (null sotto -50 dB, errore massimo 0.05 circa) con un margine.
+// Esce con codice 1 se una combinazione supera le soglie.
+//
+// Uso:
+//   gua76_detectortest [--verbose] [--seconds S] [--max-abs X] [--min-null-depth DB]
+
+#include "gua76.h"
+#include "gua76_host.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DETECTORTEST_SAMPLERATE 48000.0
+#define DETECTORTEST_BLOCK 512
+#define DETECTORTEST_DEFAULT_SECONDS 0.25 // Per segnale del corpus
+#define DETECTORTEST_DEFAULT_MAX_ABS 0.08
+#define DETECTORTEST_DEFAULT_MIN_NULL_DEPTH_DB 45.0
+#define DETECTORTEST_MAX_RATE 4 // 4 = la più bassa (il doppio della frequenza dell'host)
+
+// Una combinazione di controlli da verificare
+typedef struct {
+    uint32_t variant;  // Indice del descrittore (0 = stereo, 2 = 5.1)
+    int channels;
+    int detector_link;
+    int ratio;         // 0..4 (4 = All-Button)
+    bool midside;      // Mid-Side linkato
+    bool sidechain_filters;
+    int os_stages;     // 0 = 1x ... 3 = 8x
+    float lookahead_ms;
+} DetectorCase;
+
+typedef struct {
+    double max_abs;
+    double null_depth_db;
+} DetectorResult;
+
+static double to_db_floor(double v) {
+    return (v > 1e-15) ? 20.0 * log10(v) : -300.0;
+}
+
+// Elabora il corpus (un buffer per canale) con una frequenza del detector e scrive le uscite
+static bool render(const LV2_Descriptor* desc, const DetectorCase* c, int detector_rate,
+                   float* const* in, float* const* out, uint32_t total) {
+    static HostFeatures host;
+    host_features_init(&host, DETECTORTEST_BLOCK);
+    LV2_Handle handle = desc->instantiate(desc, DETECTORTEST_SAMPLERATE, "", host.features);
+    if (!handle) return false;
+
+    float controls[HOST_NUM_CONTROLS];
+    host_default_controls(controls);
+    controls[GUA76_RATIO] = (float)c->ratio;
+    controls[GUA76_OVERSAMPLING_FACTOR] = (float)c->os_stages;
+    controls[GUA76_SIDECHAIN_HPF_ON] = c->sidechain_filters ? 1.0f : 0.0f;
+    controls[GUA76_SIDECHAIN_LPF_ON] = c->sidechain_filters ? 1.0f : 0.0f;
+    controls[GUA76_MIDSIDE_MODE] = c->midside ? 1.0f : 0.0f;
+    controls[GUA76_MIDSIDE_LINK] = c->midside ? 1.0f : 0.0f;
+    controls[GUA76_DETECTOR_LINK] = (float)c->detector_link;
+    controls[GUA76_LOOKAHEAD] = c->lookahead_ms;
+    controls[GUA76_DETECTOR_RATE] = (float)detector_rate;
+
+    // Sidechain interno, telemetria scollegata
+    const uint32_t channels = (uint32_t)c->channels;
+    float block_in[GUA76_MAX_CHANNELS][DETECTORTEST_BLOCK];
+    float block_out[GUA76_MAX_CHANNELS][DETECTORTEST_BLOCK];
+    float* in_ptr[GUA76_MAX_CHANNELS];
+    float* out_ptr[GUA76_MAX_CHANNELS];
+    for (uint32_t ch = 0; ch < channels; ++ch) {
+        in_ptr[ch] = block_in[ch];
+        out_ptr[ch] = block_out[ch];
+    }
+    host_connect_ports(desc, handle, c->channels, in_ptr, out_ptr, NULL, controls, NULL);
+    desc->activate(handle);
+
+    for (uint32_t pos = 0; pos < total; pos += DETECTORTEST_BLOCK) {
+        const uint32_t n = (total - pos < DETECTORTEST_BLOCK) ? total - pos : DETECTORTEST_BLOCK;
+        for (uint32_t ch = 0; ch < channels; ++ch) memcpy(block_in[ch], in[ch] + pos, n * sizeof(float));
+        desc->run(handle, n);
+        for (uint32_t ch = 0; ch < channels; ++ch) memcpy(out[ch] + pos, block_out[ch], n * sizeof(float));
+    }
+
+    desc->deactivate(handle);
+    desc->cleanup(handle);
+    return true;
+}
+
+static void compare(float* const* ref, float* const* out, int channels, uint32_t total, DetectorResult* r) {
+    double max_abs = 0.0, err_sq = 0.0, ref_sq = 0.0;
+    for (int ch = 0; ch < channels; ++ch) {
+        for (uint32_t i = 0; i < total; ++i) {
+            const double e = (double)out[ch][i] - (double)ref[ch][i];
+            const double ae = fabs(e);
+            if (ae > max_abs || ae != ae) max_abs = (ae != ae) ? INFINITY : ae;
+            err_sq += e * e;
+            ref_sq += (double)ref[ch][i] * ref[ch][i];
+        }
+    }
+    const double err_rms = sqrt(err_sq / ((double)channels * total));
+    const double ref_rms = sqrt(ref_sq / ((double)channels * total));
+    r->max_abs = max_abs;
+    r->null_depth_db = (ref_rms > 0.0) ? to_db_floor(err_rms) - to_db_floor(ref_rms) : to_db_floor(err_rms);
+}
+
+static int build_cases(DetectorCase* cases) {
+    int n = 0;
+    for (int os = 0; os <= 3; ++os)
+    for (int ratio = 0; ratio < 5; ratio += 4)
+    for (int scf = 0; scf < 2; ++scf)
+    for (int ms = 0; ms < 2; ++ms) {
+        DetectorCase c = { 0, 2, 0, ratio, ms != 0, scf != 0, os, 0.0f };
+        cases[n++] = c;
+    }
+    for (int os = 1; os <= 3; ++os) {
+        DetectorCase la = { 0, 2, 0, 0, false, true, os, 1.0f };
+        DetectorCase surround = { 2, 6, 1, 0, false, true, os, 0.0f };
+        cases[n++] = la;
+        cases[n++] = surround;
+    }
+    return n;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [--verbose] [--seconds S] [--max-abs X] [--min-null-depth DB]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    double seconds = DETECTORTEST_DEFAULT_SECONDS;
+    double max_abs_limit = DETECTORTEST_DEFAULT_MAX_ABS;
+    double min_null_depth = DETECTORTEST_DEFAULT_MIN_NULL_DEPTH_DB;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--max-abs") && i + 1 < argc) max_abs_limit = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--min-null-depth") && i + 1 < argc) min_null_depth = atof(argv[++i]);
+        else { usage(argv[0]); return 2; }
+    }
+    if (seconds <= 0.0) seconds = DETECTORTEST_DEFAULT_SECONDS;
+
+    // Corpus: tutti i segnali di test in sequenza, su GUA76_MAX_CHANNELS canali
+    const uint32_t per_signal = (uint32_t)(DETECTORTEST_SAMPLERATE * seconds);
+    const uint32_t total = per_signal * NUM_SIGNALS;
+    float* in[GUA76_MAX_CHANNELS];
+    float* ref_out[GUA76_MAX_CHANNELS];
+    float* out[GUA76_MAX_CHANNELS];
+    for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) {
+        in[ch] = (float*)malloc(total * sizeof(float));
+        ref_out[ch] = (float*)malloc(total * sizeof(float));
+        out[ch] = (float*)malloc(total * sizeof(float));
+        if (!in[ch] || !ref_out[ch] || !out[ch]) {
+            fprintf(stderr, "Memoria insufficiente\n");
+            return 2;
+        }
+    }
+    for (int s = 0; s < NUM_SIGNALS; ++s) {
+        float* segment[GUA76_MAX_CHANNELS];
+        for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) segment[ch] = in[ch] + s * per_signal;
+        host_generate_channels((HostSignal)s, DETECTORTEST_SAMPLERATE, segment, GUA76_MAX_CHANNELS, per_signal);
+    }
+
+    static DetectorCase cases[64];
+    const int num_cases = build_cases(cases);
+    int failures = 0, runs = 0;
+    DetectorResult worst = { 0.0, -300.0 };
+    for (int i = 0; i < num_cases; ++i) {
+        const DetectorCase* c = &cases[i];
+        const LV2_Descriptor* desc = lv2_descriptor(c->variant);
+        if (!desc) {
+            fprintf(stderr, "Descrittore non disponibile\n");
+            return 2;
+        }
+        if (!render(desc, c, 0, in, ref_out, total)) {
+            fprintf(stderr, "Istanziazione fallita\n");
+            return 2;
+        }
+        for (int rate = 1; rate <= DETECTORTEST_MAX_RATE; ++rate) {
+            if (rate > c->os_stages + 1) break; // Oltre: uguale a rate 4
+            if (!render(desc, c, rate, in, out, total)) {
+                fprintf(stderr, "Istanziazione fallita\n");
+                return 2;
+            }
+            DetectorResult r;
+            compare(ref_out, out, c->channels, total, &r);
+            ++runs;
+
+            // Frequenza del detector effettiva: mai sotto il doppio di quella dell'host. Dove la
+            // porta non ha effetto (1x, 2x, o oltre il limite) l'uscita deve essere identica
+            const int shift = (rate < c->os_stages - 1) ? rate : (c->os_stages > 1 ? c->os_stages - 1 : 0);
+            bool fail;
+            if (shift == 0) fail = !(r.max_abs == 0.0);
+            else fail = !(r.max_abs <= max_abs_limit) || !(r.null_depth_db <= -min_null_depth);
+            if (fail) ++failures;
+            if (shift > 0) {
+                if (r.max_abs > worst.max_abs) worst.max_abs = r.max_abs;
+                if (r.null_depth_db > worst.null_depth_db) worst.null_depth_db = r.null_depth_db;
+            }
+
+            if (fail || verbose) {
+                printf("%s ch=%d link=%d la=%.0f os=%ux rate=%d ratio=%d ms=%d scf=%d  max_abs=%.3e  null=%7.1f dB\n",
+                       fail ? "FAIL" : "ok  ", c->channels, c->detector_link, c->lookahead_ms, 1u << c->os_stages,
+                       rate, c->ratio, c->midside ? 1 : 0, c->sidechain_filters ? 1 : 0, r.max_abs, r.null_depth_db);
+            }
+        }
+    }
+
+    printf("%d confronti, %d fuori soglia (max_abs <= %.2f, null <= -%.0f dB)\n",
+           runs, failures, max_abs_limit, min_null_depth);
+    printf("Peggiori: max_abs=%.3e  null=%.1f dB\n", worst.max_abs, worst.null_depth_db);
+
+    for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) {
+        free(in[ch]); free(ref_out[ch]); free(out[ch]);
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,338 @@
+// Gua76 Event Test
+// Verifica l'automazione sample-accurate della porta control: lo stesso corpus di segnali
+// generati viene elaborato in due modi, con la stessa automazione (cambi di input, output,
+// attack, release, ratio, drive, filtri sidechain, knee, lookahead, bypass, oversampling,
+// saturazione e frequenza del detector a frame pseudo-casuali, a volte più cambi nello stesso frame
+// e a volte fuori dall'intervallo della porta, che il plugin deve limitare come l'host):
+//   - eventi: blocchi dell'host lunghi, i cambi arrivano come eventi patch:Set sulla porta control
+//   - porte:  l'host spezza i blocchi nei frame dei cambi e scrive i valori sulle porte di controllo
+// Le uscite devono essere identiche bit per bit, per tutte le varianti (mono, stereo, 5.1, 7.1)
+// con e senza oversampling. Per i due modi viene riportato anche il tempo di elaborazione.
+// Esce con codice 1 se un'uscita è diversa.
+//
+// Uso:
+//   gua76_eventtest [--verbose] [--seconds S] [--block N] [--interval N]
+
+#include "gua76.h"
+#include "gua76_engine.h"
+#include "gua76_host.h"
+#include <lv2/atom/forge.h>
+#include <lv2/patch/patch.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define EVENTTEST_SAMPLERATE 48000.0
+#define EVENTTEST_DEFAULT_BLOCK 1024
+#define EVENTTEST_MAX_BLOCK 8192
+#define EVENTTEST_DEFAULT_SECONDS 0.25  // Per segnale del corpus
+#define EVENTTEST_DEFAULT_INTERVAL 300  // Distanza media tra i cambi (campioni)
+#define EVENTTEST_SEQUENCE_CAPACITY 65536
+
+// Parametri automatizzati, con l'intervallo dei valori estratti
+typedef struct {
+    Gua76PortIndex port;
+    const char* symbol;
+    float min;
+    float max;
+    bool integer; // Valori interi, inviati come atom:Int
+} EventParameter;
+
+static const EventParameter PARAMETERS[] = {
+    { GUA76_INPUT,              "input",               0.3f,    1.0f, false },
+    { GUA76_OUTPUT,             "output",              0.3f,    0.9f, false },
+    { GUA76_ATTACK,             "attack",              0.0f,    1.0f, false },
+    { GUA76_RELEASE,            "release",             0.0f,    1.0f, false },
+    { GUA76_RATIO,              "ratio",               0.0f,    4.0f, true },
+    { GUA76_DRIVE_SATURATION,   "drive_saturation",    0.0f,    1.0f, false },
+    { GUA76_SIDECHAIN_HPF_ON,   "sidechain_hpf_on",    0.0f,    1.0f, true },
+    { GUA76_SIDECHAIN_HPF_FREQ, "sidechain_hpf_freq",  20.0f,   500.0f, false },
+    { GUA76_SIDECHAIN_LPF_FREQ, "sidechain_lpf_freq",  2000.0f, 20000.0f, false },
+    { GUA76_KNEE,               "knee",                0.0f,    24.0f, false },
+    { GUA76_LOOKAHEAD,          "lookahead",           0.0f,    5.0f, false },
+    { GUA76_BYPASS,             "bypass",              0.0f,    1.0f, true },
+    { GUA76_OVERSAMPLING_FACTOR,"oversampling_factor", 0.0f,    3.0f, true },
+    { GUA76_SATURATION_MODE,    "saturation_mode",     0.0f,    2.0f, true },
+    { GUA76_DETECTOR_RATE,      "detector_rate",       0.0f,    4.0f, true }
+};
+#define NUM_PARAMETERS ((int)(sizeof(PARAMETERS) / sizeof(PARAMETERS[0])))
+
+// Un cambio dell'automazione (frame dall'inizio del corpus). Alcuni eventi sono fuori
+// dall'intervallo della porta: sulla porta va il valore limitato, come farebbe l'host.
+typedef struct {
+    uint32_t frame;
+    int parameter;
+    float value;      // Nell'evento
+    float port_value; // Sulla porta
+} ScheduledEvent;
+
+// Una combinazione da verificare
+typedef struct {
+    uint32_t variant; // Indice del descrittore (0 = stereo, 1 = mono, 2 = 5.1, 3 = 7.1)
+    int channels;
+    int os_stages;    // Oversampling iniziale (l'automazione lo cambia)
+    bool automate_os; // Anche l'oversampling automatizzato
+} EventCase;
+
+// Sequenza di ingresso per la porta control, da riscrivere prima di ogni run()
+typedef struct {
+    LV2_Atom_Sequence seq;
+    uint8_t events[EVENTTEST_SEQUENCE_CAPACITY];
+} EventSequenceBuffer;
+
+typedef struct {
+    LV2_URID patch_set;
+    LV2_URID patch_property;
+    LV2_URID patch_value;
+    LV2_URID parameter[NUM_PARAMETERS];
+} EventUrids;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Automazione deterministica: cambi a distanza pseudo-casuale, uno su otto nello stesso frame del precedente
+static int build_schedule(const EventCase* c, uint32_t total, uint32_t interval, ScheduledEvent* events, int capacity) {
+    uint32_t seed = 4242u + c->variant * 17u + (uint32_t)c->os_stages;
+    uint32_t frame = 0;
+    int n = 0;
+    while (n < capacity) {
+        seed = seed * 1664525u + 1013904223u;
+        if (n % 8 != 7) frame += 1 + (seed >> 8) % (2 * interval);
+        if (frame >= total) break;
+        seed = seed * 1664525u + 1013904223u;
+        int p = (int)((seed >> 8) % NUM_PARAMETERS);
+        if (PARAMETERS[p].port == GUA76_OVERSAMPLING_FACTOR && !c->automate_os) p = 0;
+        seed = seed * 1664525u + 1013904223u;
+        const float t = (float)(seed >> 8) * (1.0f / 16777216.0f);
+        float value = PARAMETERS[p].min + t * (PARAMETERS[p].max - PARAMETERS[p].min);
+        if (PARAMETERS[p].integer) value = floorf(value + 0.5f);
+        // Uno su sei fuori intervallo, sotto il minimo o sopra il massimo della porta
+        const Gua76ParameterInfo* info = gua76_find_parameter(PARAMETERS[p].symbol);
+        float port_value = value;
+        if (n % 6 == 5) {
+            const float span = info->max - info->min;
+            value = (t < 0.5f) ? info->min - span * (1.0f + t) : info->max + span * t;
+            if (PARAMETERS[p].integer) value = floorf(value + 0.5f);
+            port_value = (value < info->min) ? info->min : info->max;
+        }
+        events[n].frame = frame;
+        events[n].parameter = p;
+        events[n].value = value;
+        events[n].port_value = port_value;
+        ++n;
+    }
+    return n;
+}
+
+static void init_controls(const EventCase* c, float* controls) {
+    host_default_controls(controls);
+    controls[GUA76_OVERSAMPLING_FACTOR] = (float)c->os_stages;
+    controls[GUA76_SIDECHAIN_LPF_ON] = 1.0f;
+    controls[GUA76_SIDECHAIN_LPF_FREQ] = 8000.0f;
+    controls[GUA76_DETECTOR_LINK] = (c->channels > 2) ? 1.0f : 0.0f;
+}
+
+static void connect_audio(const LV2_Descriptor* desc, LV2_Handle handle, int channels,
+                          float* const* in, float* const* out, uint32_t pos) {
+    for (int ch = 0; ch < channels; ++ch) {
+        desc->connect_port(handle, (uint32_t)ch, in[ch] + pos);
+        desc->connect_port(handle, (uint32_t)(channels + ch), out[ch] + pos);
+    }
+}
+
+// Elabora il corpus con l'automazione: come eventi (use_events) o spezzando i blocchi sulle porte.
+// Restituisce i secondi passati in run(), < 0 in caso di errore.
+static double render(const LV2_Descriptor* desc, const EventCase* c, bool use_events, uint32_t block,
+                     const ScheduledEvent* events, int num_events,
+                     float* const* in, float* const* out, uint32_t total) {
+    static HostFeatures host;
+    host_features_init(&host, block);
+    LV2_Handle handle = desc->instantiate(desc, EVENTTEST_SAMPLERATE, "", host.features);
+    if (!handle) return -1.0;
+
+    float controls[HOST_NUM_CONTROLS];
+    init_controls(c, controls);
+    static EventSequenceBuffer sequence;
+    host_connect_ports(desc, handle, c->channels, in, out, NULL, controls, NULL);
+    if (use_events) desc->connect_port(handle, GUA76_CONTROL_PORT_OFFSET(c->channels) + GUA76_CONTROL_EVENTS, &sequence);
+    desc->activate(handle);
+
+    LV2_Atom_Forge forge;
+    lv2_atom_forge_init(&forge, &host.map);
+    EventUrids urids;
+    urids.patch_set = host.map.map(host.map.handle, LV2_PATCH__Set);
+    urids.patch_property = host.map.map(host.map.handle, LV2_PATCH__property);
+    urids.patch_value = host.map.map(host.map.handle, LV2_PATCH__value);
+    for (int i = 0; i < NUM_PARAMETERS; ++i) {
+        char uri[128];
+        snprintf(uri, sizeof(uri), "%s#%s", GUA76_URI, PARAMETERS[i].symbol);
+        urids.parameter[i] = host.map.map(host.map.handle, uri);
+    }
+
+    double elapsed = 0.0;
+    int next = 0;
+    for (uint32_t pos = 0; pos < total; pos += block) {
+        const uint32_t n = (total - pos < block) ? total - pos : block;
+        if (use_events) {
+            // Tutti i cambi del blocco nella sequenza, un run() per blocco
+            lv2_atom_forge_set_buffer(&forge, (uint8_t*)&sequence, sizeof(sequence));
+            LV2_Atom_Forge_Frame seq_frame;
+            bool ok = lv2_atom_forge_sequence_head(&forge, &seq_frame, 0) != 0;
+            for (; next < num_events && events[next].frame < pos + n; ++next) {
+                const ScheduledEvent* e = &events[next];
+                const EventParameter* param = &PARAMETERS[e->parameter];
+                LV2_Atom_Forge_Frame object_frame;
+                ok = ok && lv2_atom_forge_frame_time(&forge, (int64_t)(e->frame - pos));
+                ok = ok && lv2_atom_forge_object(&forge, &object_frame, 0, urids.patch_set);
+                ok = ok && lv2_atom_forge_key(&forge, urids.patch_property);
+                ok = ok && lv2_atom_forge_urid(&forge, urids.parameter[e->parameter]);
+                ok = ok && lv2_atom_forge_key(&forge, urids.patch_value);
+                // Tipi alternati per coprire tutte le conversioni del plugin
+                if (param->integer) ok = ok && lv2_atom_forge_int(&forge, (int32_t)e->value);
+                else if (next % 2) ok = ok && lv2_atom_forge_double(&forge, (double)e->value);
+                else ok = ok && lv2_atom_forge_float(&forge, e->value);
+                if (ok) lv2_atom_forge_pop(&forge, &object_frame);
+            }
+            if (!ok) {
+                fprintf(stderr, "Sequenza degli eventi piena (blocco troppo lungo)\n");
+                desc->cleanup(handle);
+                return -1.0;
+            }
+            lv2_atom_forge_pop(&forge, &seq_frame);
+            connect_audio(desc, handle, c->channels, in, out, pos);
+            const double t0 = now_seconds();
+            desc->run(handle, n);
+            elapsed += now_seconds() - t0;
+        } else {
+            // Un run() per ogni tratto tra due cambi, con i valori sulle porte
+            uint32_t seg = pos;
+            while (seg < pos + n) {
+                for (; next < num_events && events[next].frame <= seg; ++next) {
+                    controls[PARAMETERS[events[next].parameter].port] = events[next].port_value;
+                }
+                uint32_t end = pos + n;
+                if (next < num_events && events[next].frame < end) end = events[next].frame;
+                connect_audio(desc, handle, c->channels, in, out, seg);
+                const double t0 = now_seconds();
+                desc->run(handle, end - seg);
+                elapsed += now_seconds() - t0;
+                seg = end;
+            }
+        }
+    }
+
+    desc->deactivate(handle);
+    desc->cleanup(handle);
+    return elapsed;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [--verbose] [--seconds S] [--block N] [--interval N]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    double seconds = EVENTTEST_DEFAULT_SECONDS;
+    uint32_t block = EVENTTEST_DEFAULT_BLOCK;
+    uint32_t interval = EVENTTEST_DEFAULT_INTERVAL;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--block") && i + 1 < argc) block = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--interval") && i + 1 < argc) interval = (uint32_t)atoi(argv[++i]);
+        else { usage(argv[0]); return 2; }
+    }
+    if (seconds <= 0.0) seconds = EVENTTEST_DEFAULT_SECONDS;
+    if (block == 0 || block > EVENTTEST_MAX_BLOCK) block = EVENTTEST_DEFAULT_BLOCK;
+    if (interval == 0) interval = EVENTTEST_DEFAULT_INTERVAL;
+
+    // Corpus: tutti i segnali di test in sequenza, su GUA76_MAX_CHANNELS canali
+    const uint32_t per_signal = (uint32_t)(EVENTTEST_SAMPLERATE * seconds);
+    const uint32_t total = per_signal * NUM_SIGNALS;
+    const int capacity = (int)(2 * (total / interval)) + 16;
+    ScheduledEvent* events = (ScheduledEvent*)malloc((size_t)capacity * sizeof(ScheduledEvent));
+    float* in[GUA76_MAX_CHANNELS];
+    float* port_out[GUA76_MAX_CHANNELS];
+    float* event_out[GUA76_MAX_CHANNELS];
+    for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) {
+        in[ch] = (float*)malloc(total * sizeof(float));
+        port_out[ch] = (float*)malloc(total * sizeof(float));
+        event_out[ch] = (float*)malloc(total * sizeof(float));
+        if (!in[ch] || !port_out[ch] || !event_out[ch] || !events) {
+            fprintf(stderr, "Memoria insufficiente\n");
+            return 2;
+        }
+    }
+    for (int s = 0; s < NUM_SIGNALS; ++s) {
+        float* segment[GUA76_MAX_CHANNELS];
+        for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) segment[ch] = in[ch] + s * per_signal;
+        host_generate_channels((HostSignal)s, EVENTTEST_SAMPLERATE, segment, GUA76_MAX_CHANNELS, per_signal);
+    }
+
+    static const EventCase cases[] = {
+        { 0, 2, 0, false }, { 0, 2, 2, false }, { 0, 2, 1, true },
+        { 1, 1, 0, false }, { 1, 1, 2, false },
+        { 2, 6, 0, false }, { 2, 6, 2, false },
+        { 3, 8, 1, true }
+    };
+    const int num_cases = (int)(sizeof(cases) / sizeof(cases[0]));
+    int failures = 0, total_events = 0;
+    double port_seconds = 0.0, event_seconds = 0.0, frames_processed = 0.0;
+    for (int i = 0; i < num_cases; ++i) {
+        const EventCase* c = &cases[i];
+        const LV2_Descriptor* desc = lv2_descriptor(c->variant);
+        if (!desc) {
+            fprintf(stderr, "Descrittore non disponibile\n");
+            return 2;
+        }
+        const int num_events = build_schedule(c, total, interval, events, capacity);
+        const double t_ports = render(desc, c, false, block, events, num_events, in, port_out, total);
+        const double t_events = render(desc, c, true, block, events, num_events, in, event_out, total);
+        if (t_ports < 0.0 || t_events < 0.0) {
+            fprintf(stderr, "Istanziazione fallita\n");
+            return 2;
+        }
+
+        double max_abs = 0.0;
+        uint32_t first_diff = total;
+        for (int ch = 0; ch < c->channels; ++ch) {
+            for (uint32_t s = 0; s < total; ++s) {
+                if (event_out[ch][s] == port_out[ch][s]) continue;
+                const double e = fabs((double)event_out[ch][s] - (double)port_out[ch][s]);
+                if (!(e <= max_abs)) max_abs = (e != e) ? INFINITY : e;
+                if (s < first_diff) first_diff = s;
+            }
+        }
+        const bool fail = (first_diff < total);
+        if (fail) ++failures;
+        total_events += num_events;
+        port_seconds += t_ports;
+        event_seconds += t_events;
+        frames_processed += (double)total * c->channels;
+
+        if (fail || verbose) {
+            printf("%s ch=%d os=%ux automate_os=%d events=%d  max_abs=%.3e", fail ? "FAIL" : "ok  ",
+                   c->channels, 1u << c->os_stages, c->automate_os ? 1 : 0, num_events, max_abs);
+            if (fail) printf("  primo frame diverso=%u", first_diff);
+            printf("  porte=%.1f ns/campione eventi=%.1f ns/campione\n",
+                   t_ports * 1e9 / ((double)total * c->channels), t_events * 1e9 / ((double)total * c->channels));
+        }
+    }
+
+    printf("%d combinazioni, %d eventi, %d con uscita diversa (blocco %u, un cambio ogni %u campioni in media)\n",
+           num_cases, total_events, failures, block, interval);
+    printf("Tempo: blocchi spezzati sulle porte %.1f ns/campione, eventi %.1f ns/campione\n",
+           port_seconds * 1e9 / frames_processed, event_seconds * 1e9 / frames_processed);
+
+    free(events);
+    for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) {
+        free(in[ch]); free(port_out[ch]); free(event_out[ch]);
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+// Host LV2 minimale condiviso dai tool da riga di comando (benchmark, null test):
+// urid:map, opzioni bufsz, collegamento delle porte e segnali di test sintetici e deterministici.
+#ifndef GUA76_HOST_H
+#define GUA76_HOST_H
+
+#include "gua76.h"
+#include <lv2/core/lv2.h>
+#include <lv2/atom/atom.h>
+#include <lv2/buf-size/buf-size.h>
+#include <lv2/options/options.h>
+#include <lv2/urid/urid.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_MAX_URIDS 64
+
+// --- urid:map minimale ---
+typedef struct {
+    char uris[HOST_MAX_URIDS][128];
+    int count;
+} HostUridMap;
+
+static inline LV2_URID host_map_uri(LV2_URID_Map_Handle handle, const char* uri) {
+    HostUridMap* m = (HostUridMap*)handle;
+    for (int i = 0; i < m->count; ++i) {
+        if (!strcmp(m->uris[i], uri)) return (LV2_URID)(i + 1);
+    }
+    if (m->count >= HOST_MAX_URIDS) return 0;
+    strncpy(m->uris[m->count], uri, sizeof(m->uris[0]) - 1);
+    return (LV2_URID)(++m->count);
+}
+
+// --- Feature passate a instantiate(): urid:map e bufsz:maxBlockLength ---
+// Contiene puntatori a se stessa: va inizializzata sul posto e non copiata.
+typedef struct {
+    HostUridMap uri_table;
+    LV2_URID_Map map;
+    int32_t block_length;
+    LV2_Options_Option options[2];
+    LV2_Feature map_feature;
+    LV2_Feature options_feature;
+    const LV2_Feature* features[3];
+} HostFeatures;
+
+static inline void host_features_init(HostFeatures* h, uint32_t max_block_length) {
+    memset(h, 0, sizeof(HostFeatures));
+    h->map.handle = &h->uri_table;
+    h->map.map = host_map_uri;
+    h->block_length = (int32_t)max_block_length;
+    h->options[0].context = LV2_OPTIONS_INSTANCE;
+    h->options[0].key = host_map_uri(&h->uri_table, LV2_BUF_SIZE__maxBlockLength);
+    h->options[0].size = sizeof(int32_t);
+    h->options[0].type = host_map_uri(&h->uri_table, LV2_ATOM__Int);
+    h->options[0].value = &h->block_length;
+    h->map_feature.URI = LV2_URID__map;
+    h->map_feature.data = &h->map;
+    h->options_feature.URI = LV2_OPTIONS__options;
+    h->options_feature.data = h->options;
+    h->features[0] = &h->map_feature;
+    h->features[1] = &h->options_feature;
+    h->features[2] = NULL;
+}
+
+// --- Porta notify: sequenza di uscita, da preparare prima di ogni run() ---
+#define HOST_NOTIFY_CAPACITY 65536
+typedef struct {
+    LV2_Atom_Sequence seq;
+    uint8_t events[HOST_NOTIFY_CAPACITY];
+} HostNotifyBuffer;
+
+static inline void host_notify_reset(HostFeatures* h, HostNotifyBuffer* b) {
+    b->seq.atom.size = HOST_NOTIFY_CAPACITY; // Spazio disponibile per il plugin
+    b->seq.atom.type = host_map_uri(&h->uri_table, LV2_ATOM__Chunk);
+}
+
+// --- Controlli e porte ---
+#define HOST_NUM_CONTROLS GUA76_NUM_STEREO_PORTS // Controlli per indice della variante stereo
+
+// Valori tipici dei controlli, comuni ai tool: ognuno cambia solo quelli che varia
+static inline void host_default_controls(float* controls) {
+    memset(controls, 0, HOST_NUM_CONTROLS * sizeof(float));
+    controls[GUA76_INPUT] = 0.75f;
+    controls[GUA76_OUTPUT] = 0.5f;
+    controls[GUA76_ATTACK] = 0.3f;
+    controls[GUA76_RELEASE] = 0.4f;
+    controls[GUA76_DRIVE_SATURATION] = 0.3f;
+    controls[GUA76_SIDECHAIN_HPF_FREQ] = 120.0f;
+    controls[GUA77_SIDECHAIN_HPF_Q] = 0.707f;
+    controls[GUA76_SIDECHAIN_LPF_FREQ] = 6000.0f;
+    controls[GUA76_KNEE] = 6.0f;
+}
+
+// Collega tutte le porte di una variante con 'channels' canali: audio per canale (sc NULL, o sc[c]
+// NULL, = sidechain interno), controlli da 'controls' (indici stereo), notify (o NULL).
+// La porta degli eventi dei parametri resta scollegata: chi la usa la collega dopo.
+static inline void host_connect_ports(const LV2_Descriptor* desc, LV2_Handle handle, int channels,
+                                      float* const* in, float* const* out, float* const* sc,
+                                      float* controls, void* notify) {
+    const uint32_t n = (uint32_t)channels;
+    for (uint32_t c = 0; c < n; ++c) {
+        desc->connect_port(handle, c, in[c]);
+        desc->connect_port(handle, n + c, out[c]);
+        desc->connect_port(handle, 2 * n + c, sc ? sc[c] : NULL);
+    }
+    const uint32_t offset = (uint32_t)GUA76_CONTROL_PORT_OFFSET(channels);
+    for (uint32_t index = GUA76_INPUT; index < (uint32_t)GUA76_NUM_STEREO_PORTS; ++index) {
+        void* location;
+        if (index == GUA76_NOTIFY) location = notify;
+        else if (index == GUA76_CONTROL_EVENTS) location = NULL;
+        else location = &controls[index];
+        desc->connect_port(handle, offset + index, location);
+    }
+}
+
+// --- Segnali di test ---
+typedef enum {
+    SIGNAL_SINE = 0,  // Seni a 1 kHz / 1.5 kHz, -6 dBFS
+    SIGNAL_NOISE,     // Rumore bianco, -12 dBFS RMS circa
+    SIGNAL_DRUMS,     // Cassa (seno che scende) + rullante (rumore) con inviluppi percussivi
+    SIGNAL_SWEEP,     // Sweep logaritmico 20 Hz - 20 kHz con ampiezza variabile
+    SIGNAL_SILENCE,   // Silenzio digitale (traccia ferma: sospensione del DSP)
+    NUM_SIGNALS
+} HostSignal;
+
+static inline const char* host_signal_name(HostSignal signal) {
+    static const char* const names[NUM_SIGNALS] = { "sine", "noise", "drums", "sweep", "silence" };
+    return (signal >= 0 && signal < NUM_SIGNALS) ? names[signal] : "unknown";
+}
+
+// Generatore pseudo-casuale deterministico (i risultati devono essere ripetibili)
+static inline float host_noise(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(*state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+static inline void host_generate_signal(HostSignal signal, double samplerate, float* l, float* r, uint32_t n) {
+    uint32_t seed = 12345u;
+    const uint32_t beat = (uint32_t)(samplerate * 0.25); // Un colpo ogni 250 ms
+    const double duration = (double)n / samplerate;
+    double sweep_phase = 0.0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const double t = (double)i / samplerate;
+        switch (signal) {
+            case SIGNAL_SINE:
+                l[i] = 0.5f * (float)sin(2.0 * M_PI * 1000.0 * t);
+                r[i] = 0.5f * (float)sin(2.0 * M_PI * 1500.0 * t);
+                break;
+            case SIGNAL_NOISE:
+                l[i] = 0.4f * host_noise(&seed);
+                r[i] = 0.4f * host_noise(&seed);
+                break;
+            case SIGNAL_DRUMS: {
+                const uint32_t pos = i % beat;
+                const double tb = (double)pos / samplerate;
+                const bool snare = ((i / beat) % 2) == 1;
+                float v;
+                if (snare) {
+                    v = 0.7f * (float)exp(-tb * 30.0) * host_noise(&seed);
+                } else {
+                    const double freq = 50.0 + 100.0 * exp(-tb * 40.0);
+                    v = 0.9f * (float)exp(-tb * 12.0) * (float)sin(2.0 * M_PI * freq * tb);
+                }
+                l[i] = v;
+                r[i] = 0.8f * v + 0.05f * host_noise(&seed);
+                break;
+            }
+            case SIGNAL_SWEEP: {
+                const double freq = 20.0 * pow(1000.0, t / duration);
+                sweep_phase += 2.0 * M_PI * freq / samplerate;
+                const float amp = 0.05f + 0.85f * (float)(0.5 - 0.5 * cos(2.0 * M_PI * 3.0 * t / duration));
+                l[i] = amp * (float)sin(sweep_phase);
+                r[i] = amp * (float)cos(sweep_phase);
+                break;
+            }
+            case SIGNAL_SILENCE:
+            default:
+                l[i] = r[i] = 0.0f;
+                break;
+        }
+    }
+}
+
+// Segnale di test su 'num_channels' canali planari: i canali 0/1 sono la coppia stereo,
+// gli altri copie ritardate e attenuate (così un detector linkato vede canali diversi).
+static inline bool host_generate_channels(HostSignal signal, double samplerate, float* const* ch, int num_channels, uint32_t n) {
+    float* r = (num_channels > 1) ? ch[1] : (float*)malloc(n * sizeof(float));
+    if (!r) return false;
+    host_generate_signal(signal, samplerate, ch[0], r, n);
+    for (int c = 2; c < num_channels; ++c) {
+        const float* src = ch[c % 2];
+        const uint32_t delay = (uint32_t)(7 * c);
+        const float gain = 1.0f - 0.1f * (float)c;
+        for (uint32_t i = 0; i < n; ++i) ch[c][i] = (i >= delay) ? gain * src[i - delay] : 0.0f;
+    }
+    if (num_channels == 1) free(r);
+    return true;
+}
+
+#endif // GUA76_HOST_H
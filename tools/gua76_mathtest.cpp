@@ -0,0 +1,178 @@
+// Gua76 Math Test
+// Verifica le approssimazioni di gua76_fastmath.h su tutto il dominio documentato: per ogni
+// funzione si percorrono i float del dominio (tutti i pattern di bit con --full, altrimenti uno
+// ogni --stride) e si confronta con libm in double. L'errore (relativo, o assoluto dove il
+// risultato passa per zero) deve restare entro il limite documentato nell'header:
+//   errore <= base + pendenza * |x|
+// Con SSE2 verifica anche che le versioni su 4 corsie diano gli stessi bit delle scalari.
+// Esce con codice 1 se un limite non è rispettato (`make mathtest`, incluso in `make check`).
+//
+// Uso:
+//   gua76_mathtest [--full] [--stride N]
+
+#include "gua76_fastmath.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MATHTEST_DEFAULT_STRIDE 61 // Primo: copre tutti i residui della mantissa tra i binade
+
+#if !GUA76_FAST_MATH
+#error "gua76_mathtest verifica le approssimazioni: compilare con GUA76_FAST_MATH=1"
+#endif
+
+typedef enum {
+    ERROR_RELATIVE = 0,
+    ERROR_ABSOLUTE_NEAR_ONE // Assoluto per x in [0.5, 2) (dove il risultato passa per zero), altrove relativo
+} ErrorKind;
+
+// Una funzione da verificare, con il riferimento e il limite documentato
+typedef struct {
+    const char* name;
+    float (*fast)(float);
+    double (*exact)(double);
+    float lo, hi;       // Dominio (estremi inclusi)
+    ErrorKind kind;
+    double base;        // Limite: base + slope * |x| (relativo), base_abs per x in [0.5, 2)
+    double slope;
+    double base_abs;
+} MathCase;
+
+static double exact_exp2(double x) { return exp2(x); }
+static double exact_log2(double x) { return log2(x); }
+static double exact_exp(double x) { return exp(x); }
+static double exact_pow10(double x) { return pow(10.0, x); }
+static double exact_db_to_gain(double db) { return pow(10.0, db / 20.0); }
+static double exact_gain_to_db(double g) { return 20.0 * log10(g); }
+
+static const float FLOAT_MIN_NORMAL = 1.17549435e-38f;
+static const float FLOAT_MAX = 3.40282347e+38f;
+
+static const MathCase CASES[] = {
+    { "exp2",        fast_exp2,       exact_exp2,       -126.0f,          127.0f,    ERROR_RELATIVE,          2.5e-7, 0.0,    0.0 },
+    { "log2",        fast_log2,       exact_log2,       FLOAT_MIN_NORMAL, FLOAT_MAX, ERROR_ABSOLUTE_NEAR_ONE, 1.5e-7, 0.0,    2.0e-7 },
+    { "exp",         fast_exp,        exact_exp,        -87.0f,           88.0f,     ERROR_RELATIVE,          3.0e-7, 8.0e-8, 0.0 },
+    { "pow10",       fast_pow10,      exact_pow10,      -37.0f,           38.0f,     ERROR_RELATIVE,          3.0e-7, 2.5e-7, 0.0 },
+    { "db_to_gain",  fast_db_to_gain, exact_db_to_gain, -758.0f,          764.0f,    ERROR_RELATIVE,          3.0e-7, 1.0e-8, 0.0 },
+    { "gain_to_db",  fast_gain_to_db, exact_gain_to_db, FLOAT_MIN_NORMAL, FLOAT_MAX, ERROR_ABSOLUTE_NEAR_ONE, 2.0e-7, 0.0,    1.5e-6 },
+};
+#define NUM_CASES (int)(sizeof(CASES) / sizeof(CASES[0]))
+
+static uint32_t float_bits(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+static float bits_float(uint32_t bits) {
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Risultato della verifica di una funzione
+typedef struct {
+    uint64_t count;
+    double worst_ratio; // Errore / limite (<= 1 per passare)
+    double worst_error;
+    float worst_x;
+} MathResult;
+
+static void check_value(const MathCase* c, float x, MathResult* r) {
+    const double got = (double)c->fast(x);
+    const double want = c->exact((double)x);
+    double error, limit;
+    if (c->kind == ERROR_ABSOLUTE_NEAR_ONE && x >= 0.5f && x < 2.0f) {
+        error = fabs(got - want);
+        limit = c->base_abs;
+    } else {
+        error = fabs(got - want) / fabs(want);
+        limit = c->base + c->slope * fabs((double)x);
+    }
+    const double ratio = error / limit;
+    if (!(ratio <= r->worst_ratio)) { // Anche NaN
+        r->worst_ratio = ratio;
+        r->worst_error = error;
+        r->worst_x = x;
+    }
+    r->count++;
+}
+
+// Percorre i float di [lo, hi] in ordine di pattern di bit (negativi e positivi separatamente)
+static void sweep(const MathCase* c, uint32_t stride, MathResult* r) {
+    if (c->lo < 0.0f) {
+        const uint32_t end = float_bits(-c->lo); // |x| da 0 a -lo
+        for (uint32_t b = 0; b <= end; b += stride) {
+            check_value(c, -bits_float(b), r);
+            if (end - b < stride) break;
+        }
+        check_value(c, c->lo, r);
+    }
+    const uint32_t begin = (c->lo > 0.0f) ? float_bits(c->lo) : 0u;
+    const uint32_t end = float_bits(c->hi);
+    for (uint32_t b = begin; b <= end; b += stride) {
+        check_value(c, bits_float(b), r);
+        if (end - b < stride) break;
+    }
+    check_value(c, c->hi, r);
+}
+
+#ifdef GUA76_FASTMATH_SSE2
+// Le versioni su 4 corsie devono dare gli stessi bit delle scalari
+static uint64_t simd_mismatches(float (*fast)(float), __m128 (*fast_ps)(__m128), float lo, float hi, uint32_t count) {
+    uint64_t mismatches = 0;
+    for (uint32_t i = 0; i < count; i += 4) {
+        float x[4], y[4];
+        for (int k = 0; k < 4; ++k) {
+            const double t = (double)(i + k) / count;
+            x[k] = (lo > 0.0f) ? (float)(lo * pow((double)hi / lo, t)) : (float)(lo + (hi - lo) * t);
+        }
+        _mm_storeu_ps(y, fast_ps(_mm_loadu_ps(x)));
+        for (int k = 0; k < 4; ++k) {
+            if (float_bits(y[k]) != float_bits(fast(x[k]))) ++mismatches;
+        }
+    }
+    return mismatches;
+}
+#endif
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [--full] [--stride N]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    uint32_t stride = MATHTEST_DEFAULT_STRIDE;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--full")) stride = 1;
+        else if (!strcmp(argv[i], "--stride") && i + 1 < argc) stride = (uint32_t)atoi(argv[++i]);
+        else { usage(argv[0]); return 2; }
+    }
+    if (stride == 0) stride = 1;
+
+    int failures = 0;
+    for (int i = 0; i < NUM_CASES; ++i) {
+        const MathCase* c = &CASES[i];
+        MathResult r;
+        memset(&r, 0, sizeof(r));
+        sweep(c, stride, &r);
+        const bool fail = !(r.worst_ratio <= 1.0);
+        if (fail) ++failures;
+        printf("%s %-11s %11llu valori  errore max %.3e (%.0f%% del limite) a x = %.9g\n",
+               fail ? "FAIL" : "ok  ", c->name, (unsigned long long)r.count, r.worst_error,
+               100.0 * r.worst_ratio, (double)r.worst_x);
+    }
+
+#ifdef GUA76_FASTMATH_SSE2
+    const uint64_t exp2_mismatches = simd_mismatches(fast_exp2, fast_exp2_ps, -130.0f, 130.0f, 1u << 22);
+    const uint64_t log2_mismatches = simd_mismatches(fast_log2, fast_log2_ps, FLOAT_MIN_NORMAL, FLOAT_MAX, 1u << 22);
+    printf("%s SSE2 exp2/log2: %llu/%llu valori diversi dalla versione scalare\n",
+           (exp2_mismatches || log2_mismatches) ? "FAIL" : "ok  ",
+           (unsigned long long)exp2_mismatches, (unsigned long long)log2_mismatches);
+    if (exp2_mismatches || log2_mismatches) ++failures;
+#endif
+
+    printf("%d funzioni fuori limite (passo %u)\n", failures, stride);
+    return failures > 0 ? 1 : 0;
+}
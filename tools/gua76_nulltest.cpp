@@ -0,0 +1,245 @@
+// Gua76 Null Test
+// Confronta la build ottimizzata (lv2_descriptor, da gua76.o) con la build di riferimento
+// (gua76_reference_descriptor, da gua76.cpp compilato con -DGUA76_REFERENCE_BUILD: percorso
+// scalare e matematica esatta). Un corpus fisso di segnali generati viene elaborato da entrambe
+// per ogni combinazione di ratio, Mid-Side, link, pad, filtri sidechain e oversampling della
+// variante stereo, e per un sottoinsieme (link del detector, oversampling, filtri, lookahead)
+// delle varianti mono, 5.1 e 7.1, più le modalità di saturazione ADAA in stereo.
+// Le due build vengono dallo stesso sorgente: il test verifica le ottimizzazioni, non che il
+// suono resti quello originale (per quello c'è tools/gua76_baselinetest.cpp).
+//
+// Per ogni combinazione vengono riportati errore assoluto massimo, errore RMS (dBFS) e
+// profondità del null (errore RMS rispetto al segnale di riferimento, dB). Se una
+// combinazione supera le soglie il programma esce con codice 1 (e `make nulltest` fallisce).
+//
+// Uso:
+//   gua76_nulltest [--verbose] [--seconds S] [--max-abs X] [--min-null-depth DB]
+
+#include "gua76.h"
+#include "gua76_host.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NULLTEST_SAMPLERATE 48000.0
+#define NULLTEST_BLOCK 512
+#define NULLTEST_DEFAULT_SECONDS 0.25 // Per segnale del corpus
+#define NULLTEST_DEFAULT_MAX_ABS 1e-3
+#define NULLTEST_DEFAULT_MIN_NULL_DEPTH_DB 80.0 // L'errore deve stare almeno 80 dB sotto il segnale
+
+extern "C" const LV2_Descriptor* gua76_reference_descriptor(uint32_t index);
+
+// Una combinazione di controlli da verificare
+typedef struct {
+    uint32_t variant;  // Indice del descrittore (0 = stereo, 1 = mono, 2 = 5.1, 3 = 7.1)
+    int channels;
+    int detector_link; // 0 = indipendente, 1 = massimo, 2 = somma
+    int ratio;       // 0..4 (4 = All-Button)
+    int midside;     // 0 = off, 1 = M/S indipendente, 2 = M/S linkato
+    bool pad;
+    bool sidechain_filters;
+    int os_stages;   // 0 = 1x ... 4 = 16x
+    float lookahead_ms;
+    int saturation_mode; // 0 = curva semplice, 1/2 = ADAA di ordine 1/2
+} NullCase;
+
+typedef struct {
+    double max_abs;
+    double rms_error_db;
+    double null_depth_db;
+} NullResult;
+
+static double to_db_floor(double v) {
+    return (v > 1e-15) ? 20.0 * log10(v) : -300.0;
+}
+
+// Elabora il corpus (un buffer per canale) con un descrittore e scrive le uscite
+static bool render(const LV2_Descriptor* desc, const NullCase* c, float* const* in, float* const* out, uint32_t total) {
+    static HostFeatures host;
+    host_features_init(&host, NULLTEST_BLOCK);
+    LV2_Handle handle = desc->instantiate(desc, NULLTEST_SAMPLERATE, "", host.features);
+    if (!handle) return false;
+
+    float controls[HOST_NUM_CONTROLS];
+    host_default_controls(controls);
+    controls[GUA76_RATIO] = (float)c->ratio;
+    controls[GUA76_OVERSAMPLING_FACTOR] = (float)c->os_stages;
+    controls[GUA76_SIDECHAIN_HPF_ON] = c->sidechain_filters ? 1.0f : 0.0f;
+    controls[GUA76_SIDECHAIN_LPF_ON] = c->sidechain_filters ? 1.0f : 0.0f;
+    controls[GUA76_MIDSIDE_MODE] = (c->midside > 0) ? 1.0f : 0.0f;
+    controls[GUA76_MIDSIDE_LINK] = (c->midside == 2) ? 1.0f : 0.0f;
+    controls[GUA76_PAD_10DB] = c->pad ? 1.0f : 0.0f;
+    controls[GUA76_DETECTOR_LINK] = (float)c->detector_link;
+    controls[GUA76_LOOKAHEAD] = c->lookahead_ms;
+    controls[GUA76_SATURATION_MODE] = (float)c->saturation_mode;
+
+    // Sidechain interno; telemetria non confrontata
+    const uint32_t channels = (uint32_t)c->channels;
+    float block_in[GUA76_MAX_CHANNELS][NULLTEST_BLOCK];
+    float block_out[GUA76_MAX_CHANNELS][NULLTEST_BLOCK];
+    float* in_ptr[GUA76_MAX_CHANNELS];
+    float* out_ptr[GUA76_MAX_CHANNELS];
+    for (uint32_t ch = 0; ch < channels; ++ch) {
+        in_ptr[ch] = block_in[ch];
+        out_ptr[ch] = block_out[ch];
+    }
+    host_connect_ports(desc, handle, c->channels, in_ptr, out_ptr, NULL, controls, NULL);
+    desc->activate(handle);
+
+    for (uint32_t pos = 0; pos < total; pos += NULLTEST_BLOCK) {
+        const uint32_t n = (total - pos < NULLTEST_BLOCK) ? total - pos : NULLTEST_BLOCK;
+        for (uint32_t ch = 0; ch < channels; ++ch) memcpy(block_in[ch], in[ch] + pos, n * sizeof(float));
+        desc->run(handle, n);
+        for (uint32_t ch = 0; ch < channels; ++ch) memcpy(out[ch] + pos, block_out[ch], n * sizeof(float));
+    }
+
+    desc->deactivate(handle);
+    desc->cleanup(handle);
+    return true;
+}
+
+static void compare(float* const* ref, float* const* opt, int channels, uint32_t total, NullResult* r) {
+    double max_abs = 0.0, err_sq = 0.0, ref_sq = 0.0;
+    for (int ch = 0; ch < channels; ++ch) {
+        for (uint32_t i = 0; i < total; ++i) {
+            const double e = (double)opt[ch][i] - (double)ref[ch][i];
+            const double ae = fabs(e);
+            // Un NaN nell'uscita ottimizzata deve far fallire il test, non sparire nel massimo
+            if (ae > max_abs || ae != ae) max_abs = (ae != ae) ? INFINITY : ae;
+            err_sq += e * e;
+            ref_sq += (double)ref[ch][i] * ref[ch][i];
+        }
+    }
+    const double err_rms = sqrt(err_sq / ((double)channels * total));
+    const double ref_rms = sqrt(ref_sq / ((double)channels * total));
+    r->max_abs = max_abs;
+    r->rms_error_db = to_db_floor(err_rms);
+    r->null_depth_db = (ref_rms > 0.0) ? to_db_floor(err_rms) - to_db_floor(ref_rms) : r->rms_error_db;
+}
+
+// Combinazioni: tutte quelle della variante stereo, un sottoinsieme per le altre varianti
+static int build_cases(NullCase* cases) {
+    static const int VARIANT_CHANNELS[] = { 2, 1, 6, 8 };
+    int n = 0;
+    for (int os = 0; os <= 4; ++os)
+    for (int ratio = 0; ratio < 5; ++ratio)
+    for (int ms = 0; ms < 3; ++ms)
+    for (int pad = 0; pad < 2; ++pad)
+    for (int scf = 0; scf < 2; ++scf) {
+        NullCase c = { 0, 2, 0, ratio, ms, pad != 0, scf != 0, os, 0.0f, 0 };
+        cases[n++] = c;
+    }
+    for (uint32_t v = 0; v < 4; ++v)
+    for (int link = 0; link < 3; ++link)
+    for (int os = 0; os <= 3; os += 3)
+    for (int ratio = 0; ratio < 5; ratio += 4)
+    for (int scf = 0; scf < 2; ++scf) {
+        if (v == 0 && link == 0) continue; // Già coperte sopra
+        NullCase c = { v, VARIANT_CHANNELS[v], link, ratio, 0, false, scf != 0, os, 0.0f, 0 };
+        cases[n++] = c;
+    }
+    // Lookahead: la build di riferimento calcola il massimo della finestra con una ricerca lineare
+    for (uint32_t v = 0; v < 4; v += 3)
+    for (int la = 1; la <= 5; la += 4)
+    for (int os = 0; os <= 3; os += 3)
+    for (int ms = 0; ms < 3; ms += 2) {
+        if (v != 0 && ms != 0) continue; // Mid-Side solo in stereo
+        if (la > 1 && os > 0) continue; // Finestra di migliaia di campioni: troppo lenta per il riferimento
+        NullCase c = { v, VARIANT_CHANNELS[v], v == 0 ? 0 : 1, 0, ms, false, true, os, (float)la, 0 };
+        cases[n++] = c;
+    }
+    // Saturazione ADAA (stesso codice in double nelle due build: verifica il percorso che la circonda)
+    for (int sat = 1; sat < 3; ++sat)
+    for (int os = 0; os <= 3; os += 3)
+    for (int ratio = 0; ratio < 5; ratio += 4)
+    for (int ms = 0; ms < 3; ms += 2) {
+        NullCase c = { 0, 2, 0, ratio, ms, false, true, os, 0.0f, sat };
+        cases[n++] = c;
+    }
+    return n;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [--verbose] [--seconds S] [--max-abs X] [--min-null-depth DB]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    double seconds = NULLTEST_DEFAULT_SECONDS;
+    double max_abs_limit = NULLTEST_DEFAULT_MAX_ABS;
+    double min_null_depth = NULLTEST_DEFAULT_MIN_NULL_DEPTH_DB;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--max-abs") && i + 1 < argc) max_abs_limit = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--min-null-depth") && i + 1 < argc) min_null_depth = atof(argv[++i]);
+        else { usage(argv[0]); return 2; }
+    }
+    if (seconds <= 0.0) seconds = NULLTEST_DEFAULT_SECONDS;
+
+    // Corpus: tutti i segnali di test in sequenza, su GUA76_MAX_CHANNELS canali
+    const uint32_t per_signal = (uint32_t)(NULLTEST_SAMPLERATE * seconds);
+    const uint32_t total = per_signal * NUM_SIGNALS;
+    float* in[GUA76_MAX_CHANNELS];
+    float* ref_out[GUA76_MAX_CHANNELS];
+    float* opt_out[GUA76_MAX_CHANNELS];
+    for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) {
+        in[ch] = (float*)malloc(total * sizeof(float));
+        ref_out[ch] = (float*)malloc(total * sizeof(float));
+        opt_out[ch] = (float*)malloc(total * sizeof(float));
+        if (!in[ch] || !ref_out[ch] || !opt_out[ch]) {
+            fprintf(stderr, "Memoria insufficiente\n");
+            return 2;
+        }
+    }
+    for (int s = 0; s < NUM_SIGNALS; ++s) {
+        float* segment[GUA76_MAX_CHANNELS];
+        for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) segment[ch] = in[ch] + s * per_signal;
+        host_generate_channels((HostSignal)s, NULLTEST_SAMPLERATE, segment, GUA76_MAX_CHANNELS, per_signal);
+    }
+
+    static NullCase cases[512];
+    const int num_cases = build_cases(cases);
+    int failures = 0;
+    NullResult worst = { 0.0, -300.0, -300.0 };
+    for (int i = 0; i < num_cases; ++i) {
+        const NullCase* c = &cases[i];
+        const LV2_Descriptor* opt = lv2_descriptor(c->variant);
+        const LV2_Descriptor* ref = gua76_reference_descriptor(c->variant);
+        if (!opt || !ref) {
+            fprintf(stderr, "Descrittori non disponibili\n");
+            return 2;
+        }
+        if (!render(ref, c, in, ref_out, total) || !render(opt, c, in, opt_out, total)) {
+            fprintf(stderr, "Istanziazione fallita\n");
+            return 2;
+        }
+        NullResult r;
+        compare(ref_out, opt_out, c->channels, total, &r);
+
+        const bool fail = !(r.max_abs <= max_abs_limit) || !(r.null_depth_db <= -min_null_depth);
+        if (fail) ++failures;
+        if (r.max_abs > worst.max_abs) worst.max_abs = r.max_abs;
+        if (r.rms_error_db > worst.rms_error_db) worst.rms_error_db = r.rms_error_db;
+        if (r.null_depth_db > worst.null_depth_db) worst.null_depth_db = r.null_depth_db;
+
+        if (fail || verbose) {
+            printf("%s ch=%d link=%d la=%.0f os=%2ux ratio=%d ms=%s pad=%d scf=%d sat=%d  max_abs=%.3e  rms_err=%7.1f dB  null=%7.1f dB\n",
+                   fail ? "FAIL" : "ok  ", c->channels, c->detector_link, c->lookahead_ms, 1u << c->os_stages, c->ratio,
+                   c->midside == 0 ? "off   " : (c->midside == 1 ? "on    " : "linked"),
+                   c->pad ? 1 : 0, c->sidechain_filters ? 1 : 0, c->saturation_mode, r.max_abs, r.rms_error_db, r.null_depth_db);
+        }
+    }
+
+    printf("%d combinazioni, %d fuori soglia (max_abs <= %.1e, null <= -%.0f dB)\n",
+           num_cases, failures, max_abs_limit, min_null_depth);
+    printf("Peggiori: max_abs=%.3e  rms_err=%.1f dB  null=%.1f dB\n",
+           worst.max_abs, worst.rms_error_db, worst.null_depth_db);
+
+    for (int ch = 0; ch < GUA76_MAX_CHANNELS; ++ch) {
+        free(in[ch]); free(ref_out[ch]); free(opt_out[ch]);
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,753 @@
+// Gua76 Render
+// Renderer offline da riga di comando: elabora file WAV con lo stesso DSP del plugin (linkato
+// direttamente con gua76.o, come gli altri tool), senza host né server audio. I file vengono
+// distribuiti su una coda di lavoro tra N worker (uno per core di default), ognuno con il proprio
+// motore (un'istanza del plugin, riattivata tra un file e l'altro e ricreata solo se cambiano
+// frequenza o numero di canali). L'I/O è in streaming a blocchi: la memoria non dipende dalla
+// durata dei file.
+//
+// WAV in ingresso: PCM 16/24/32 bit e float 32/64 bit (anche WAVE_FORMAT_EXTENSIBLE), 1, 2, 6 o 8
+// canali (le varianti mono, stereo, 5.1 e 7.1). In uscita lo stesso formato (o --format), senza
+// dither; i campioni PCM oltre il fondo scala vengono limitati. La latenza riportata dal plugin
+// (lookahead e ritardo dell'ADAA) viene compensata: l'uscita è allineata all'ingresso e lunga uguale.
+//
+// I controlli partono dai default del plugin per i canali del file (gua76_parameter_info, come
+// gua76.ttl e gua76_variants.ttl) e si impostano per simbolo con --set o con un preset (righe
+// "simbolo = valore", commenti con #). Alla fine viene riportata la velocità in multipli del tempo
+// reale, per file e complessiva. Prima di iniziare vengono rifiutati i file di uscita che
+// coincidono con un ingresso o con l'uscita di un altro file (es. --out-dir nella cartella dei
+// sorgenti, o ingressi con lo stesso nome in cartelle diverse).
+//
+// Uso:
+//   gua76_render [opzioni] FILE.wav...
+//     -o FILE           File di uscita (con un solo file in ingresso)
+//     --out-dir DIR     Cartella di uscita (stesso nome del file in ingresso)
+//     --suffix S        Suffisso del nome di uscita senza -o/--out-dir (default "_gua76")
+//     --format F        same, pcm16, pcm24, pcm32, float32, float64 (default same)
+//     --preset FILE     Valori dei controlli da file
+//     --set SIMBOLO=V   Valore di un controllo (ripetibile, dopo il preset)
+//     --jobs N          Worker in parallelo (default: core disponibili)
+//     --block N         Frame per run() (default 1024)
+//     --list            Elenca i controlli con default e intervallo
+//     --quiet           Solo il riepilogo finale
+
+#include "gua76.h"
+#include "gua76_engine.h"
+#include "gua76_host.h"
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RENDER_DEFAULT_BLOCK 1024
+#define RENDER_MAX_BLOCK 8192
+#define RENDER_MAX_JOBS 256
+#define RENDER_DEFAULT_SUFFIX "_gua76"
+#define RENDER_NUM_CONTROLS GUA76_NUM_STEREO_PORTS // Indici della variante stereo
+
+// "simbolo=valore" (o "simbolo = valore" da preset): false con messaggio se non valido
+static bool apply_setting(float* controls, const char* text, const char* origin) {
+    char symbol[64];
+    const char* eq = strchr(text, '=');
+    if (!eq) {
+        fprintf(stderr, "%s: atteso simbolo=valore: %s\n", origin, text);
+        return false;
+    }
+    const char* start = text;
+    while (*start == ' ' || *start == '\t') ++start;
+    size_t len = (size_t)(eq - start);
+    while (len > 0 && (start[len - 1] == ' ' || start[len - 1] == '\t')) --len;
+    if (len == 0 || len >= sizeof(symbol)) {
+        fprintf(stderr, "%s: simbolo non valido: %s\n", origin, text);
+        return false;
+    }
+    memcpy(symbol, start, len);
+    symbol[len] = '\0';
+    const Gua76ParameterInfo* c = gua76_find_parameter(symbol);
+    if (!c) {
+        fprintf(stderr, "%s: controllo sconosciuto '%s' (--list per l'elenco)\n", origin, symbol);
+        return false;
+    }
+    char* end;
+    const float value = strtof(eq + 1, &end);
+    while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n') ++end;
+    if (end == eq + 1 || *end != '\0') {
+        fprintf(stderr, "%s: valore non numerico per '%s': %s\n", origin, symbol, eq + 1);
+        return false;
+    }
+    if (!(value >= c->min && value <= c->max)) {
+        fprintf(stderr, "%s: '%s' fuori intervallo [%g, %g]: %g\n", origin, symbol, c->min, c->max, value);
+        return false;
+    }
+    controls[c->port] = value;
+    return true;
+}
+
+static bool load_preset(float* controls, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Preset non leggibile: %s\n", path);
+        return false;
+    }
+    char line[256];
+    int line_number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        ++line_number;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        const char* p = line;
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+        if (*p == '\0') continue;
+        char origin[300];
+        snprintf(origin, sizeof(origin), "%s:%d", path, line_number);
+        ok = apply_setting(controls, line, origin);
+    }
+    fclose(f);
+    return ok;
+}
+
+// --- WAV: lettura e scrittura in streaming (little-endian, formato IEEE per i float) ---
+typedef enum {
+    SAMPLE_SAME = 0, // Solo per --format: come l'ingresso
+    SAMPLE_PCM16,
+    SAMPLE_PCM24,
+    SAMPLE_PCM32,
+    SAMPLE_FLOAT32,
+    SAMPLE_FLOAT64
+} SampleFormat;
+
+static const char* const SAMPLE_FORMAT_NAMES[] = { "same", "pcm16", "pcm24", "pcm32", "float32", "float64" };
+#define NUM_SAMPLE_FORMATS ((int)(sizeof(SAMPLE_FORMAT_NAMES) / sizeof(SAMPLE_FORMAT_NAMES[0])))
+
+static int sample_bytes(SampleFormat format) {
+    switch (format) {
+        case SAMPLE_PCM16: return 2;
+        case SAMPLE_PCM24: return 3;
+        case SAMPLE_PCM32: case SAMPLE_FLOAT32: return 4;
+        case SAMPLE_FLOAT64: return 8;
+        default: return 0;
+    }
+}
+
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_FLOAT 3
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+static uint16_t read_u16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t read_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static void write_u16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void write_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+typedef struct {
+    FILE* f;
+    int channels;
+    uint32_t samplerate;
+    SampleFormat format;
+    uint64_t frames;      // Frame nel chunk data
+    uint64_t frames_left;
+} WavReader;
+
+// Apre un WAV e si posiziona all'inizio dei campioni; messaggio in 'error' se fallisce
+static bool wav_open_read(WavReader* r, const char* path, char* error, size_t error_size) {
+    memset(r, 0, sizeof(WavReader));
+    r->f = fopen(path, "rb");
+    if (!r->f) {
+        snprintf(error, error_size, "file non leggibile");
+        return false;
+    }
+    uint8_t header[12];
+    if (fread(header, 1, 12, r->f) != 12 || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4)) {
+        snprintf(error, error_size, "non è un file RIFF/WAVE");
+        return false;
+    }
+    bool have_fmt = false;
+    int bits = 0, tag = 0;
+    for (;;) {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, 8, r->f) != 8) {
+            snprintf(error, error_size, "chunk data mancante");
+            return false;
+        }
+        const uint32_t size = read_u32(chunk + 4);
+        if (!memcmp(chunk, "fmt ", 4)) {
+            uint8_t fmt[40];
+            if (size < 16 || fread(fmt, 1, size < 40 ? size : 40, r->f) != (size < 40 ? size : 40)) {
+                snprintf(error, error_size, "chunk fmt non valido");
+                return false;
+            }
+            tag = read_u16(fmt);
+            r->channels = read_u16(fmt + 2);
+            r->samplerate = read_u32(fmt + 4);
+            bits = read_u16(fmt + 14);
+            if (tag == WAV_FORMAT_EXTENSIBLE && size >= 26) tag = read_u16(fmt + 24); // Sottoformato (GUID)
+            if (size > 40) fseek(r->f, (long)(size - 40), SEEK_CUR);
+            if (size & 1) fseek(r->f, 1, SEEK_CUR);
+            have_fmt = true;
+        } else if (!memcmp(chunk, "data", 4)) {
+            if (!have_fmt) {
+                snprintf(error, error_size, "chunk data prima di fmt");
+                return false;
+            }
+            break;
+        } else {
+            fseek(r->f, (long)size + (long)(size & 1), SEEK_CUR);
+        }
+    }
+    if (tag == WAV_FORMAT_PCM && bits == 16) r->format = SAMPLE_PCM16;
+    else if (tag == WAV_FORMAT_PCM && bits == 24) r->format = SAMPLE_PCM24;
+    else if (tag == WAV_FORMAT_PCM && bits == 32) r->format = SAMPLE_PCM32;
+    else if (tag == WAV_FORMAT_FLOAT && bits == 32) r->format = SAMPLE_FLOAT32;
+    else if (tag == WAV_FORMAT_FLOAT && bits == 64) r->format = SAMPLE_FLOAT64;
+    else {
+        snprintf(error, error_size, "formato non supportato (tag %d, %d bit)", tag, bits);
+        return false;
+    }
+    if (r->channels <= 0 || r->samplerate == 0) {
+        snprintf(error, error_size, "canali o frequenza non validi");
+        return false;
+    }
+    // La dimensione del chunk data è appena stata letta: si rilegge dai 4 byte precedenti
+    fseek(r->f, -4, SEEK_CUR);
+    uint8_t size_bytes[4];
+    if (fread(size_bytes, 1, 4, r->f) != 4) {
+        snprintf(error, error_size, "chunk data non valido");
+        return false;
+    }
+    r->frames = read_u32(size_bytes) / ((uint64_t)r->channels * sample_bytes(r->format));
+    r->frames_left = r->frames;
+    return true;
+}
+
+// Legge fino a 'n' frame in buffer planari, restituisce i frame letti
+static uint32_t wav_read(WavReader* r, float* const* planar, uint32_t n, uint8_t* scratch) {
+    if ((uint64_t)n > r->frames_left) n = (uint32_t)r->frames_left;
+    const int bytes = sample_bytes(r->format);
+    const size_t frame_bytes = (size_t)r->channels * bytes;
+    n = (uint32_t)fread(scratch, frame_bytes, n, r->f);
+    r->frames_left -= n;
+    const uint8_t* p = scratch;
+    for (uint32_t i = 0; i < n; ++i) {
+        for (int c = 0; c < r->channels; ++c, p += bytes) {
+            float v;
+            switch (r->format) {
+                case SAMPLE_PCM16: v = (float)(int16_t)read_u16(p) * (1.0f / 32768.0f); break;
+                case SAMPLE_PCM24: {
+                    const int32_t s = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+                    v = (float)s * (1.0f / 8388608.0f);
+                    break;
+                }
+                case SAMPLE_PCM32: v = (float)((double)(int32_t)read_u32(p) * (1.0 / 2147483648.0)); break;
+                case SAMPLE_FLOAT32: memcpy(&v, p, 4); break;
+                default: { double d; memcpy(&d, p, 8); v = (float)d; break; }
+            }
+            planar[c][i] = v;
+        }
+    }
+    return n;
+}
+
+typedef struct {
+    FILE* f;
+    int channels;
+    SampleFormat format;
+    uint64_t data_bytes;
+} WavWriter;
+
+// Intestazione (con le dimensioni da completare in wav_close_write). Oltre 2 canali si usa
+// WAVE_FORMAT_EXTENSIBLE con la maschera dei canali di 5.1 e 7.1.
+static bool wav_write_header(WavWriter* w, uint32_t samplerate) {
+    const int bytes = sample_bytes(w->format);
+    const bool is_float = (w->format == SAMPLE_FLOAT32 || w->format == SAMPLE_FLOAT64);
+    const bool extensible = (w->channels > 2);
+    uint8_t h[68];
+    memset(h, 0, sizeof(h));
+    const uint32_t fmt_size = extensible ? 40 : 16;
+    memcpy(h, "RIFF", 4);
+    memcpy(h + 8, "WAVE", 4);
+    memcpy(h + 12, "fmt ", 4);
+    write_u32(h + 16, fmt_size);
+    uint8_t* fmt = h + 20;
+    const uint16_t tag = is_float ? WAV_FORMAT_FLOAT : WAV_FORMAT_PCM;
+    write_u16(fmt, extensible ? WAV_FORMAT_EXTENSIBLE : tag);
+    write_u16(fmt + 2, (uint16_t)w->channels);
+    write_u32(fmt + 4, samplerate);
+    write_u32(fmt + 8, samplerate * (uint32_t)(w->channels * bytes));
+    write_u16(fmt + 12, (uint16_t)(w->channels * bytes));
+    write_u16(fmt + 14, (uint16_t)(bytes * 8));
+    if (extensible) {
+        static const uint8_t GUID_TAIL[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
+                                               0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+        write_u16(fmt + 16, 22);
+        write_u16(fmt + 18, (uint16_t)(bytes * 8));
+        write_u32(fmt + 20, (w->channels == 6) ? 0x3Fu : (w->channels == 8) ? 0x63Fu : 0u);
+        write_u16(fmt + 24, tag);
+        memcpy(fmt + 26, GUID_TAIL, sizeof(GUID_TAIL));
+    }
+    uint8_t* data = fmt + fmt_size;
+    memcpy(data, "data", 4);
+    const size_t header_size = (size_t)(data + 8 - h);
+    return fwrite(h, 1, header_size, w->f) == header_size;
+}
+
+static bool wav_open_write(WavWriter* w, const char* path, int channels, uint32_t samplerate, SampleFormat format) {
+    memset(w, 0, sizeof(WavWriter));
+    w->channels = channels;
+    w->format = format;
+    w->f = fopen(path, "wb");
+    return w->f && wav_write_header(w, samplerate);
+}
+
+static bool wav_write(WavWriter* w, const float* const* planar, uint32_t offset, uint32_t n, uint8_t* scratch) {
+    const int bytes = sample_bytes(w->format);
+    uint8_t* p = scratch;
+    for (uint32_t i = offset; i < offset + n; ++i) {
+        for (int c = 0; c < w->channels; ++c, p += bytes) {
+            const float v = planar[c][i];
+            switch (w->format) {
+                case SAMPLE_PCM16: {
+                    const double s = floor((double)v * 32768.0 + 0.5);
+                    write_u16(p, (uint16_t)(int16_t)(s < -32768.0 ? -32768.0 : (s > 32767.0 ? 32767.0 : s)));
+                    break;
+                }
+                case SAMPLE_PCM24: {
+                    const double s = floor((double)v * 8388608.0 + 0.5);
+                    const int32_t q = (int32_t)(s < -8388608.0 ? -8388608.0 : (s > 8388607.0 ? 8388607.0 : s));
+                    p[0] = (uint8_t)q; p[1] = (uint8_t)(q >> 8); p[2] = (uint8_t)(q >> 16);
+                    break;
+                }
+                case SAMPLE_PCM32: {
+                    const double s = floor((double)v * 2147483648.0 + 0.5);
+                    write_u32(p, (uint32_t)(int32_t)(s < -2147483648.0 ? -2147483648.0 : (s > 2147483647.0 ? 2147483647.0 : s)));
+                    break;
+                }
+                case SAMPLE_FLOAT32: memcpy(p, &v, 4); break;
+                default: { const double d = (double)v; memcpy(p, &d, 8); break; }
+            }
+        }
+    }
+    const size_t size = (size_t)n * w->channels * bytes;
+    w->data_bytes += size;
+    return fwrite(scratch, 1, size, w->f) == size;
+}
+
+// Completa le dimensioni di RIFF e data (limite di 4 GB del formato RIFF)
+static bool wav_close_write(WavWriter* w) {
+    bool ok = (w->data_bytes <= 0xFFFFFFFFu - 80);
+    const long end = ftell(w->f);
+    const uint32_t data_offset = (uint32_t)(end - (long)w->data_bytes);
+    uint8_t size[4];
+    write_u32(size, (uint32_t)(end - 8));
+    ok = ok && fseek(w->f, 4, SEEK_SET) == 0 && fwrite(size, 1, 4, w->f) == 4;
+    write_u32(size, (uint32_t)w->data_bytes);
+    ok = ok && fseek(w->f, (long)data_offset - 4, SEEK_SET) == 0 && fwrite(size, 1, 4, w->f) == 4;
+    ok = (fclose(w->f) == 0) && ok;
+    w->f = NULL;
+    return ok;
+}
+
+// --- Motore: un'istanza del plugin per worker ---
+typedef struct {
+    int channels;
+    uint32_t descriptor_index;
+} RenderVariant;
+
+static const RenderVariant RENDER_VARIANTS[] = { { 2, 0 }, { 1, 1 }, { 6, 2 }, { 8, 3 } };
+#define RENDER_NUM_VARIANTS ((int)(sizeof(RENDER_VARIANTS) / sizeof(RENDER_VARIANTS[0])))
+
+typedef struct {
+    HostFeatures host; // Contiene puntatori a se stessa: il worker è allocato e non viene copiato
+    const LV2_Descriptor* desc;
+    LV2_Handle handle;
+    int channels;
+    uint32_t samplerate;
+    uint32_t block;
+    float controls[RENDER_NUM_CONTROLS];
+    float* in[GUA76_MAX_CHANNELS];
+    float* out[GUA76_MAX_CHANNELS];
+    uint8_t* scratch; // Frame interlacciati del file
+} RenderEngine;
+
+static void engine_close(RenderEngine* e) {
+    if (e->handle) {
+        if (e->desc->deactivate) e->desc->deactivate(e->handle);
+        e->desc->cleanup(e->handle);
+        e->handle = NULL;
+    }
+}
+
+// Prepara il motore per un file: riusa l'istanza se frequenza e canali non cambiano
+static bool engine_prepare(RenderEngine* e, int channels, uint32_t samplerate, const float* controls) {
+    memcpy(e->controls, controls, sizeof(e->controls));
+    // Controlli non impostati (NaN): il default della variante per i canali del file
+    for (int i = 0; i < gua76_num_parameters(); ++i) {
+        const Gua76ParameterInfo* c = gua76_parameter_info(i);
+        if (isnan(e->controls[c->port])) e->controls[c->port] = gua76_parameter_default(c, channels);
+    }
+    if (e->handle && e->channels == channels && e->samplerate == samplerate) {
+        e->desc->deactivate(e->handle);
+        e->desc->activate(e->handle);
+        return true;
+    }
+    engine_close(e);
+    const RenderVariant* variant = NULL;
+    for (int v = 0; v < RENDER_NUM_VARIANTS; ++v) {
+        if (RENDER_VARIANTS[v].channels == channels) variant = &RENDER_VARIANTS[v];
+    }
+    if (!variant) return false;
+    e->desc = lv2_descriptor(variant->descriptor_index);
+    if (!e->desc) return false;
+    host_features_init(&e->host, e->block);
+    e->handle = e->desc->instantiate(e->desc, (double)samplerate, "", e->host.features);
+    if (!e->handle) return false;
+    e->channels = channels;
+    e->samplerate = samplerate;
+    host_connect_ports(e->desc, e->handle, channels, e->in, e->out, NULL, e->controls, NULL); // Sidechain: il segnale stesso
+    e->desc->activate(e->handle);
+    return true;
+}
+
+// --- Coda di lavoro ---
+typedef struct {
+    const char* in_path;
+    char out_path[1024];
+    // Risultato
+    bool ok;
+    char error[256];
+    int channels;
+    uint32_t samplerate;
+    double audio_seconds;
+    double wall_seconds;
+} RenderJob;
+
+typedef struct {
+    RenderJob* jobs;
+    int num_jobs;
+    int next_job;          // Protetto da mutex
+    pthread_mutex_t mutex; // Anche per l'output su stdout
+    const float* controls;
+    SampleFormat format;
+    uint32_t block;
+    bool quiet;
+} RenderQueue;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Elabora un file con il motore del worker
+static bool render_file(RenderEngine* e, RenderJob* job, SampleFormat out_format, const float* controls) {
+    WavReader r;
+    if (!wav_open_read(&r, job->in_path, job->error, sizeof(job->error))) {
+        if (r.f) fclose(r.f);
+        return false;
+    }
+    job->channels = r.channels;
+    job->samplerate = r.samplerate;
+    job->audio_seconds = (double)r.frames / r.samplerate;
+    if (!engine_prepare(e, r.channels, r.samplerate, controls)) {
+        snprintf(job->error, sizeof(job->error), "%d canali non supportati (1, 2, 6, 8) o istanziazione fallita", r.channels);
+        fclose(r.f);
+        return false;
+    }
+    WavWriter w;
+    const SampleFormat format = (out_format == SAMPLE_SAME) ? r.format : out_format;
+    if (!wav_open_write(&w, job->out_path, r.channels, r.samplerate, format)) {
+        snprintf(job->error, sizeof(job->error), "uscita non scrivibile");
+        if (w.f) fclose(w.f);
+        fclose(r.f);
+        return false;
+    }
+
+    // La latenza (lookahead + ADAA) è nota dopo il primo run(): i primi 'latency' frame in uscita si
+    // scartano e alla fine si elaborano altrettanti frame di silenzio
+    bool ok = true;
+    bool latency_known = false;
+    uint64_t to_skip = 0, tail = 0, written = 0;
+    while (ok && written < r.frames) {
+        uint32_t n = wav_read(&r, e->in, e->block, e->scratch);
+        if (n == 0) {
+            if (r.frames_left > 0) {
+                snprintf(job->error, sizeof(job->error), "file troncato");
+                ok = false;
+                break;
+            }
+            // Coda: silenzio per far uscire gli ultimi campioni ritardati
+            n = (tail < e->block) ? (uint32_t)tail : e->block;
+            if (n == 0) break;
+            for (int c = 0; c < r.channels; ++c) memset(e->in[c], 0, n * sizeof(float));
+            tail -= n;
+        }
+        e->desc->run(e->handle, n);
+        if (!latency_known) {
+            to_skip = (uint64_t)(e->controls[GUA76_LATENCY] + 0.5f);
+            tail = to_skip;
+            latency_known = true;
+        }
+        uint32_t offset = 0;
+        if (to_skip > 0) {
+            offset = (to_skip < n) ? (uint32_t)to_skip : n;
+            to_skip -= offset;
+        }
+        uint32_t count = n - offset;
+        if (written + count > r.frames) count = (uint32_t)(r.frames - written);
+        if (count > 0) ok = wav_write(&w, e->out, offset, count, e->scratch);
+        written += count;
+    }
+    if (!ok && job->error[0] == '\0') snprintf(job->error, sizeof(job->error), "errore di scrittura");
+    if (!wav_close_write(&w) && ok) {
+        snprintf(job->error, sizeof(job->error), "errore di scrittura (o uscita oltre 4 GB)");
+        ok = false;
+    }
+    fclose(r.f);
+    return ok;
+}
+
+static void* worker_main(void* arg) {
+    RenderQueue* q = (RenderQueue*)arg;
+    RenderEngine* e = (RenderEngine*)calloc(1, sizeof(RenderEngine));
+    bool allocated = (e != NULL);
+    if (e) {
+        e->block = q->block;
+        for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) {
+            e->in[c] = (float*)calloc(q->block, sizeof(float));
+            e->out[c] = (float*)calloc(q->block, sizeof(float));
+            allocated = allocated && e->in[c] && e->out[c];
+        }
+        e->scratch = (uint8_t*)malloc((size_t)q->block * GUA76_MAX_CHANNELS * 8);
+        allocated = allocated && e->scratch;
+    }
+    for (;;) {
+        pthread_mutex_lock(&q->mutex);
+        const int index = q->next_job++;
+        pthread_mutex_unlock(&q->mutex);
+        if (index >= q->num_jobs) break;
+        RenderJob* job = &q->jobs[index];
+        const double start = now_seconds();
+        if (allocated) job->ok = render_file(e, job, q->format, q->controls);
+        else snprintf(job->error, sizeof(job->error), "memoria insufficiente");
+        job->wall_seconds = now_seconds() - start;
+        if (!q->quiet || !job->ok) {
+            pthread_mutex_lock(&q->mutex);
+            if (job->ok) {
+                printf("ok   %s -> %s  ch=%d sr=%u  %.2f s in %.3f s  %.1fx tempo reale\n", job->in_path, job->out_path,
+                       job->channels, job->samplerate, job->audio_seconds, job->wall_seconds,
+                       job->audio_seconds / (job->wall_seconds > 1e-9 ? job->wall_seconds : 1e-9));
+            } else {
+                printf("FAIL %s -> %s: %s\n", job->in_path, job->out_path, job->error);
+            }
+            fflush(stdout);
+            pthread_mutex_unlock(&q->mutex);
+        }
+    }
+    if (e) {
+        engine_close(e);
+        for (int c = 0; c < GUA76_MAX_CHANNELS; ++c) {
+            free(e->in[c]);
+            free(e->out[c]);
+        }
+        free(e->scratch);
+        free(e);
+    }
+    return NULL;
+}
+
+// Nome di uscita: -o, altrimenti --out-dir/nome o nome+suffisso accanto all'ingresso
+static bool make_out_path(char* out, size_t size, const char* in, const char* out_file, const char* out_dir, const char* suffix) {
+    if (out_file) return snprintf(out, size, "%s", out_file) < (int)size;
+    const char* base = strrchr(in, '/');
+    base = base ? base + 1 : in;
+    if (out_dir) return snprintf(out, size, "%s/%s", out_dir, base) < (int)size;
+    const char* dot = strrchr(base, '.');
+    const int stem = dot ? (int)(dot - in) : (int)strlen(in);
+    return snprintf(out, size, "%.*s%s.wav", stem, in, suffix) < (int)size;
+}
+
+// Percorso assoluto di un file di uscita che può non esistere ancora: cartella risolta (realpath)
+// più il nome. Se la cartella non esiste resta il percorso indicato.
+static void resolve_out_path(char* resolved, size_t size, const char* path) {
+    char dir[1024];
+    const char* slash = strrchr(path, '/');
+    const char* name = slash ? slash + 1 : path;
+    if (!slash) snprintf(dir, sizeof(dir), ".");
+    else if (slash == path) snprintf(dir, sizeof(dir), "/");
+    else snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+    char real_dir[PATH_MAX];
+    if (realpath(dir, real_dir)) snprintf(resolved, size, "%s/%s", real_dir, name);
+    else snprintf(resolved, size, "%s", path);
+}
+
+static int compare_strings(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+// Un'uscita non deve sovrascrivere un ingresso (ancora da leggere) né un'altra uscita (scritta da un
+// altro worker nello stesso momento): false, con il messaggio, se succede.
+static bool check_out_paths(const RenderJob* job_list, int num_jobs) {
+    bool ok = true;
+    for (int i = 0; i < num_jobs && ok; ++i) {
+        struct stat out_stat;
+        if (stat(job_list[i].out_path, &out_stat) != 0) continue; // Non esiste: non è un ingresso
+        for (int j = 0; j < num_jobs; ++j) {
+            struct stat in_stat;
+            if (stat(job_list[j].in_path, &in_stat) != 0) continue; // Errore riportato dal worker
+            if (in_stat.st_dev == out_stat.st_dev && in_stat.st_ino == out_stat.st_ino) {
+                fprintf(stderr, "L'uscita %s sovrascriverebbe l'ingresso %s\n", job_list[i].out_path, job_list[j].in_path);
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (!ok) return false;
+
+    char (*resolved)[PATH_MAX + 256] = (char (*)[PATH_MAX + 256])malloc((size_t)num_jobs * sizeof(*resolved));
+    const char** sorted = (const char**)malloc((size_t)num_jobs * sizeof(const char*));
+    if (!resolved || !sorted) {
+        free(resolved);
+        free(sorted);
+        fprintf(stderr, "Memoria insufficiente\n");
+        return false;
+    }
+    for (int i = 0; i < num_jobs; ++i) {
+        resolve_out_path(resolved[i], sizeof(resolved[i]), job_list[i].out_path);
+        sorted[i] = resolved[i];
+    }
+    qsort(sorted, (size_t)num_jobs, sizeof(const char*), compare_strings);
+    for (int i = 1; i < num_jobs; ++i) {
+        if (!strcmp(sorted[i - 1], sorted[i])) {
+            fprintf(stderr, "Più file in ingresso hanno la stessa uscita %s\n", sorted[i]);
+            ok = false;
+            break;
+        }
+    }
+    free(resolved);
+    free(sorted);
+    return ok;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [-o FILE | --out-dir DIR] [--suffix S] [--format F] [--preset FILE] [--set SIMBOLO=V]...\n"
+                    "       [--jobs N] [--block N] [--list] [--quiet] FILE.wav...\n", prog);
+}
+
+int main(int argc, char** argv) {
+    float controls[RENDER_NUM_CONTROLS];
+    memset(controls, 0, sizeof(controls));
+    for (int i = 0; i < gua76_num_parameters(); ++i) {
+        controls[gua76_parameter_info(i)->port] = NAN; // Default della variante, per file (engine_prepare)
+    }
+
+    const char* out_file = NULL;
+    const char* out_dir = NULL;
+    const char* suffix = RENDER_DEFAULT_SUFFIX;
+    const char* preset = NULL;
+    const char* settings[128];
+    int num_settings = 0;
+    SampleFormat format = SAMPLE_SAME;
+    long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int jobs = (num_cores > 0) ? (int)num_cores : 1;
+    int block = RENDER_DEFAULT_BLOCK;
+    bool quiet = false;
+    const char* inputs[4096];
+    int num_inputs = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) out_file = argv[++i];
+        else if (!strcmp(argv[i], "--out-dir") && i + 1 < argc) out_dir = argv[++i];
+        else if (!strcmp(argv[i], "--suffix") && i + 1 < argc) suffix = argv[++i];
+        else if (!strcmp(argv[i], "--preset") && i + 1 < argc) preset = argv[++i];
+        else if (!strcmp(argv[i], "--set") && i + 1 < argc && num_settings < 128) settings[num_settings++] = argv[++i];
+        else if (!strcmp(argv[i], "--jobs") && i + 1 < argc) jobs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--block") && i + 1 < argc) block = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--quiet")) quiet = true;
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+            const char* name = argv[++i];
+            int f = 0;
+            while (f < NUM_SAMPLE_FORMATS && strcmp(SAMPLE_FORMAT_NAMES[f], name)) ++f;
+            if (f == NUM_SAMPLE_FORMATS) { usage(argv[0]); return 2; }
+            format = (SampleFormat)f;
+        } else if (!strcmp(argv[i], "--list")) {
+            for (int p = 0; p < gua76_num_parameters(); ++p) {
+                const Gua76ParameterInfo* c = gua76_parameter_info(p);
+                printf("%-20s default %-8g [%g, %g]", c->symbol, c->def, c->min, c->max);
+                const float multichannel = gua76_parameter_default(c, GUA76_MAX_CHANNELS);
+                if (multichannel != c->def) printf("  (5.1/7.1: %g)", multichannel);
+                printf("\n");
+            }
+            return 0;
+        } else if (argv[i][0] == '-' || num_inputs >= 4096) { usage(argv[0]); return 2; }
+        else inputs[num_inputs++] = argv[i];
+    }
+    if (num_inputs == 0 || (out_file && num_inputs > 1) || (out_file && out_dir)) { usage(argv[0]); return 2; }
+    if (block <= 0 || block > RENDER_MAX_BLOCK) block = RENDER_DEFAULT_BLOCK;
+    if (jobs <= 0) jobs = 1;
+    if (jobs > RENDER_MAX_JOBS) jobs = RENDER_MAX_JOBS;
+    if (jobs > num_inputs) jobs = num_inputs;
+
+    if (preset && !load_preset(controls, preset)) return 2;
+    for (int i = 0; i < num_settings; ++i) {
+        if (!apply_setting(controls, settings[i], "--set")) return 2;
+    }
+
+    RenderJob* job_list = (RenderJob*)calloc((size_t)num_inputs, sizeof(RenderJob));
+    if (!job_list) {
+        fprintf(stderr, "Memoria insufficiente\n");
+        return 2;
+    }
+    for (int i = 0; i < num_inputs; ++i) {
+        job_list[i].in_path = inputs[i];
+        if (!make_out_path(job_list[i].out_path, sizeof(job_list[i].out_path), inputs[i], out_file, out_dir, suffix)) {
+            fprintf(stderr, "Percorso di uscita troppo lungo: %s\n", inputs[i]);
+            return 2;
+        }
+    }
+    if (!check_out_paths(job_list, num_inputs)) {
+        free(job_list);
+        return 2;
+    }
+
+    RenderQueue q;
+    q.jobs = job_list;
+    q.num_jobs = num_inputs;
+    q.next_job = 0;
+    pthread_mutex_init(&q.mutex, NULL);
+    q.controls = controls;
+    q.format = format;
+    q.block = (uint32_t)block;
+    q.quiet = quiet;
+
+    const double start = now_seconds();
+    pthread_t threads[RENDER_MAX_JOBS];
+    int started = 0;
+    for (int t = 0; t < jobs; ++t) {
+        if (pthread_create(&threads[started], NULL, worker_main, &q) == 0) ++started;
+    }
+    if (started == 0) worker_main(&q); // Nessun thread disponibile: elabora qui
+    for (int t = 0; t < started; ++t) pthread_join(threads[t], NULL);
+    const double wall = now_seconds() - start;
+    pthread_mutex_destroy(&q.mutex);
+
+    int failures = 0;
+    double audio_seconds = 0.0, cpu_seconds = 0.0;
+    for (int i = 0; i < num_inputs; ++i) {
+        if (!job_list[i].ok) { ++failures; continue; }
+        audio_seconds += job_list[i].audio_seconds;
+        cpu_seconds += job_list[i].wall_seconds;
+    }
+    printf("%d file (%d falliti), %.1f s di audio in %.2f s con %d worker: %.1fx tempo reale complessivo, %.1fx per worker\n",
+           num_inputs, failures, audio_seconds, wall, started > 0 ? started : 1,
+           audio_seconds / (wall > 1e-9 ? wall : 1e-9), audio_seconds / (cpu_seconds > 1e-9 ? cpu_seconds : 1e-9));
+    free(job_list);
+    return failures > 0 ? 1 : 0;
+}